@@ -2,6 +2,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include "text_layout.h"
 
 // Colores
 #define COLOR_WHITE     0xFFFF
@@ -38,6 +39,7 @@ typedef enum {
 static AppState current_state = STATE_MENU;
 static int selected_menu = 0;
 static char response_buffer[1024];
+static StrView response;     // Texto del resultado (response_buffer sin el prefijo o un literal)
 static bool uart_available = false;
 
 // Textos del menú
@@ -87,12 +89,12 @@ static bool uart_receive_string(char* buffer, int max_length, int timeout_ms) {
     // Simulación de recepción UART
     // En implementación real: recibir respuesta del Pi
     if (!uart_available) {
-        strcpy(buffer, "UART not available");
+        snprintf(buffer, max_length, "UART not available");
         return false;
     }
     
     // Respuesta simulada para demostración
-    strcpy(buffer, "SOLUTION: Premium calculation: $45.67/month based on mortality tables and 3% interest rate. Present value: $8,234.56");
+    snprintf(buffer, max_length, "%s", "SOLUTION: Premium calculation: $45.67/month based on mortality tables and 3% interest rate. Present value: $8,234.56");
     return true;
 }
 
@@ -140,25 +142,13 @@ static void draw_input_screen(const char* title) {
     const char* template = get_problem_template((MenuOption)selected_menu);
     
     // Dividir texto en líneas
-    char temp[256];
-    strncpy(temp, template, sizeof(temp) - 1);
-    temp[sizeof(temp) - 1] = '\0';
-    
-    char* line = temp;
+    StrView rest = sv_from_cstr(template);
     int y = 110;
-    int line_length = 35; // Caracteres por línea
+    const size_t line_length = 35; // Caracteres por línea
     
-    while (strlen(line) > 0 && y < 180) {
-        char display_line[40];
-        if (strlen(line) <= line_length) {
-            strcpy(display_line, line);
-            line += strlen(line);
-        } else {
-            strncpy(display_line, line, line_length);
-            display_line[line_length] = '\0';
-            line += line_length;
-        }
-        
+    while (!sv_empty(rest) && y < 180) {
+        char display_line[TEXT_LINE_MAX + 1];
+        text_copy_line(text_wrap_next(&rest, line_length), display_line, sizeof(display_line));
         extapp_drawTextSmall(display_line, 10, y, COLOR_BLACK, COLOR_WHITE, false);
         y += 15;
     }
@@ -176,40 +166,20 @@ static void draw_processing_screen() {
     extapp_drawTextSmall("Please wait...", 90, 150, COLOR_GRAY, COLOR_WHITE, false);
 }
 
-static void draw_result_screen(const char* result) {
+static void draw_result_screen(StrView result) {
     clear_screen();
     draw_title();
     
     extapp_drawTextSmall("AI Response:", 10, 60, COLOR_BLACK, COLOR_WHITE, false);
     
-    // Mostrar resultado dividido en líneas
-    char temp[1024];
-    strncpy(temp, result, sizeof(temp) - 1);
-    temp[sizeof(temp) - 1] = '\0';
-    
-    char* line = temp;
+    // Mostrar resultado dividido en líneas, sin copiar la respuesta
+    StrView rest = result;
     int y = 85;
-    int line_length = 35; // Caracteres por línea
+    const size_t line_length = 35; // Caracteres por línea
     
-    while (strlen(line) > 0 && y < 180) {
-        char display_line[40];
-        if (strlen(line) <= line_length) {
-            strcpy(display_line, line);
-            line += strlen(line);
-        } else {
-            // Buscar espacio para cortar palabra completa
-            int cut_pos = line_length;
-            while (cut_pos > 0 && line[cut_pos] != ' ') {
-                cut_pos--;
-            }
-            if (cut_pos == 0) cut_pos = line_length;
-            
-            strncpy(display_line, line, cut_pos);
-            display_line[cut_pos] = '\0';
-            line += cut_pos;
-            if (*line == ' ') line++; // Saltar espacio
-        }
-        
+    while (!sv_empty(rest) && y < 180) {
+        char display_line[TEXT_LINE_MAX + 1];
+        text_copy_line(text_wrap_next(&rest, line_length), display_line, sizeof(display_line));
         extapp_drawTextSmall(display_line, 10, y, COLOR_BLACK, COLOR_WHITE, false);
         y += 15;
     }
@@ -232,22 +202,19 @@ static bool send_problem_to_ai(const char* problem) {
     
     // Enviar a Raspberry Pi
     if (!uart_send_string(message)) {
-        strcpy(response_buffer, "Error: Failed to send problem");
+        response = sv_from_cstr("Error: Failed to send problem");
         return false;
     }
     
     // Esperar respuesta
     if (!uart_receive_string(response_buffer, sizeof(response_buffer), 30000)) {
-        strcpy(response_buffer, "Error: No response from AI (timeout)");
+        response = sv_from_cstr("Error: No response from AI (timeout)");
         return false;
     }
     
-    // Verificar formato de respuesta
-    if (strncmp(response_buffer, "SOLUTION:", 9) == 0) {
-        // Remover prefijo "SOLUTION:"
-        memmove(response_buffer, response_buffer + 9, strlen(response_buffer) - 8);
-        return true;
-    }
+    // Quitar el prefijo "SOLUTION:" sin mover los datos
+    response = sv_from_cstr(response_buffer);
+    text_strip_solution(&response);
     
     return true; // Para demostración, siempre exitoso
 }
@@ -328,9 +295,9 @@ static void handle_test_screen() {
         bool connection_ok = test_connection();
         
         if (connection_ok) {
-            strcpy(response_buffer, "Connection test successful!\nRaspberry Pi responding correctly.");
+            response = sv_from_cstr("Connection test successful!\nRaspberry Pi responding correctly.");
         } else {
-            strcpy(response_buffer, "Connection test failed!\nCheck UART wiring and Pi status.");
+            response = sv_from_cstr("Connection test failed!\nCheck UART wiring and Pi status.");
         }
         
         test_started = false;
@@ -365,7 +332,7 @@ void extapp_main() {
                 break;
                 
             case STATE_RESULT:
-                draw_result_screen(response_buffer);
+                draw_result_screen(response);
                 extapp_msleep(100);
                 handle_result_screen();
                 break;
@@ -1,6 +1,39 @@
 #include <extapp_api.h>
 #include <string.h>
 #include <stdio.h>
+#include "uart_hardware.h"
+#include "uart_transport.h"
+#include "link_monitor.h"
+#include "startup.h"
+#include "text_cache.h"
+#include "compositor.h"
+#include "arena.h"
+#include "strview.h"
+#include "mem_monitor.h"
+#include "calc_params.h"
+#include "response_cache.h"
+#include "profiler.h"
+#include "trace.h"
+#include "request_queue.h"
+#include "speculate.h"
+#include "power.h"
+#include "text_layout.h"
+#include "premium_table.h"
+#include "solution_fields.h"
+#include "uart_session.h"
+
+// Transporte fiable con ACK/NACK (uart_transport.c). El bridge del Pi debe
+// hablar el mismo protocolo de tramas; por defecto se usa el de líneas.
+#ifndef ACTUARIAL_RELIABLE_LINK
+#define ACTUARIAL_RELIABLE_LINK 0
+#endif
+
+// Grabar la sesión del UART desde que se configura, sin pasar por el
+// diagnóstico (Shift en la página del enlace). El benchmark del host la usa
+// para reproducirla después (host/session_replay.c).
+#ifndef ACTUARIAL_RECORD_SESSION
+#define ACTUARIAL_RECORD_SESSION 0
+#endif
 
 // Colores
 #define WHITE 0xFFFF
@@ -10,6 +43,7 @@
 #define RED   0xF800
 #define CYAN  0x07FF
 #define YELLOW 0xFFE0
+#define ORANGE 0xFC00
 
 // Estados de la aplicación
 typedef enum {
@@ -18,24 +52,36 @@ typedef enum {
     STATE_PROCESSING,
     STATE_RESULT,
     STATE_ERROR,
-    STATE_TEST
+    STATE_TEST,
+    STATE_DIAG,
+    STATE_EDIT,
+    STATE_HISTORY,
+    STATE_SCHEDULE
 } AppState;
 
 // Variables globales
 static AppState current_state = STATE_INIT;
 static int menu_selection = 0;
-static char response_buffer[1024];
+// Resultado o mensaje de error en pantalla: apunta a la arena, a la caché
+// de respuestas, a la cola o a un literal
+static StrView response;
+static const char* response_note;   // "(cached)", "(queued)"... junto al título
+// Campos numéricos de `response` (vacío para mensajes de la app) y si el
+// resultado se muestra como texto en lugar de como campos
+static SolutionFields solution;
+static bool result_as_text = false;
 static bool uart_ready = false;
 
-// Problemas actuariales predefinidos
-static const char* problems[] = {
-    "Calculate life insurance premium for age 35, $100,000 coverage, 20-year term",
-    "Calculate present value of annuity: $1000/month for 20 years at 5% interest", 
-    "Find mortality rate for age 45 using standard mortality table",
-    "Calculate compound interest: $10,000 at 6% for 15 years",
-    "Calculate reserves for whole life insurance policy age 30",
-    "TEST_CONNECTION"
-};
+// Parámetros de cada cálculo (las entradas 0..CALC_PRODUCT_COUNT-1 del
+// menú); se conservan entre peticiones
+static CalcParams calc_params[CALC_PRODUCT_COUNT];
+static int edit_field = 0;      // CalcField seleccionado en el editor
+
+#define MENU_ITEM_COUNT 9
+#define MENU_TEST       5
+#define MENU_DIAG       6
+#define MENU_HISTORY    7
+#define MENU_SCHEDULE   8
 
 static const char* problem_names[] = {
     "Life Insurance Premium",
@@ -43,123 +89,397 @@ static const char* problem_names[] = {
     "Mortality Rate Lookup",
     "Interest Calculation",
     "Insurance Reserves",
-    "Test Connection"
+    "Test Connection",
+    "Link Diagnostics",
+    "Queued Requests",
+    "Premium Schedule"
 };
 
-// Declaraciones de funciones UART (implementadas en uart_hardware.c)
-extern bool uart_hardware_init(void);
-extern bool uart_hardware_send_string(const char* str);
-extern bool uart_hardware_receive_string(char* buffer, int max_len, uint32_t timeout_ms);
-extern bool uart_hardware_test_loopback(void);
+// Nombres de AppState para la página de memoria
+static const char* state_names[] = {
+    "Init", "Menu", "Processing", "Result", "Error", "Test", "Diag", "Edit", "History", "Schedule"
+};
+
+#define DIAG_PAGES  3
+static int diag_page = 0;   // 0: enlace, 1: memoria, 2: especulación y cola
+
+#define HISTORY_ROWS  QUEUE_SLOTS
+static int history_selection = 0;
+
+// Tabla de primas (edad x plazo) al interés del seguro temporal; se
+// recalcula al entrar si el interés cambió. Ventana visible de
+// SCHEDULE_ROWS edades por SCHEDULE_COLS plazos.
+#define SCHEDULE_ROWS  9
+#define SCHEDULE_COLS  5
+static float schedule_table[PREMIUM_TABLE_CELLS];
+static uint16_t schedule_rate_bp;   // 0: sin calcular
+static int schedule_row = 0;        // Primera edad visible (índice)
+static int schedule_col = 0;        // Primer plazo visible (índice)
+
+#if ACTUARIAL_RELIABLE_LINK
+static Transport transport;
+
+static bool link_send_byte(uint8_t byte, void* ctx) {
+    return uart_hardware_send_byte(byte);
+}
+
+static bool link_poll_byte(uint8_t* byte, void* ctx) {
+    return uart_hardware_poll_byte(byte);
+}
+
+static uint32_t link_millis(void* ctx) {
+    return (uint32_t)extapp_millis();
+}
+
+static void link_idle(void* ctx) {
+    power_wait();
+}
+
+static const TransportLink uart_link = { link_send_byte, link_poll_byte, link_millis, NULL, link_idle };
+#endif
+
+#define MESSAGE_CAPACITY   63
+#define RESPONSE_CAPACITY  1023
+
+// Marca de la etapa en curso de la petición: la espera termina cuando
+// uart_hardware_receive_string ve el primer byte
+static ProfMark request_mark;
+
+static void request_line_started(void) {
+    request_mark = profiler_lap(PROF_WAIT, request_mark);
+}
+
+static void set_response(const char* text) {
+    response = sv_from_cstr(text);
+    solution.count = 0;
+}
+
+// La respuesta anterior deja de mostrarse: se vacía la arena y se reserva
+// el sitio de la nueva
+static CharSlice begin_response(size_t capacity) {
+    arena_reset();
+    return arena_chars(capacity);
+}
+
+// Acierto de la caché copiado a la arena: la ranura puede reemplazarse
+// (una tanda de la cola, una especulación) mientras se muestra
+static bool show_cached(const uint8_t record[CALC_RECORD_SIZE]) {
+    StrView hit;
+    if (!response_cache_find(record, &hit, &solution)) return false;
+    CharSlice copy = begin_response(hit.len);
+    if (!copy.data) {
+        set_response("Error: Out of memory");
+        return true;
+    }
+    memcpy(copy.data, hit.ptr, hit.len);
+    copy.data[hit.len] = '\0';
+    response = sv_make(copy.data, hit.len);     // Los campos son desplazamientos: siguen valiendo
+    return true;
+}
+
+// Sin enlace la petición no se pierde: queda en la cola persistente y sale
+// en la próxima tanda. false si la cola ya está llena de pendientes.
+static bool queue_request(const uint8_t record[CALC_RECORD_SIZE], const char* reason) {
+    bool queued = request_queue_add(record);
+    CharSlice text = begin_response(127);
+    if (!text.data) {
+        set_response(queued ? "Request queued" : "Error: Request queue full");
+        return queued;
+    }
+    if (queued) {
+        snprintf(text.data, text.cap + 1, "%s Request queued (%lu pending); it is sent when the link returns.",
+                 reason, (unsigned long)request_queue_pending());
+    } else {
+        snprintf(text.data, text.cap + 1, "%s Request queue full: request not sent.", reason);
+    }
+    set_response(text.data);
+    return queued;
+}
+
+#if !ACTUARIAL_RELIABLE_LINK
+// Líneas que llegan antes de la respuesta y no son suyas: el PONG de un
+// latido que seguía en vuelo o la respuesta de una especulativa cancelada
+static bool foreign_line(const char* line) {
+    uint64_t now = extapp_millis();
+    if (strcmp(line, "PONG") == 0) {
+        link_monitor_note_pong(now);
+        return true;
+    }
+    return speculate_claim_line(line, now);
+}
+#endif
 
 // Funciones UART de alto nivel
 static bool uart_init() {
     uart_ready = uart_hardware_init();
+    uart_hardware_set_wait(extapp_millis, power_wait);     // Esperas al Pi con el núcleo dormido
+    link_monitor_init(extapp_millis());
+#if ACTUARIAL_RELIABLE_LINK
+    // Con tramas en la línea, el latido y la cola también van en tramas
+    if (uart_ready) {
+        transport_init(&transport, &uart_link);
+        link_monitor_use_transport(&transport);
+        request_queue_use_transport(&transport);
+    }
+#endif
+#if ACTUARIAL_RECORD_SESSION
+    if (uart_ready) uart_session_start();
+#endif
     return uart_ready;
 }
 
-static bool send_problem_to_pi(const char* problem) {
-    if (!uart_ready || !problem) return false;
+static bool send_request_to_pi(const CalcParams* params) {
+    uint8_t record[CALC_RECORD_SIZE];
+    request_mark = profiler_begin();
+    calc_params_encode(params, record);
     
-    // Formatear mensaje para el protocolo
-    char message[512];
-    snprintf(message, sizeof(message), "PROBLEM:%s\n", problem);
+    // Si la especulativa en vuelo es de este registro se espera y su
+    // respuesta queda en la caché; si es de otro, se envía detrás
+    bool prefetched = speculate_promote(record, 30000);
     
-    // Enviar al Raspberry Pi
-    if (!uart_hardware_send_string(message)) {
-        strcpy(response_buffer, "Error: Failed to send to Pi");
-        return false;
+    // Mismos parámetros que una petición anterior: no hace falta el Pi
+    bool cached = show_cached(record);
+    response_note = prefetched ? "(prefetched)" : cached ? "(cached)" : NULL;
+    trace_event(TRACE_REQUEST, params->product, cached, 0);
+    if (cached) {
+        profiler_end(PROF_ENCODE, request_mark);
+        return true;
     }
     
-    // Recibir respuesta con timeout de 30 segundos
-    if (!uart_hardware_receive_string(response_buffer, sizeof(response_buffer), 30000)) {
-        strcpy(response_buffer, "Error: No response from Pi (timeout)");
+    if (!uart_ready) {
+        set_response("Error: UART hardware not initialized");
         return false;
     }
     
-    // Procesar respuesta
-    if (strncmp(response_buffer, "SOLUTION:", 9) == 0) {
-        // Remover prefijo "SOLUTION:"
-        memmove(response_buffer, response_buffer + 9, strlen(response_buffer) - 8);
+    // Si el latido ya sabe que el Pi no responde, no esperar 30 s: a la
+    // cola. También mientras sale una tanda, que ocupa la línea.
+    if (link_monitor_is_down() || request_queue_flushing()) {
+        if (link_monitor_is_down()) {
+            trace_event(TRACE_TIMEOUT, TRACE_TIMEOUT_LINK, 0, 0);
+            link_monitor_probe(extapp_millis());
+        }
+        profiler_end(PROF_ENCODE, request_mark);
+        response_note = "(queued)";
+        return queue_request(record, "Pi offline.");
     }
     
-    return true;
-}
-
-static bool test_pi_connection() {
-    if (!uart_ready) return false;
+    // La respuesta se recibe directamente en la arena; el mensaje va detrás
+    // y se libera en cuanto sale
+    CharSlice rx = begin_response(RESPONSE_CAPACITY);
+    size_t message_mark = arena_mark();
+    CharSlice message = arena_chars(MESSAGE_CAPACITY);
+    if (!rx.data || !message.data) {
+        set_response("Error: Out of memory");
+        return false;
+    }
+    
+    // Formatear mensaje para el protocolo
+#if ACTUARIAL_RELIABLE_LINK
+    // Las tramas delimitan el mensaje: no hace falta '\n'
+    message.len = calc_params_to_message(params, message.data, message.cap + 1);
+    request_mark = profiler_lap(PROF_ENCODE, request_mark);
+    trace_event(TRACE_UART_TX, (uint8_t)message.data[0], (uint16_t)message.len, 0);
     
-    if (!uart_hardware_send_string("TEST_CONNECTION\n")) {
+    // El transporte envía y espera en una sola llamada: todo cuenta como espera
+    bool received = transport_exchange(&transport, (const uint8_t*)message.data, message.len,
+                                       (uint8_t*)rx.data, rx.cap, &rx.len, 30000);
+    arena_release(message_mark);
+    // El PONG de un latido que seguía en vuelo llega antes que la respuesta
+    while (received && rx.len == 4 && memcmp(rx.data, "PONG", 4) == 0) {
+        link_monitor_note_pong(extapp_millis());
+        received = transport_receive(&transport, (uint8_t*)rx.data, rx.cap, &rx.len, 30000);
+    }
+    request_mark = profiler_lap(PROF_WAIT, request_mark);
+    if (!received) {
+        trace_event(TRACE_TIMEOUT, TRACE_TIMEOUT_RESPONSE, 0, 30000);
+        link_monitor_note_failure(extapp_millis());
+        queue_request(record, "Error: No response from Pi (link).");
         return false;
     }
+    rx.data[rx.len] = '\0';
+    trace_event(TRACE_UART_RX, (uint8_t)rx.data[0], (uint16_t)rx.len, 0);
+#else
+    message.len = calc_params_to_message(params, message.data, message.cap);
+    message.data[message.len++] = '\n';
+    message.data[message.len] = '\0';
+    request_mark = profiler_lap(PROF_ENCODE, request_mark);
+    trace_event(TRACE_UART_TX, (uint8_t)message.data[0], (uint16_t)message.len, 0);
     
-    char test_response[256];
-    if (!uart_hardware_receive_string(test_response, sizeof(test_response), 5000)) {
+    // Enviar al Raspberry Pi
+    bool sent = uart_hardware_send_string(message.data);
+    arena_release(message_mark);
+    request_mark = profiler_lap(PROF_SEND, request_mark);
+    if (!sent) {
+        set_response("Error: Failed to send to Pi");
         return false;
     }
     
-    return (strstr(test_response, "TEST_OK") != NULL);
+    // Recibir respuesta con timeout de 30 segundos. El PONG de un latido
+    // que seguía en vuelo, o la respuesta de una especulativa cancelada,
+    // pueden llegar antes: se descartan.
+    do {
+        uart_hardware_set_line_start_hook(request_line_started);
+        bool line = uart_hardware_receive_string(rx.data, (int)rx.cap + 1, 30000);
+        uart_hardware_set_line_start_hook(NULL);
+        // Sin ningún byte la espera no se cerró: todo el timeout es espera
+        request_mark = profiler_lap(rx.data[0] ? PROF_RECEIVE : PROF_WAIT, request_mark);
+        if (rx.data[0]) trace_event(TRACE_UART_RX, (uint8_t)rx.data[0], (uint16_t)strlen(rx.data), 0);
+        if (!line) {
+            trace_event(TRACE_TIMEOUT, TRACE_TIMEOUT_RESPONSE, 0, 30000);
+            link_monitor_note_failure(extapp_millis());
+            queue_request(record, "Error: No response from Pi (timeout).");
+            return false;
+        }
+    } while (foreign_line(rx.data));
+    rx.len = strlen(rx.data);
+#endif
+    
+    link_monitor_note_alive(extapp_millis());
+    
+    // Quitar el prefijo "SOLUTION:" sin mover los datos
+    response = sv_make(rx.data, rx.len);
+    bool prefixed = text_strip_solution(&response);
+    solution_parse(response, &solution);
+    response_cache_store(record, response, &solution);
+    profiler_end(PROF_PARSE, request_mark);
+    trace_event(TRACE_RESPONSE, prefixed, (uint16_t)response.len, 0);
+    
+    return true;
 }
 
-// Funciones de interfaz
-static void clear_screen() {
-    extapp_pushRectUniform(0, 0, LCD_WIDTH, LCD_HEIGHT, WHITE);
+// Funciones de interfaz. Cada pantalla se describe entera en el compositor,
+// que sólo envía al LCD las bandas que cambiaron.
+static uint16_t link_color(LinkState state) {
+    switch (state) {
+        case LINK_UP:       return GREEN;
+        case LINK_DEGRADED: return ORANGE;
+        case LINK_DOWN:     return RED;
+        default:            return BLACK;
+    }
+}
+
+// Indicador en vivo del enlace (esquina superior derecha)
+static void draw_link_indicator() {
+    char text[24];
+    LinkState state = link_monitor_state();
+    
+    if (!uart_ready) {
+        snprintf(text, sizeof(text), "Pi --   ");
+    } else if (state == LINK_UP) {
+        snprintf(text, sizeof(text), "Pi %lums   ", (unsigned long)link_monitor_rtt_ms());
+    } else if (state == LINK_DOWN) {
+        snprintf(text, sizeof(text), "Pi DOWN ");
+    } else {
+        snprintf(text, sizeof(text), "Pi ...  ");
+    }
+    compositor_text_small(text, 255, 4, link_color(state), WHITE);
 }
 
 static void draw_header() {
-    extapp_drawTextLarge("ActuarialAI", 80, 10, BLUE, WHITE, false);
-    extapp_drawTextSmall("Native UART App", 90, 35, BLACK, WHITE, false);
+    compositor_static_large("ActuarialAI", 80, 10, BLUE, WHITE);
+    compositor_static_small("Native UART App", 90, 35, BLACK, WHITE);
+    draw_link_indicator();
 }
 
 static void draw_status() {
     if (uart_ready) {
-        extapp_drawTextSmall("UART: Ready (115200)", 10, 55, GREEN, WHITE, false);
-        extapp_drawTextSmall("Pins: PA11(TX) PA12(RX)", 10, 70, GREEN, WHITE, false);
+        char line[48];
+        LinkState state = link_monitor_state();
+        
+        if (state == LINK_UP) {
+            snprintf(line, sizeof(line), "Pi link: UP  RTT %lu ms (avg %lu)",
+                     (unsigned long)link_monitor_rtt_ms(), (unsigned long)link_monitor_rtt_avg_ms());
+        } else {
+            snprintf(line, sizeof(line), "Pi link: %s", link_state_name(state));
+        }
+        compositor_text_small(line, 10, 55, link_color(state), WHITE);
+        compositor_text_small("UART 115200  PA11(TX) PA12(RX)", 10, 70, BLACK, WHITE);
+        if (speculate_enabled()) compositor_static_small("Prefetch", 255, 70, BLUE, WHITE);
+    } else if (!startup_done()) {
+        compositor_text_small("UART: Starting...", 10, 55, BLACK, WHITE);
     } else {
-        extapp_drawTextSmall("UART: Not initialized", 10, 55, RED, WHITE, false);
+        compositor_text_small("UART: Not initialized", 10, 55, RED, WHITE);
     }
 }
 
-static void draw_init_screen() {
-    clear_screen();
-    draw_header();
-    
-    extapp_drawTextLarge("Initializing...", 70, 100, BLUE, WHITE, false);
-    extapp_drawTextSmall("Configuring UART hardware", 50, 130, BLACK, WHITE, false);
-    extapp_drawTextSmall("STM32F730 UART1 registers", 50, 150, BLACK, WHITE, false);
-    extapp_drawTextSmall("Baudrate: 115200 baud", 70, 170, BLACK, WHITE, false);
-}
-
 static void draw_menu() {
-    clear_screen();
+    ProfMark mark = profiler_begin();
+    compositor_begin(WHITE);
     draw_header();
     draw_status();
     
-    extapp_drawTextSmall("Select calculation:", 10, 90, BLACK, WHITE, false);
-    
-    // Dibujar opciones del menú
-    for (int i = 0; i < 6; i++) {
+    // Dibujar opciones del menú (cada fila queda en caché normal y resaltada)
+    for (int i = 0; i < MENU_ITEM_COUNT; i++) {
         uint16_t color = (i == menu_selection) ? WHITE : BLACK;
         uint16_t bg = (i == menu_selection) ? BLUE : WHITE;
         
         char menu_line[50];
         snprintf(menu_line, sizeof(menu_line), "%d. %s", i + 1, problem_names[i]);
-        extapp_drawTextSmall(menu_line, 10, 110 + i * 16, color, bg, false);
+        compositor_static_small(menu_line, 10, 88 + i * 15, color, bg);
     }
     
     // Instrucciones
-    extapp_drawTextSmall("Up/Down: Navigate  OK: Select", 10, 200, BLACK, WHITE, false);
-    extapp_drawTextSmall("Back: Exit", 10, 220, BLACK, WHITE, false);
+    compositor_static_small("Up/Down: Navigate  OK: Select  Back: Exit", 10, 226, BLACK, WHITE);
+    
+    compositor_end();
+    profiler_end(PROF_DRAW_MENU, mark);
+}
+
+// Siguiente campo usado por el producto en la dirección indicada
+static int next_edit_field(CalcProduct product, int from, int direction) {
+    for (int f = from + direction; f >= 0 && f < CALC_FIELD_COUNT; f += direction) {
+        if (calc_field_used(product, (CalcField)f)) return f;
+    }
+    return from;
+}
+
+static __attribute__((noinline)) void draw_edit_screen() {
+    ProfMark mark = profiler_begin();
+    CalcProduct product = (CalcProduct)menu_selection;
+    const CalcParams* params = &calc_params[product];
+    
+    compositor_begin(WHITE);
+    draw_header();
+    
+    compositor_static_small(calc_product_name(product), 10, 55, BLUE, WHITE);
+    
+    // Una fila por campo: etiqueta fija (resaltada si está seleccionada) y valor
+    int y = 80;
+    for (int f = 0; f < CALC_FIELD_COUNT; f++) {
+        if (!calc_field_used(product, (CalcField)f)) continue;
+        bool selected = (f == edit_field);
+        
+        char value[24];
+        char line[32];
+        calc_field_format(params, (CalcField)f, value, sizeof(value));
+        snprintf(line, sizeof(line), selected ? "< %s >" : "  %s", value);
+        
+        compositor_static_small(calc_field_label(product, (CalcField)f), 10, y,
+                                selected ? WHITE : BLACK, selected ? BLUE : WHITE);
+        compositor_text_small(line, 130, y, BLACK, WHITE);
+        y += 20;
+    }
+    
+    // Registro tal como sale hacia el Pi
+    char message[40];
+    calc_params_to_message(params, message, sizeof(message));
+    compositor_text_small(message, 10, 186, CYAN, WHITE);
+    
+    compositor_static_small("Up/Down: Field  Left/Right: Change", 10, 212, BLACK, WHITE);
+    compositor_static_small("OK: Send  Back: Menu", 10, 226, BLACK, WHITE);
+    
+    compositor_end();
+    profiler_end(PROF_DRAW_EDIT, mark);
 }
 
 static void draw_processing_screen() {
-    clear_screen();
+    compositor_begin(WHITE);
     draw_header();
     
-    extapp_drawTextLarge("Processing...", 70, 80, BLUE, WHITE, false);
-    extapp_drawTextSmall("Sending via UART to Pi", 60, 110, BLACK, WHITE, false);
-    extapp_drawTextSmall("Pi forwarding to Google Cloud", 40, 130, BLACK, WHITE, false);
-    extapp_drawTextSmall("Waiting for AI response...", 60, 150, BLACK, WHITE, false);
+    compositor_text_large("Processing...", 70, 80, BLUE, WHITE);
+    compositor_text_small("Sending via UART to Pi", 60, 110, BLACK, WHITE);
+    compositor_text_small("Pi forwarding to Google Cloud", 40, 130, BLACK, WHITE);
+    compositor_text_small("Waiting for AI response...", 60, 150, BLACK, WHITE);
     
     // Animación simple
     static int dots = 0;
@@ -170,114 +490,394 @@ static void draw_processing_screen() {
         strcat(progress, ".");
     }
     
-    extapp_drawTextSmall(progress, 120, 170, BLUE, WHITE, false);
+    compositor_text_small(progress, 120, 170, BLUE, WHITE);
+    
+    compositor_end();
+}
+
+// Un campo por fila: etiqueta a la izquierda y valor con formato uniforme
+// alineado a la derecha (42 caracteres entre x = 10 y x = 310)
+static void draw_solution_fields() {
+    for (int i = 0; i < solution.count && i < SOLUTION_MAX_FIELDS; i++) {
+        const SolutionField* field = &solution.fields[i];
+        char value[SOLUTION_FORMAT_MAX];
+        size_t len = solution_format(field, response, value, sizeof(value));
+        StrView label = solution_span(response, field->label);
+        int y = 80 + i * 14;
+        compositor_view_small(sv_take(label, 41 - len), 10, y, BLACK, WHITE);
+        compositor_text_small(value, 310 - (int)len * 7, y, BLACK, WHITE);
+    }
 }
 
 static void draw_result_screen() {
-    clear_screen();
+    ProfMark mark = profiler_begin();
+    compositor_begin(WHITE);
     draw_header();
     
-    extapp_drawTextSmall("AI Response:", 10, 60, GREEN, WHITE, false);
-    
-    // Mostrar resultado dividido en líneas
-    char temp_buffer[1024];
-    strncpy(temp_buffer, response_buffer, sizeof(temp_buffer) - 1);
-    temp_buffer[sizeof(temp_buffer) - 1] = '\0';
-    
-    char* line = temp_buffer;
-    int y = 80;
-    int chars_per_line = 38;
+    compositor_static_small("AI Response:", 10, 60, GREEN, WHITE);
+    if (response_note) {
+        compositor_static_small(response_note, 110, 60, BLUE, WHITE);
+    }
     
-    while (strlen(line) > 0 && y < 190) {
-        char display_line[40];
+    if (solution.count && !result_as_text) {
+        draw_solution_fields();
+        compositor_static_small("<>: Full text", 10, 200, BLUE, WHITE);
+    } else {
+        // Mostrar resultado dividido en líneas, cada una una vista de la respuesta
+        StrView rest = response;
+        int y = 80;
+        const size_t chars_per_line = 38;
         
-        if (strlen(line) <= chars_per_line) {
-            strcpy(display_line, line);
-            line += strlen(line);
-        } else {
-            // Buscar espacio para cortar palabra completa
-            int cut_pos = chars_per_line;
-            while (cut_pos > 0 && line[cut_pos] != ' ' && line[cut_pos] != '\0') {
-                cut_pos--;
-            }
-            if (cut_pos == 0) cut_pos = chars_per_line;
-            
-            strncpy(display_line, line, cut_pos);
-            display_line[cut_pos] = '\0';
-            line += cut_pos;
-            if (*line == ' ') line++; // Saltar espacio
+        while (!sv_empty(rest) && y < 190) {
+            compositor_view_small(text_wrap_next(&rest, chars_per_line), 10, y, BLACK, WHITE);
+            y += 14;
         }
         
-        extapp_drawTextSmall(display_line, 10, y, BLACK, WHITE, false);
-        y += 14;
+        compositor_static_small(solution.count ? "<>: Fields" : "Powered by Google Cloud AI", 10, 200, BLUE, WHITE);
     }
+    compositor_static_small("Press any key to continue", 10, 220, BLACK, WHITE);
     
-    extapp_drawTextSmall("Powered by Google Cloud AI", 10, 200, BLUE, WHITE, false);
-    extapp_drawTextSmall("Press any key to continue", 10, 220, BLACK, WHITE, false);
+    compositor_end();
+    profiler_end(PROF_DRAW_RESULT, mark);
 }
 
 static void draw_error_screen() {
-    clear_screen();
+    ProfMark mark = profiler_begin();
+    compositor_begin(WHITE);
     draw_header();
     
-    extapp_drawTextLarge("Error", 130, 80, RED, WHITE, false);
-    
-    // Mostrar mensaje de error
-    char temp_buffer[1024];
-    strncpy(temp_buffer, response_buffer, sizeof(temp_buffer) - 1);
-    temp_buffer[sizeof(temp_buffer) - 1] = '\0';
+    compositor_text_large("Error", 130, 80, RED, WHITE);
     
-    char* line = temp_buffer;
+    // Mostrar mensaje de error en trozos de 34 caracteres
+    StrView rest = response;
     int y = 110;
     
-    while (strlen(line) > 0 && y < 180) {
-        char display_line[35];
-        if (strlen(line) <= 34) {
-            strcpy(display_line, line);
-            line += strlen(line);
-        } else {
-            strncpy(display_line, line, 34);
-            display_line[34] = '\0';
-            line += 34;
-        }
-        
-        extapp_drawTextSmall(display_line, 10, y, RED, WHITE, false);
+    while (!sv_empty(rest) && y < 180) {
+        compositor_view_small(sv_take(rest, 34), 10, y, RED, WHITE);
+        rest = sv_drop(rest, 34);
         y += 15;
     }
     
-    extapp_drawTextSmall("Check connections and try again", 10, 200, BLACK, WHITE, false);
-    extapp_drawTextSmall("Press any key to continue", 10, 220, BLACK, WHITE, false);
+    compositor_text_small("Check connections and try again", 10, 200, BLACK, WHITE);
+    compositor_static_small("Press any key to continue", 10, 220, BLACK, WHITE);
+    
+    compositor_end();
+    profiler_end(PROF_DRAW_ERROR, mark);
 }
 
 static void draw_test_screen() {
-    clear_screen();
+    compositor_begin(WHITE);
+    draw_header();
+    
+    compositor_text_large("Testing...", 90, 100, BLUE, WHITE);
+    compositor_text_small("Checking Pi connection", 70, 130, BLACK, WHITE);
+    compositor_text_small("Heartbeat PING sent", 75, 150, BLACK, WHITE);
+    
+    compositor_end();
+}
+
+static void draw_diag_line(const char* label, uint32_t value, int y, uint16_t color) {
+    char line[40];
+    snprintf(line, sizeof(line), "%-16s %lu", label, (unsigned long)value);
+    compositor_text_small(line, 10, y, color, WHITE);
+}
+
+static void draw_memory_page() {
+    compositor_text_small("Memory per state (bytes)", 10, 55, BLUE, WHITE);
+    compositor_text_small("State       frames stack arena", 10, 70, BLACK, WHITE);
+    
+    int y = 84;
+    for (int i = 0; i < (int)(sizeof(state_names) / sizeof(state_names[0])); i++) {
+        const MemStateStats* s = mem_monitor_state((uint8_t)i);
+        char line[48];
+        snprintf(line, sizeof(line), "%-11s %6lu %5lu %5lu", state_names[i], (unsigned long)s->frames,
+                 (unsigned long)s->stack_peak, (unsigned long)s->arena_peak);
+        compositor_text_small(line, 10, y, BLACK, WHITE);
+        y += 12;
+    }
+    
+    // Pila pintada y arena (usada/pico/total) en una línea bajo los estados
+    char line[48];
+    bool saturated = mem_monitor_stack_saturated();
+    snprintf(line, sizeof(line), "Stack %s%lu/%lu  Arena %lu/%lu/%d", saturated ? ">=" : "",
+             (unsigned long)mem_monitor_stack_high_water(), (unsigned long)mem_monitor_stack_painted(),
+             (unsigned long)arena_used(), (unsigned long)arena_peak(), ARENA_SIZE);
+    compositor_text_small(line, 10, 206, saturated ? RED : BLACK, WHITE);
+}
+
+static void draw_speculation_page() {
+    SpeculateStats spec;
+    QueueStats queue;
+    speculate_get_stats(&spec);
+    request_queue_get_stats(&queue);
+    
+#if ACTUARIAL_RELIABLE_LINK
+    compositor_text_small("Prefetch: off (line protocol only)", 10, 55, BLUE, WHITE);
+#else
+    compositor_text_small(speculate_enabled() ? "Prefetch: on (Shift in menu)" : "Prefetch: off (Shift in menu)",
+                          10, 55, BLUE, WHITE);
+#endif
+    draw_diag_line("Started:", spec.started, 72, BLACK);
+    draw_diag_line("Hits:", spec.hits, 85, BLACK);
+    draw_diag_line("Hit rate (%):", spec.started ? spec.hits * 100 / spec.started : 0, 98, BLACK);
+    draw_diag_line("Still in flight:", spec.promoted, 111, BLACK);
+    draw_diag_line("Cancelled:", spec.cancelled, 124, BLACK);
+    draw_diag_line("Unused:", spec.unused, 137, BLACK);
+    draw_diag_line("Wasted bytes:", spec.wasted_bytes, 150, spec.wasted_bytes ? ORANGE : BLACK);
+    
+    compositor_text_small("Offline queue", 10, 170, BLUE, WHITE);
+    draw_diag_line("Queued:", queue.queued, 187, BLACK);
+    draw_diag_line("Answered:", queue.answered, 200, BLACK);
+}
+
+static __attribute__((noinline)) void draw_diag_screen() {
+    ProfMark mark = profiler_begin();
+    UartStats stats;
+    uart_hardware_get_stats(&stats);
+    
+    compositor_begin(WHITE);
     draw_header();
     
-    extapp_drawTextLarge("Testing...", 90, 100, BLUE, WHITE, false);
-    extapp_drawTextSmall("Checking Pi connection", 70, 130, BLACK, WHITE, false);
-    extapp_drawTextSmall("Sending TEST_CONNECTION", 60, 150, BLACK, WHITE, false);
+    if (diag_page == 2) {
+        draw_speculation_page();
+        compositor_text_small("<>: Page  Back: Menu", 10, 222, BLUE, WHITE);
+        compositor_end();
+        profiler_end(PROF_DRAW_DIAG, mark);
+        return;
+    }
+    
+    if (diag_page == 1) {
+        draw_memory_page();
+        compositor_text_small("OK: Reset  <>: Page  Back: Menu", 10, 222, BLUE, WHITE);
+        compositor_end();
+        profiler_end(PROF_DRAW_DIAG, mark);
+        return;
+    }
+    
+    compositor_text_small("Link diagnostics (UART1)", 10, 55, BLUE, WHITE);
+    
+    // Grabación de la sesión: bytes usados del buffer
+    char session_line[24];
+    if (uart_session_recording()) {
+        snprintf(session_line, sizeof(session_line), "REC %luB", (unsigned long)uart_session_length());
+    } else {
+        snprintf(session_line, sizeof(session_line), uart_session_truncated() ? "Rec full" : "Shift: Rec");
+    }
+    compositor_text_small(session_line, 310 - (int)strlen(session_line) * 7, 55,
+                          uart_session_recording() ? RED : BLACK, WHITE);
+    
+    draw_diag_line("Bytes sent:", stats.tx_bytes, 72, BLACK);
+    draw_diag_line("Bytes received:", stats.rx_bytes, 85, BLACK);
+    draw_diag_line("Overrun (ORE):", stats.overrun_errors, 98, stats.overrun_errors ? RED : BLACK);
+    draw_diag_line("Framing (FE):", stats.framing_errors, 111, stats.framing_errors ? RED : BLACK);
+    draw_diag_line("Noise (NF):", stats.noise_errors, 124, stats.noise_errors ? RED : BLACK);
+    draw_diag_line("Parity (PE):", stats.parity_errors, 137, stats.parity_errors ? RED : BLACK);
+    draw_diag_line("TX timeouts:", stats.tx_timeouts, 150, stats.tx_timeouts ? RED : BLACK);
+    draw_diag_line("RX timeouts:", stats.rx_timeouts, 163, BLACK);
+    draw_diag_line("Retries:", stats.retries, 176, BLACK);
+    draw_diag_line("Recoveries:", stats.recoveries, 189, BLACK);
+    
+    char startup_line[48];
+    snprintf(startup_line, sizeof(startup_line), "Startup: frame %lums ready %lums",
+             (unsigned long)startup_first_frame_ms(), (unsigned long)startup_ready_ms());
+    compositor_text_small(startup_line, 10, 204, startup_within_budget() ? BLACK : RED, WHITE);
+    
+    compositor_text_small("OK: Reset  <>: Page  Back: Menu", 10, 222, BLUE, WHITE);
+    
+    compositor_end();
+    profiler_end(PROF_DRAW_DIAG, mark);
+}
+
+static __attribute__((noinline)) void draw_history_screen() {
+    ProfMark mark = profiler_begin();
+    compositor_begin(WHITE);
+    draw_header();
+    
+    char line[48];
+    snprintf(line, sizeof(line), "Queued requests: %lu pending%s", (unsigned long)request_queue_pending(),
+             request_queue_flushing() ? ", sending" : "");
+    compositor_text_small(line, 10, 55, BLUE, WHITE);
+    
+    // De la más reciente a la más antigua, con su estado
+    uint32_t count = request_queue_count();
+    if (count == 0) {
+        compositor_static_small("Nothing queued while the link was down", 10, 80, BLACK, WHITE);
+    }
+    for (uint32_t i = 0; i < count && i < HISTORY_ROWS; i++) {
+        const QueueEntry* entry = request_queue_entry(i);
+        CalcParams params;
+        bool valid = calc_params_decode(entry->record, &params);
+        bool selected = ((int)i == history_selection);
+        snprintf(line, sizeof(line), "%-7s %s, age %u", request_queue_status_name((QueueStatus)entry->status),
+                 valid ? calc_product_name((CalcProduct)params.product) : "?", valid ? params.age : 0);
+        compositor_text_small(line, 10, 80 + i * 20, selected ? WHITE : BLACK, selected ? BLUE : WHITE);
+    }
+    
+    compositor_static_small("OK: Open  Back: Menu", 10, 222, BLUE, WHITE);
+    
+    compositor_end();
+    profiler_end(PROF_DRAW_HISTORY, mark);
+}
+
+static __attribute__((noinline)) void draw_schedule_screen() {
+    ProfMark mark = profiler_begin();
+    compositor_begin(WHITE);
+    draw_header();
+    
+    char line[80];
+    snprintf(line, sizeof(line), "Term premium per 1000, SUSM %u.%02u%%", schedule_rate_bp / 100,
+             schedule_rate_bp % 100);
+    compositor_text_small(line, 10, 55, BLUE, WHITE);
+    
+    // Cabecera con los plazos visibles y una fila por edad
+    int len = snprintf(line, sizeof(line), "Age");
+    for (int c = 0; c < SCHEDULE_COLS; c++) {
+        len += snprintf(line + len, sizeof(line) - len, "%7dy", PREMIUM_TABLE_MIN_TERM + schedule_col + c);
+    }
+    compositor_text_small(line, 10, 72, BLACK, WHITE);
+    
+    for (int r = 0; r < SCHEDULE_ROWS; r++) {
+        const float* row = &schedule_table[(schedule_row + r) * PREMIUM_TABLE_TERMS + schedule_col];
+        len = snprintf(line, sizeof(line), "%3d", PREMIUM_TABLE_MIN_AGE + schedule_row + r);
+        for (int c = 0; c < SCHEDULE_COLS; c++) {
+            len += snprintf(line + len, sizeof(line) - len, "%8.3f", (double)row[c]);
+        }
+        compositor_text_small(line, 10, 88 + r * 13, BLACK, WHITE);
+    }
+    
+    snprintf(line, sizeof(line), "Ages %d-%d of %d-%d, terms %d-%d of %d-%d",
+             PREMIUM_TABLE_MIN_AGE + schedule_row, PREMIUM_TABLE_MIN_AGE + schedule_row + SCHEDULE_ROWS - 1,
+             PREMIUM_TABLE_MIN_AGE, PREMIUM_TABLE_MAX_AGE,
+             PREMIUM_TABLE_MIN_TERM + schedule_col, PREMIUM_TABLE_MIN_TERM + schedule_col + SCHEDULE_COLS - 1,
+             PREMIUM_TABLE_MIN_TERM, PREMIUM_TABLE_MAX_TERM);
+    compositor_text_small(line, 10, 206, BLACK, WHITE);
+    compositor_static_small("Arrows: Scroll  Back: Menu", 10, 222, BLUE, WHITE);
+    
+    compositor_end();
+    profiler_end(PROF_DRAW_SCHEDULE, mark);
+}
+
+static void uart_init_task(void) {
+    if (!uart_init()) {
+        set_response("Failed to initialize UART hardware");
+        current_state = STATE_ERROR;
+    }
+}
+
+// Especulación sobre lo que el usuario tiene delante: la fila de cálculo
+// resaltada o los parámetros del editor. Sólo con la línea libre (sin
+// latido ni cola pendiente). Fuera de línea para no engordar el marco de
+// extapp_main, que está debajo de todo el dibujo.
+static __attribute__((noinline)) void speculate_frame(uint64_t now) {
+    uint8_t record[CALC_RECORD_SIZE];
+    bool menu_row = current_state == STATE_MENU && menu_selection < CALC_PRODUCT_COUNT;
+    if (!menu_row && current_state != STATE_EDIT) {
+        speculate_hover(NULL, now, false);
+        return;
+    }
+    calc_params_encode(&calc_params[menu_selection], record);
+    bool line_idle = uart_ready && link_monitor_state() == LINK_UP && !link_monitor_ping_pending() &&
+                     !request_queue_flushing() && !request_queue_pending();
+    speculate_hover(record, now, line_idle);
+}
+
+// Cambios del frame para la traza: estado, enlace y errores nuevos del UART
+static __attribute__((noinline)) void trace_frame(AppState frame_state) {
+    static LinkState traced_link;
+    static UartStats traced;
+    
+    if (current_state != frame_state) {
+        trace_event(TRACE_STATE, (uint8_t)frame_state, (uint16_t)current_state, 0);
+        // Lo último antes de la pantalla de error queda guardado
+        if (current_state == STATE_ERROR) trace_flush();
+    }
+    
+    LinkState link = link_monitor_state();
+    if (link != traced_link) {
+        trace_event(TRACE_LINK, (uint8_t)traced_link, (uint16_t)link, link_monitor_rtt_ms());
+        traced_link = link;
+    }
+    
+    if (!uart_ready) return;
+    UartStats now;
+    uart_hardware_get_stats(&now);
+    const uint32_t counters[][2] = {
+        { now.overrun_errors, traced.overrun_errors },
+        { now.framing_errors, traced.framing_errors },
+        { now.noise_errors, traced.noise_errors },
+        { now.parity_errors, traced.parity_errors },
+        { now.tx_timeouts, traced.tx_timeouts },
+        { now.recoveries, traced.recoveries },
+    };
+    // Tras "OK: Reset" en el diagnóstico los contadores bajan: no es un error
+    for (int i = 0; i < (int)(sizeof(counters) / sizeof(counters[0])); i++) {
+        if (counters[i][0] > counters[i][1]) {
+            trace_event(TRACE_UART_ERROR, (uint8_t)(TRACE_ERR_OVERRUN + i),
+                        (uint16_t)(counters[i][0] - counters[i][1]), counters[i][0]);
+        }
+    }
+    traced = now;
 }
 
 // Función principal
 void extapp_main() {
     uint64_t last_update = 0;
     bool processing_started = false;
+    uint32_t test_round = 0;
+    
+    mem_monitor_begin();
+    profiler_init();
+    trace_init();
+    request_queue_init();
+    compositor_set_layer(profiler_draw_overlay);
+    
+    for (int i = 0; i < CALC_PRODUCT_COUNT; i++) {
+        calc_params_defaults((CalcProduct)i, &calc_params[i]);
+    }
+    
+    // El menú sale en el primer frame; el UART se configura justo después
+    startup_begin(extapp_millis);
+    startup_defer(uart_init_task);
     
     while (true) {
         uint64_t current_time = extapp_millis();
         uint64_t keys = extapp_scanKeyboard();
+        AppState frame_state = current_state;
+        
+        // Toolbox: tiempos por etapa encima de cualquier pantalla
+        if (keys & SCANCODE_Toolbox) {
+            profiler_toggle_overlay();
+            keys = 0;
+            last_update = 0;
+            power_sleep(200);
+        }
+        
+        startup_run_deferred();
+        
+        // El latido corre en todas las pantallas salvo durante una petición
+        // o una tanda de la cola, que leen la línea por su cuenta
+        if (uart_ready && current_state != STATE_PROCESSING) {
+            if (request_queue_flushing()) {
+                request_queue_tick(current_time);
+            } else if (speculate_busy()) {
+                speculate_tick(current_time);
+            } else {
+                link_monitor_tick(current_time);
+                // El Pi vuelve a responder: la cola sale en una tanda
+                if (link_monitor_state() == LINK_UP && !link_monitor_ping_pending() &&
+                    request_queue_pending()) {
+                    request_queue_flush_start(current_time);
+                }
+            }
+        }
         
         switch (current_state) {
             case STATE_INIT:
-                draw_init_screen();
-                extapp_msleep(2000);  // Mostrar pantalla de inicialización
-                
-                if (uart_init()) {
-                    current_state = STATE_MENU;
-                } else {
-                    strcpy(response_buffer, "Failed to initialize UART hardware");
-                    current_state = STATE_ERROR;
-                }
+                // Primer frame: el menú directamente, sin esperar al hardware
+                draw_menu();
+                last_update = current_time;
+                startup_frame_presented();
+                current_state = STATE_MENU;
                 break;
                 
             case STATE_MENU:
@@ -288,26 +888,95 @@ void extapp_main() {
                 
                 if (keys & SCANCODE_Up && menu_selection > 0) {
                     menu_selection--;
-                    extapp_msleep(150);
-                } else if (keys & SCANCODE_Down && menu_selection < 5) {
+                    power_sleep(150);
+                } else if (keys & SCANCODE_Down && menu_selection < MENU_ITEM_COUNT - 1) {
                     menu_selection++;
-                    extapp_msleep(150);
+                    power_sleep(150);
                 } else if (keys & SCANCODE_OK || keys & SCANCODE_EXE) {
-                    if (menu_selection == 5) {  // Test connection
+                    if (menu_selection == MENU_TEST) {
+                        // No bloquea: pide un latido ya y espera su resultado
+                        test_round = link_monitor_rounds();
+                        link_monitor_probe(current_time);
+                        draw_test_screen();
                         current_state = STATE_TEST;
+                    } else if (menu_selection == MENU_DIAG) {
+                        current_state = STATE_DIAG;
+                        last_update = 0;
+                        power_sleep(200);
+                    } else if (menu_selection == MENU_SCHEDULE) {
+                        // Toda la tabla en una pasada, al interés del seguro temporal
+                        uint16_t rate_bp = calc_params[CALC_TERM_LIFE].rate_bp;
+                        if (rate_bp != schedule_rate_bp) {
+                            premium_table_fill(rate_bp, schedule_table);
+                            schedule_rate_bp = rate_bp;
+                        }
+                        current_state = STATE_SCHEDULE;
+                        last_update = 0;
+                        power_sleep(200);
+                    } else if (menu_selection == MENU_HISTORY) {
+                        history_selection = 0;
+                        current_state = STATE_HISTORY;
+                        last_update = 0;
+                        power_sleep(200);
                     } else {
-                        current_state = STATE_PROCESSING;
-                        processing_started = false;
+                        edit_field = next_edit_field((CalcProduct)menu_selection, -1, 1);
+                        current_state = STATE_EDIT;
+                        last_update = 0;
+                        power_sleep(200);
                     }
+                } else if (keys & SCANCODE_Shift) {
+#if !ACTUARIAL_RELIABLE_LINK
+                    // La especulación usa el protocolo de líneas: sin ella con tramas
+                    speculate_set_enabled(!speculate_enabled());
+#endif
+                    last_update = 0;
+                    power_sleep(200);
                 } else if (keys & SCANCODE_Back || keys & SCANCODE_Home) {
                     // Pantalla de despedida
-                    clear_screen();
-                    extapp_drawTextLarge("Goodbye!", 100, 100, BLUE, WHITE, false);
-                    extapp_msleep(1000);
+                    compositor_begin(WHITE);
+                    compositor_text_large("Goodbye!", 100, 100, BLUE, WHITE);
+                    compositor_end();
+                    trace_flush();
+                    // Lo grabado, también si se paró al llenarse el buffer
+                    if (uart_session_recording() || uart_session_truncated()) uart_session_save();
+                    power_sleep(1000);
                     return;
                 }
                 break;
                 
+            case STATE_EDIT: {
+                CalcProduct product = (CalcProduct)menu_selection;
+                bool changed = true;
+                
+                if (keys & SCANCODE_Up) {
+                    edit_field = next_edit_field(product, edit_field, -1);
+                } else if (keys & SCANCODE_Down) {
+                    edit_field = next_edit_field(product, edit_field, 1);
+                } else if (keys & SCANCODE_Left) {
+                    calc_field_step(&calc_params[product], (CalcField)edit_field, -1);
+                } else if (keys & SCANCODE_Right) {
+                    calc_field_step(&calc_params[product], (CalcField)edit_field, 1);
+                } else {
+                    changed = false;
+                }
+                
+                if (changed || current_time - last_update > 100) {
+                    draw_edit_screen();
+                    last_update = current_time;
+                }
+                
+                if (changed) {
+                    power_sleep(150);
+                } else if (keys & SCANCODE_OK || keys & SCANCODE_EXE) {
+                    current_state = STATE_PROCESSING;
+                    processing_started = false;
+                } else if (keys & SCANCODE_Back || keys & SCANCODE_Home) {
+                    current_state = STATE_MENU;
+                    power_sleep(200);
+                }
+                break;
+            }
+                
             case STATE_PROCESSING:
                 if (current_time - last_update > 300) {
                     draw_processing_screen();
@@ -317,7 +986,7 @@ void extapp_main() {
                 if (!processing_started) {
                     processing_started = true;
                     
-                    if (send_problem_to_pi(problems[menu_selection])) {
+                    if (send_request_to_pi(&calc_params[menu_selection])) {
                         current_state = STATE_RESULT;
                     } else {
                         current_state = STATE_ERROR;
@@ -326,15 +995,28 @@ void extapp_main() {
                 break;
                 
             case STATE_TEST:
-                draw_test_screen();
-                extapp_msleep(1000);
-                
-                if (test_pi_connection()) {
-                    strcpy(response_buffer, "Connection test successful! Raspberry Pi is responding correctly via UART.");
-                    current_state = STATE_RESULT;
-                } else {
-                    strcpy(response_buffer, "Connection test failed. Check UART wiring and Pi status.");
+                if (!uart_ready) {
+                    set_response("Connection test failed. UART not initialized.");
                     current_state = STATE_ERROR;
+                } else if (link_monitor_rounds() != test_round) {
+                    if (link_monitor_last_ok()) {
+                        CharSlice text = begin_response(127);
+                        if (text.data) {
+                            snprintf(text.data, text.cap + 1,
+                                     "Connection test successful! Raspberry Pi is responding correctly via UART. RTT %lu ms.",
+                                     (unsigned long)link_monitor_rtt_ms());
+                            set_response(text.data);
+                        } else {
+                            set_response("Connection test successful!");
+                        }
+                        response_note = NULL;
+                        current_state = STATE_RESULT;
+                    } else {
+                        set_response("Connection test failed. Check UART wiring and Pi status.");
+                        current_state = STATE_ERROR;
+                    }
+                } else if (keys & SCANCODE_Back) {
+                    current_state = STATE_MENU;
                 }
                 break;
                 
@@ -344,9 +1026,13 @@ void extapp_main() {
                     last_update = current_time;
                 }
                 
-                if (keys != 0) {
+                if ((keys & SCANCODE_Left || keys & SCANCODE_Right) && solution.count) {
+                    result_as_text = !result_as_text;
+                    last_update = 0;
+                    power_sleep(200);
+                } else if (keys != 0) {
                     current_state = STATE_MENU;
-                    extapp_msleep(200);
+                    power_sleep(200);
                 }
                 break;
                 
@@ -358,11 +1044,111 @@ void extapp_main() {
                 
                 if (keys != 0) {
                     current_state = STATE_MENU;
-                    extapp_msleep(200);
+                    power_sleep(200);
+                }
+                break;
+                
+            case STATE_DIAG:
+                // Refresco lento: los contadores cambian poco y así no parpadea
+                if (current_time - last_update > 500) {
+                    draw_diag_screen();
+                    last_update = current_time;
+                }
+                
+                if (keys & SCANCODE_OK || keys & SCANCODE_EXE) {
+                    if (diag_page == 1) mem_monitor_reset_stats();
+                    else if (diag_page == 0) uart_hardware_reset_stats();
+                    last_update = 0;
+                    power_sleep(200);
+                } else if (keys & SCANCODE_Left || keys & SCANCODE_Right) {
+                    diag_page = (diag_page + (keys & SCANCODE_Left ? DIAG_PAGES - 1 : 1)) % DIAG_PAGES;
+                    last_update = 0;
+                    power_sleep(200);
+                } else if (keys & SCANCODE_Shift && diag_page == 0 && uart_ready) {
+                    // Al parar se guarda: UART_SESSION_FILE_NAME
+                    if (uart_session_recording()) {
+                        uart_session_stop();
+                        uart_session_save();
+                    } else {
+                        uart_session_start();
+                    }
+                    last_update = 0;
+                    power_sleep(200);
+                } else if (keys & SCANCODE_Back || keys & SCANCODE_Home) {
+                    current_state = STATE_MENU;
+                    power_sleep(200);
+                }
+                break;
+                
+            case STATE_HISTORY:
+                // Una tanda en curso cambia los estados mientras se mira
+                if (current_time - last_update > 300) {
+                    draw_history_screen();
+                    last_update = current_time;
+                }
+                
+                if (keys & SCANCODE_Up && history_selection > 0) {
+                    history_selection--;
+                    last_update = 0;
+                    power_sleep(150);
+                } else if (keys & SCANCODE_Down && history_selection + 1 < (int)request_queue_count()) {
+                    history_selection++;
+                    last_update = 0;
+                    power_sleep(150);
+                } else if (keys & SCANCODE_OK || keys & SCANCODE_EXE) {
+                    const QueueEntry* entry = request_queue_entry((uint32_t)history_selection);
+                    if (entry && (entry->status == QUEUE_DONE || entry->status == QUEUE_FAILED)) {
+                        // La respuesta completa si sigue en la caché; si no, la guardada
+                        if (!show_cached(entry->record)) {
+                            response = sv_make(entry->result, entry->result_len);
+                            solution_parse(response, &solution);
+                        }
+                        response_note = "(history)";
+                        current_state = STATE_RESULT;
+                        last_update = 0;
+                        power_sleep(200);
+                    }
+                } else if (keys & SCANCODE_Back || keys & SCANCODE_Home) {
+                    current_state = STATE_MENU;
+                    power_sleep(200);
                 }
                 break;
+                
+            case STATE_SCHEDULE: {
+                bool moved = true;
+                
+                if (keys & SCANCODE_Up && schedule_row > 0) {
+                    schedule_row--;
+                } else if (keys & SCANCODE_Down && schedule_row + SCHEDULE_ROWS < PREMIUM_TABLE_AGES) {
+                    schedule_row++;
+                } else if (keys & SCANCODE_Left && schedule_col > 0) {
+                    schedule_col--;
+                } else if (keys & SCANCODE_Right && schedule_col + SCHEDULE_COLS < PREMIUM_TABLE_TERMS) {
+                    schedule_col++;
+                } else {
+                    moved = false;
+                }
+                
+                if (moved || current_time - last_update > 300) {
+                    draw_schedule_screen();
+                    last_update = current_time;
+                }
+                
+                if (moved) {
+                    power_sleep(150);
+                } else if (keys & SCANCODE_Back || keys & SCANCODE_Home) {
+                    current_state = STATE_MENU;
+                    power_sleep(200);
+                }
+                break;
+            }
         }
         
-        extapp_msleep(50);
+        // La petición se promociona dentro de STATE_PROCESSING: ahí no se toca
+        if (current_state != STATE_PROCESSING) speculate_frame(current_time);
+        
+        trace_frame(frame_state);
+        mem_monitor_frame((uint8_t)frame_state);
+        power_sleep(50);
     }
 } 
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include <extapp_api.h>
+#include <stdio.h>
 #include <string.h>
+#include "text_layout.h"
 
 // Colores básicos
 #define WHITE 0xFFFF
@@ -30,7 +32,7 @@ bool receive_from_pi(char* response, int max_len) {
     // En implementación real: recibir respuesta del Pi
     // Formato esperado: "SOLUTION:respuesta_de_la_ia\n"
     if (uart_ok) {
-        strcpy(response, "Premium: $45.67/month, Present Value: $8,234.56");
+        snprintf(response, max_len, "Premium: $45.67/month, Present Value: $8,234.56");
         return true;
     }
     return false;
@@ -87,9 +89,14 @@ void extapp_main() {
                 extapp_pushRectUniform(0, 0, LCD_WIDTH, LCD_HEIGHT, WHITE);
                 extapp_drawTextLarge("AI Result:", 80, 20, GREEN, WHITE, false);
                 
-                // Dividir respuesta en líneas
+                // Dividir respuesta en líneas (dos caben antes de "Based on:")
                 extapp_drawTextSmall("Life Insurance Calculation:", 10, 60, BLACK, WHITE, false);
-                extapp_drawTextSmall(response, 10, 80, BLACK, WHITE, false);
+                StrView rest = sv_from_cstr(response);
+                for (int y = 80; y < 110 && !sv_empty(rest); y += 15) {
+                    char line[TEXT_LINE_MAX + 1];
+                    text_copy_line(text_wrap_next(&rest, 38), line, sizeof(line));
+                    extapp_drawTextSmall(line, 10, y, BLACK, WHITE, false);
+                }
                 
                 extapp_drawTextSmall("Based on:", 10, 110, BLACK, WHITE, false);
                 extapp_drawTextSmall("- Standard mortality tables", 10, 130, BLACK, WHITE, false);
@@ -1,6 +1,14 @@
 #include <extapp_api.h>
 #include <string.h>
 #include <stdio.h>
+#include "startup.h"
+#include "text_cache.h"
+#include "compositor.h"
+#include "arena.h"
+#include "strview.h"
+#include "mem_monitor.h"
+#include "power.h"
+#include "text_layout.h"
 
 // Colores
 #define WHITE 0xFFFF
@@ -16,6 +24,7 @@
 #define UART_TX_PIN 11  // PA11
 #define UART_RX_PIN 12  // PA12
 #define MAX_RESPONSE_SIZE 1024
+#define MAX_MESSAGE_SIZE 512
 #define UART_TIMEOUT_MS 30000
 
 // Estados de la aplicación
@@ -30,7 +39,7 @@ typedef enum {
 // Variables globales
 static AppState current_state = STATE_INIT;
 static int menu_selection = 0;
-static char response_buffer[MAX_RESPONSE_SIZE];
+static StrView response;   // Apunta a la arena o a un literal
 static bool uart_initialized = false;
 static bool uart_ok = false;
 
@@ -51,6 +60,8 @@ static const char* problem_names[] = {
     "Insurance Reserves"
 };
 
+static bool uart_send_byte(uint8_t byte);
+
 // Funciones UART (estructura para implementación real)
 bool uart_init() {
     // TODO: Implementar configuración UART real
@@ -103,106 +114,68 @@ static bool uart_send_byte(uint8_t byte) {
     return true;
 }
 
-static bool uart_receive_byte(uint8_t* byte, uint32_t timeout_ms) {
-    if (!uart_initialized || !byte) return false;
-    
-    uint64_t start_time = extapp_millis();
-    
-    // En implementación real:
-    // - Verificar si hay datos disponibles en el buffer de recepción
-    // - Leer byte del registro de datos UART
-    // - Manejar timeout
-    
-    // Simulación: esperar un poco y devolver datos simulados
-    while (extapp_millis() - start_time < timeout_ms) {
-        extapp_msleep(10);
-        // Simular recepción de datos después de 2 segundos
-        if (extapp_millis() - start_time > 2000) {
-            *byte = 'S'; // Primer byte de respuesta simulada
-            return true;
-        }
-    }
-    
-    return false; // Timeout
-}
-
 // Funciones de comunicación con IA
 static bool send_problem_to_ai(const char* problem) {
     if (!problem) return false;
     
+    // La petición anterior ya no se muestra: la arena vuelve a empezar.
+    // La respuesta se recibe en la arena; el mensaje va detrás y se libera
+    // en cuanto sale.
+    arena_reset();
+    CharSlice rx = arena_chars(MAX_RESPONSE_SIZE - 1);
+    size_t message_mark = arena_mark();
+    CharSlice message = arena_chars(MAX_MESSAGE_SIZE - 1);
+    if (!rx.data || !message.data) {
+        response = sv_from_cstr("Error: Out of memory");
+        return false;
+    }
+    
     // Formatear mensaje
-    char message[512];
-    snprintf(message, sizeof(message), "PROBLEM:%s\n", problem);
+    snprintf(message.data, message.cap + 1, "PROBLEM:%s\n", problem);
     
     // Enviar al Raspberry Pi
-    if (!uart_send_string(message)) {
-        strcpy(response_buffer, "Error: Failed to send problem to Pi");
+    bool sent = uart_send_string(message.data);
+    arena_release(message_mark);
+    if (!sent) {
+        response = sv_from_cstr("Error: Failed to send problem to Pi");
         return false;
     }
     
     // Recibir respuesta
-    if (!uart_receive_string(response_buffer, sizeof(response_buffer), UART_TIMEOUT_MS)) {
-        strcpy(response_buffer, "Error: No response from Pi (timeout after 30s)");
+    if (!uart_receive_string(rx.data, (int)rx.cap + 1, UART_TIMEOUT_MS)) {
+        response = sv_from_cstr("Error: No response from Pi (timeout after 30s)");
         return false;
     }
     
-    // Verificar formato de respuesta
-    if (strncmp(response_buffer, "SOLUTION:", 9) == 0) {
-        // Remover prefijo "SOLUTION:"
-        memmove(response_buffer, response_buffer + 9, strlen(response_buffer) - 8);
-        return true;
-    }
+    // Quitar el prefijo "SOLUTION:" sin mover los datos
+    response = sv_from_cstr(rx.data);
+    text_strip_solution(&response);
     
     return true; // Aceptar cualquier respuesta para demostración
 }
 
-static bool test_uart_connection() {
-    if (!uart_send_string("TEST_CONNECTION\n")) {
-        return false;
-    }
-    
-    char test_response[256];
-    if (!uart_receive_string(test_response, sizeof(test_response), 5000)) {
-        return false;
-    }
-    
-    return (strstr(test_response, "TEST_OK") != NULL);
-}
-
-// Funciones de interfaz
-static void clear_screen() {
-    extapp_pushRectUniform(0, 0, LCD_WIDTH, LCD_HEIGHT, WHITE);
-}
-
+// Funciones de interfaz (compositor por bandas)
 static void draw_header() {
-    extapp_drawTextLarge("ActuarialAI", 80, 10, BLUE, WHITE, false);
-    extapp_drawTextSmall("Native UART Communication", 60, 35, BLACK, WHITE, false);
+    compositor_static_large("ActuarialAI", 80, 10, BLUE, WHITE);
+    compositor_static_small("Native UART Communication", 60, 35, BLACK, WHITE);
 }
 
 static void draw_uart_status() {
     if (uart_initialized) {
-        extapp_drawTextSmall("UART: Initialized", 10, 55, GREEN, WHITE, false);
+        compositor_text_small("UART: Initialized", 10, 55, GREEN, WHITE);
+    } else if (!startup_done()) {
+        compositor_text_small("UART: Starting...", 10, 55, BLACK, WHITE);
     } else {
-        extapp_drawTextSmall("UART: Error", 10, 55, RED, WHITE, false);
+        compositor_text_small("UART: Error", 10, 55, RED, WHITE);
     }
 }
 
-static void draw_init_screen() {
-    clear_screen();
-    draw_header();
-    
-    extapp_drawTextLarge("Initializing...", 70, 100, BLUE, WHITE, false);
-    extapp_drawTextSmall("Setting up UART communication", 50, 130, BLACK, WHITE, false);
-    extapp_drawTextSmall("Baudrate: 115200", 90, 150, BLACK, WHITE, false);
-    extapp_drawTextSmall("Pins: PA11(TX), PA12(RX)", 70, 170, BLACK, WHITE, false);
-}
-
 static void draw_menu() {
-    clear_screen();
+    compositor_begin(WHITE);
     draw_header();
     draw_uart_status();
     
-    extapp_drawTextSmall("Select actuarial calculation:", 10, 80, BLACK, WHITE, false);
+    compositor_static_small("Select actuarial calculation:", 10, 80, BLACK, WHITE);
     
     // Dibujar opciones del menú
     for (int i = 0; i < 5; i++) {
@@ -211,108 +184,105 @@ static void draw_menu() {
         
         char menu_line[50];
         snprintf(menu_line, sizeof(menu_line), "%d. %s", i + 1, problem_names[i]);
-        extapp_drawTextSmall(menu_line, 10, 100 + i * 18, color, bg, false);
+        compositor_static_small(menu_line, 10, 100 + i * 18, color, bg);
     }
     
     // Instrucciones
-    extapp_drawTextSmall("Up/Down: Navigate", 10, 200, BLACK, WHITE, false);
-    extapp_drawTextSmall("OK: Calculate  Back: Exit", 10, 220, BLACK, WHITE, false);
+    compositor_static_small("Up/Down: Navigate", 10, 200, BLACK, WHITE);
+    compositor_static_small("OK: Calculate  Back: Exit", 10, 220, BLACK, WHITE);
+    
+    compositor_end();
 }
 
 static void draw_processing_screen() {
-    clear_screen();
+    compositor_begin(WHITE);
     draw_header();
     
-    extapp_drawTextLarge("Processing...", 70, 80, BLUE, WHITE, false);
-    extapp_drawTextSmall("Sending to Raspberry Pi", 60, 110, BLACK, WHITE, false);
-    extapp_drawTextSmall("Waiting for AI response", 60, 130, BLACK, WHITE, false);
+    compositor_text_large("Processing...", 70, 80, BLUE, WHITE);
+    compositor_text_small("Sending to Raspberry Pi", 60, 110, BLACK, WHITE);
+    compositor_text_small("Waiting for AI response", 60, 130, BLACK, WHITE);
     
     // Indicador de progreso simple
     static int progress = 0;
     progress = (progress + 1) % 4;
     
-    char progress_str[10] = "Working";
+    char progress_str[16] = "Working";
     for (int i = 0; i < progress; i++) {
         strcat(progress_str, ".");
     }
     
-    extapp_drawTextSmall(progress_str, 120, 150, BLUE, WHITE, false);
+    compositor_text_small(progress_str, 120, 150, BLUE, WHITE);
+    
+    compositor_end();
 }
 
 static void draw_result_screen() {
-    clear_screen();
+    compositor_begin(WHITE);
     draw_header();
     
-    extapp_drawTextSmall("AI Response:", 10, 60, GREEN, WHITE, false);
-    
-    // Dividir respuesta en líneas para mostrar
-    char temp_buffer[MAX_RESPONSE_SIZE];
-    strncpy(temp_buffer, response_buffer, sizeof(temp_buffer) - 1);
-    temp_buffer[sizeof(temp_buffer) - 1] = '\0';
+    compositor_static_small("AI Response:", 10, 60, GREEN, WHITE);
     
-    char* line = temp_buffer;
+    // Dividir respuesta en líneas, cada una una vista de la respuesta
+    StrView rest = response;
     int y = 80;
-    int chars_per_line = 38;
+    const size_t chars_per_line = 38;
     
-    while (strlen(line) > 0 && y < 200) {
-        char display_line[40];
-        
-        if (strlen(line) <= chars_per_line) {
-            strcpy(display_line, line);
-            line += strlen(line);
-        } else {
-            // Buscar espacio para cortar palabra completa
-            int cut_pos = chars_per_line;
-            while (cut_pos > 0 && line[cut_pos] != ' ' && line[cut_pos] != '\0') {
-                cut_pos--;
-            }
-            if (cut_pos == 0) cut_pos = chars_per_line;
-            
-            strncpy(display_line, line, cut_pos);
-            display_line[cut_pos] = '\0';
-            line += cut_pos;
-            if (*line == ' ') line++; // Saltar espacio
-        }
-        
-        extapp_drawTextSmall(display_line, 10, y, BLACK, WHITE, false);
+    while (!sv_empty(rest) && y < 200) {
+        compositor_view_small(text_wrap_next(&rest, chars_per_line), 10, y, BLACK, WHITE);
         y += 15;
     }
     
-    extapp_drawTextSmall("Press any key to continue", 10, 220, BLUE, WHITE, false);
+    compositor_static_small("Press any key to continue", 10, 220, BLUE, WHITE);
+    
+    compositor_end();
 }
 
 static void draw_error_screen() {
-    clear_screen();
+    compositor_begin(WHITE);
     draw_header();
     
-    extapp_drawTextLarge("Error", 130, 80, RED, WHITE, false);
-    extapp_drawTextSmall("Communication failed", 80, 110, RED, WHITE, false);
-    extapp_drawTextSmall("Check connections:", 80, 130, BLACK, WHITE, false);
-    extapp_drawTextSmall("- UART wiring", 80, 150, BLACK, WHITE, false);
-    extapp_drawTextSmall("- Raspberry Pi status", 80, 170, BLACK, WHITE, false);
+    compositor_text_large("Error", 130, 80, RED, WHITE);
+    compositor_text_small("Communication failed", 80, 110, RED, WHITE);
+    compositor_text_small("Check connections:", 80, 130, BLACK, WHITE);
+    compositor_text_small("- UART wiring", 80, 150, BLACK, WHITE);
+    compositor_text_small("- Raspberry Pi status", 80, 170, BLACK, WHITE);
+    
+    compositor_text_small("Press any key to retry", 70, 210, BLUE, WHITE);
     
-    extapp_drawTextSmall("Press any key to retry", 70, 210, BLUE, WHITE, false);
+    compositor_end();
+}
+
+static void uart_init_task(void) {
+    if (!uart_init()) {
+        response = sv_from_cstr("Failed to initialize UART");
+        current_state = STATE_ERROR;
+    }
 }
 
 // Función principal
 void extapp_main() {
     uint64_t last_update = 0;
     
+    mem_monitor_begin();
+    
+    // El menú sale en el primer frame; el UART se configura justo después
+    startup_begin(extapp_millis);
+    startup_defer(uart_init_task);
+    
     while (true) {
         uint64_t current_time = extapp_millis();
         uint64_t keys = extapp_scanKeyboard();
+        AppState frame_state = current_state;
+        
+        startup_run_deferred();
         
         switch (current_state) {
             case STATE_INIT:
-                draw_init_screen();
-                extapp_msleep(1000);
-                
-                if (uart_init()) {
-                    current_state = STATE_MENU;
-                } else {
-                    strcpy(response_buffer, "Failed to initialize UART");
-                    current_state = STATE_ERROR;
-                }
+                // Primer frame: el menú directamente, sin esperar al hardware
+                draw_menu();
+                last_update = current_time;
+                startup_frame_presented();
+                current_state = STATE_MENU;
                 break;
                 
             case STATE_MENU:
@@ -375,6 +345,7 @@ void extapp_main() {
                 break;
         }
         
-        extapp_msleep(50);
+        mem_monitor_frame((uint8_t)frame_state);
+        power_sleep(50);
     }
 } 
\ No newline at end of file
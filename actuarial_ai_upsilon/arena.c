@@ -0,0 +1,58 @@
+// Arena estática con asignación lineal
+
+#include "arena.h"
+
+static uint8_t storage[ARENA_SIZE] __attribute__((aligned(8)));
+static size_t used;
+static size_t peak;
+static size_t window_peak;
+
+static void note_peak(void) {
+    if (used > peak) peak = used;
+    if (used > window_peak) window_peak = used;
+}
+
+void arena_reset(void) {
+    used = 0;
+}
+
+void* arena_alloc(size_t size, size_t align) {
+    size_t start = (used + align - 1) & ~(align - 1);
+    if (start + size > ARENA_SIZE) return NULL;
+    used = start + size;
+    note_peak();
+    return &storage[start];
+}
+
+CharSlice arena_chars(size_t cap) {
+    CharSlice slice = { NULL, 0, 0 };
+    char* data = (char*)arena_alloc(cap + 1, 1);
+    if (data) {
+        data[0] = '\0';
+        slice.data = data;
+        slice.cap = cap;
+    }
+    return slice;
+}
+
+size_t arena_mark(void) {
+    return used;
+}
+
+void arena_release(size_t mark) {
+    if (mark < used) used = mark;
+}
+
+size_t arena_used(void) {
+    return used;
+}
+
+size_t arena_peak(void) {
+    return peak;
+}
+
+size_t arena_take_peak(void) {
+    size_t result = window_peak;
+    window_peak = used;
+    return result;
+}
@@ -0,0 +1,45 @@
+// Arena estática de la app (arena.c)
+//
+// Toda la memoria de trabajo de una petición (mensaje al Pi, respuesta,
+// textos formateados) sale de un único bloque estático de ARENA_SIZE bytes
+// con asignación lineal. No hay free: se libera en bloque volviendo a una
+// marca (arena_release) o vaciándola al empezar la siguiente petición.
+//
+// Los datos se reciben una sola vez en un CharSlice de la arena y a partir
+// de ahí se manejan con StrView (strview.h), sin copias.
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ARENA_SIZE  2048
+
+// Trozo de la arena con capacidad fija; `data` siempre termina en '\0'
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;     // Sin contar el '\0'
+} CharSlice;
+
+void arena_reset(void);
+void* arena_alloc(size_t size, size_t align);
+
+// Reserva `count` elementos de `type` alineados
+#define ARENA_NEW(type, count) ((type*)arena_alloc(sizeof(type) * (count), __alignof__(type)))
+
+// Slice vacío de `cap` caracteres; cap == 0 si la arena está llena
+CharSlice arena_chars(size_t cap);
+
+size_t arena_mark(void);
+void arena_release(size_t mark);
+
+size_t arena_used(void);
+size_t arena_peak(void);
+
+// Máximo desde la llamada anterior (para muestrear por estado o por frame)
+size_t arena_take_peak(void);
+
+#endif
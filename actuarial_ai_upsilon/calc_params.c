@@ -0,0 +1,250 @@
+// Registro de parámetros de una petición y su edición campo a campo
+
+#include <stdio.h>
+#include <string.h>
+#include "calc_params.h"
+
+#define AGE_MAX      110
+#define TERM_MIN     1
+#define TERM_MAX     60
+#define RATE_MAX_BP  2000
+#define RATE_STEP_BP 25
+#define AMOUNT_MIN   100
+#define AMOUNT_MAX   10000000
+
+static const char* product_names[CALC_PRODUCT_COUNT] = {
+    "Life Insurance Premium",
+    "Annuity Present Value",
+    "Mortality Rate Lookup",
+    "Interest Calculation",
+    "Insurance Reserves"
+};
+
+static const char* table_names[CALC_TABLE_COUNT] = {
+    "2017 CSO",
+    "2001 CSO",
+    "2012 IAM"
+};
+
+// Campos de cada producto (bit = CalcField)
+#define F(field) (1u << (field))
+static const uint8_t product_fields[CALC_PRODUCT_COUNT] = {
+    F(CALC_FIELD_AGE) | F(CALC_FIELD_AMOUNT) | F(CALC_FIELD_TERM) | F(CALC_FIELD_RATE) | F(CALC_FIELD_TABLE),
+    F(CALC_FIELD_AMOUNT) | F(CALC_FIELD_TERM) | F(CALC_FIELD_RATE),
+    F(CALC_FIELD_AGE) | F(CALC_FIELD_TABLE),
+    F(CALC_FIELD_AMOUNT) | F(CALC_FIELD_RATE) | F(CALC_FIELD_TERM),
+    F(CALC_FIELD_AGE) | F(CALC_FIELD_AMOUNT) | F(CALC_FIELD_RATE) | F(CALC_FIELD_TABLE)
+};
+#undef F
+
+void calc_params_defaults(CalcProduct product, CalcParams* params) {
+    // Campos sin usar a cero: los mismos datos dan siempre el mismo registro
+    memset(params, 0, sizeof(*params));
+    params->product = (uint8_t)product;
+    switch (product) {
+        case CALC_TERM_LIFE:
+            params->age = 35;
+            params->amount = 100000;
+            params->term = 20;
+            params->rate_bp = 400;
+            params->table = CALC_TABLE_CSO2017;
+            break;
+        case CALC_ANNUITY_PV:
+            params->amount = 1000;
+            params->term = 20;
+            params->rate_bp = 500;
+            break;
+        case CALC_MORTALITY:
+            params->age = 45;
+            params->table = CALC_TABLE_CSO2017;
+            break;
+        case CALC_COMPOUND:
+            params->amount = 10000;
+            params->rate_bp = 600;
+            params->term = 15;
+            break;
+        case CALC_WHOLE_LIFE_RESERVE:
+            params->age = 30;
+            params->amount = 100000;
+            params->rate_bp = 400;
+            params->table = CALC_TABLE_CSO2017;
+            break;
+        default:
+            break;
+    }
+}
+
+bool calc_field_used(CalcProduct product, CalcField field) {
+    if (product >= CALC_PRODUCT_COUNT || field >= CALC_FIELD_COUNT) return false;
+    return (product_fields[product] >> field) & 1;
+}
+
+const char* calc_field_label(CalcProduct product, CalcField field) {
+    switch (field) {
+        case CALC_FIELD_AGE:    return "Age";
+        case CALC_FIELD_TERM:   return "Term";
+        case CALC_FIELD_RATE:   return "Interest";
+        case CALC_FIELD_TABLE:  return "Table";
+        case CALC_FIELD_AMOUNT:
+            if (product == CALC_ANNUITY_PV) return "Payment/month";
+            if (product == CALC_COMPOUND) return "Principal";
+            return "Sum assured";
+        default:
+            return "";
+    }
+}
+
+// Importe con separador de miles: $100,000
+static void format_amount(uint32_t amount, char* out, size_t size) {
+    char digits[12];
+    int n = snprintf(digits, sizeof(digits), "%lu", (unsigned long)amount);
+    size_t pos = 0;
+    if (pos + 1 < size) out[pos++] = '$';
+    for (int i = 0; i < n && pos + 1 < size; i++) {
+        if (i > 0 && (n - i) % 3 == 0 && pos + 2 < size) out[pos++] = ',';
+        out[pos++] = digits[i];
+    }
+    if (size) out[pos < size ? pos : size - 1] = '\0';
+}
+
+void calc_field_format(const CalcParams* params, CalcField field, char* out, size_t size) {
+    switch (field) {
+        case CALC_FIELD_AGE:
+            snprintf(out, size, "%u", params->age);
+            break;
+        case CALC_FIELD_AMOUNT:
+            format_amount(params->amount, out, size);
+            break;
+        case CALC_FIELD_TERM:
+            snprintf(out, size, "%u years", params->term);
+            break;
+        case CALC_FIELD_RATE:
+            snprintf(out, size, "%u.%02u%%", params->rate_bp / 100, params->rate_bp % 100);
+            break;
+        case CALC_FIELD_TABLE:
+            snprintf(out, size, "%s", calc_table_name((CalcTable)params->table));
+            break;
+        default:
+            if (size) out[0] = '\0';
+            break;
+    }
+}
+
+// Paso proporcional al importe: de 100 en 100 hasta 10.000, luego 1.000...
+static uint32_t amount_step(uint32_t amount, int direction) {
+    uint32_t base = direction > 0 ? amount : amount - 1;
+    if (base < 10000) return 100;
+    if (base < 100000) return 1000;
+    if (base < 1000000) return 10000;
+    return 100000;
+}
+
+void calc_field_step(CalcParams* params, CalcField field, int direction) {
+    if (!calc_field_used((CalcProduct)params->product, field) || direction == 0) return;
+    bool up = direction > 0;
+
+    switch (field) {
+        case CALC_FIELD_AGE:
+            if (up && params->age < AGE_MAX) params->age++;
+            else if (!up && params->age > 0) params->age--;
+            break;
+        case CALC_FIELD_TERM:
+            if (up && params->term < TERM_MAX) params->term++;
+            else if (!up && params->term > TERM_MIN) params->term--;
+            break;
+        case CALC_FIELD_RATE:
+            if (up && params->rate_bp + RATE_STEP_BP <= RATE_MAX_BP) params->rate_bp += RATE_STEP_BP;
+            else if (!up && params->rate_bp >= RATE_STEP_BP) params->rate_bp -= RATE_STEP_BP;
+            break;
+        case CALC_FIELD_AMOUNT: {
+            uint32_t step = amount_step(params->amount, direction);
+            if (up && params->amount + step <= AMOUNT_MAX) params->amount += step;
+            else if (!up && params->amount >= AMOUNT_MIN + step) params->amount -= step;
+            break;
+        }
+        case CALC_FIELD_TABLE:
+            params->table = (uint8_t)((params->table + (up ? 1 : CALC_TABLE_COUNT - 1)) % CALC_TABLE_COUNT);
+            break;
+        default:
+            break;
+    }
+}
+
+const char* calc_product_name(CalcProduct product) {
+    return product < CALC_PRODUCT_COUNT ? product_names[product] : "?";
+}
+
+const char* calc_table_name(CalcTable table) {
+    return table < CALC_TABLE_COUNT ? table_names[table] : "?";
+}
+
+void calc_params_encode(const CalcParams* params, uint8_t record[CALC_RECORD_SIZE]) {
+    record[0] = CALC_RECORD_VERSION;
+    record[1] = params->product;
+    record[2] = params->age;
+    record[3] = params->term;
+    record[4] = params->table;
+    record[5] = 0;
+    record[6] = (uint8_t)(params->rate_bp & 0xFF);
+    record[7] = (uint8_t)(params->rate_bp >> 8);
+    record[8] = (uint8_t)(params->amount & 0xFF);
+    record[9] = (uint8_t)(params->amount >> 8);
+    record[10] = (uint8_t)(params->amount >> 16);
+    record[11] = (uint8_t)(params->amount >> 24);
+}
+
+bool calc_params_decode(const uint8_t record[CALC_RECORD_SIZE], CalcParams* params) {
+    if (record[0] != CALC_RECORD_VERSION) return false;
+    if (record[1] >= CALC_PRODUCT_COUNT || record[4] >= CALC_TABLE_COUNT) return false;
+    params->product = record[1];
+    params->age = record[2];
+    params->term = record[3];
+    params->table = record[4];
+    params->rate_bp = (uint16_t)(record[6] | (record[7] << 8));
+    params->amount = (uint32_t)record[8] | ((uint32_t)record[9] << 8) |
+                     ((uint32_t)record[10] << 16) | ((uint32_t)record[11] << 24);
+    return true;
+}
+
+size_t calc_params_to_message(const CalcParams* params, char* out, size_t size) {
+    static const char hex[] = "0123456789ABCDEF";
+    const size_t prefix = sizeof(CALC_RECORD_PREFIX) - 1;
+    const size_t len = prefix + 2 * CALC_RECORD_SIZE;
+    if (size < len + 1) {
+        if (size) out[0] = '\0';
+        return 0;
+    }
+
+    uint8_t record[CALC_RECORD_SIZE];
+    calc_params_encode(params, record);
+    memcpy(out, CALC_RECORD_PREFIX, prefix);
+    for (size_t i = 0; i < CALC_RECORD_SIZE; i++) {
+        out[prefix + 2 * i] = hex[record[i] >> 4];
+        out[prefix + 2 * i + 1] = hex[record[i] & 0x0F];
+    }
+    out[len] = '\0';
+    return len;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+bool calc_params_from_message(const char* message, size_t len, CalcParams* params) {
+    const size_t prefix = sizeof(CALC_RECORD_PREFIX) - 1;
+    if (len != prefix + 2 * CALC_RECORD_SIZE || memcmp(message, CALC_RECORD_PREFIX, prefix) != 0) {
+        return false;
+    }
+
+    uint8_t record[CALC_RECORD_SIZE];
+    for (size_t i = 0; i < CALC_RECORD_SIZE; i++) {
+        int hi = hex_value(message[prefix + 2 * i]);
+        int lo = hex_value(message[prefix + 2 * i + 1]);
+        if (hi < 0 || lo < 0) return false;
+        record[i] = (uint8_t)(hi << 4 | lo);
+    }
+    return calc_params_decode(record, params);
+}
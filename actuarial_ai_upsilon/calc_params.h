@@ -0,0 +1,85 @@
+// Peticiones con parámetros tipados (calc_params.c)
+//
+// En lugar de una frase en inglés que el Pi tiene que interpretar, cada
+// petición es un registro binario fijo de CALC_RECORD_SIZE bytes con el
+// producto y sus parámetros. Viaja como "PARAMS:<hex>" (24 dígitos): el Pi
+// va directo a la calculadora del producto, y dos peticiones con los mismos
+// parámetros dan exactamente el mismo registro, así que sirve como clave de
+// caché en los dos extremos.
+//
+// Registro (little-endian):
+//   0  versión (CALC_RECORD_VERSION)     6-7   interés en puntos básicos
+//   1  producto (CalcProduct)            8-11  importe en unidades enteras
+//   2  edad (años)                             (capital, pago mensual o
+//   3  plazo (años)                             principal según producto)
+//   4  tabla de mortalidad (CalcTable)
+//   5  reservado (0)
+
+#ifndef CALC_PARAMS_H
+#define CALC_PARAMS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CALC_RECORD_VERSION  1
+#define CALC_RECORD_SIZE     12
+#define CALC_RECORD_PREFIX   "PARAMS:"
+
+typedef enum {
+    CALC_TERM_LIFE,         // Prima de seguro temporal
+    CALC_ANNUITY_PV,        // Valor actual de una renta mensual
+    CALC_MORTALITY,         // q(x) de la tabla
+    CALC_COMPOUND,          // Interés compuesto
+    CALC_WHOLE_LIFE_RESERVE,
+    CALC_PRODUCT_COUNT
+} CalcProduct;
+
+typedef enum {
+    CALC_TABLE_CSO2017,
+    CALC_TABLE_CSO2001,
+    CALC_TABLE_IAM2012,
+    CALC_TABLE_COUNT
+} CalcTable;
+
+typedef enum {
+    CALC_FIELD_AGE,
+    CALC_FIELD_AMOUNT,
+    CALC_FIELD_TERM,
+    CALC_FIELD_RATE,
+    CALC_FIELD_TABLE,
+    CALC_FIELD_COUNT
+} CalcField;
+
+typedef struct {
+    uint8_t product;
+    uint8_t age;
+    uint8_t term;
+    uint8_t table;
+    uint16_t rate_bp;       // 500 = 5.00%
+    uint32_t amount;
+} CalcParams;
+
+void calc_params_defaults(CalcProduct product, CalcParams* params);
+
+// Campos que usa el producto, en orden de pantalla
+bool calc_field_used(CalcProduct product, CalcField field);
+const char* calc_field_label(CalcProduct product, CalcField field);
+void calc_field_format(const CalcParams* params, CalcField field, char* out, size_t size);
+
+// Sube (direction > 0) o baja el campo un paso, dentro de su rango
+void calc_field_step(CalcParams* params, CalcField field, int direction);
+
+const char* calc_product_name(CalcProduct product);
+const char* calc_table_name(CalcTable table);
+
+void calc_params_encode(const CalcParams* params, uint8_t record[CALC_RECORD_SIZE]);
+// false si la versión, el producto o la tabla no son válidos
+bool calc_params_decode(const uint8_t record[CALC_RECORD_SIZE], CalcParams* params);
+
+// "PARAMS:" + registro en hexadecimal; devuelve la longitud (sin '\0')
+size_t calc_params_to_message(const CalcParams* params, char* out, size_t size);
+// Inverso, para el lado del Pi y el host
+bool calc_params_from_message(const char* message, size_t len, CalcParams* params);
+
+#endif
@@ -0,0 +1,360 @@
+// Compositor por bandas: sólo se envía al LCD lo que cambió
+
+#include <extapp_api.h>
+#include <string.h>
+#include "compositor.h"
+#include "text_cache.h"
+#include "profiler.h"
+
+#define BAND_COUNT  ((LCD_HEIGHT + COMPOSITOR_BAND_HEIGHT - 1) / COMPOSITOR_BAND_HEIGHT)
+
+typedef enum {
+    ITEM_FILL,
+    ITEM_TEXT,
+    ITEM_STATIC
+} ItemKind;
+
+typedef struct {
+    uint8_t kind;
+    bool large;
+    int16_t x, y;
+    int16_t w, h;
+    uint16_t fg;            // Color del relleno o del texto
+    uint16_t bg;
+    uint16_t text;          // Desplazamiento en text_pool
+    uint32_t hash;
+} Item;
+
+static uint16_t band[LCD_WIDTH * COMPOSITOR_BAND_HEIGHT];
+
+static Item items[COMPOSITOR_MAX_ITEMS];
+static uint32_t item_count;
+static char text_pool[COMPOSITOR_TEXT_POOL];
+static uint32_t text_used;
+static uint16_t background;
+
+// Lo que quedó en el LCD tras el último frame
+static uint32_t band_hash[BAND_COUNT];
+static uint32_t shown_hash[COMPOSITOR_MAX_ITEMS];
+static uint32_t shown_count;
+static bool valid;
+static CompositorLayer layer;
+
+static bool enabled = true;
+static CompositorStats stats;
+
+static uint32_t fnv(uint32_t hash, const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t item_hash(const Item* it) {
+    uint32_t hash = 2166136261u;
+    hash = fnv(hash, &it->kind, sizeof(it->kind));
+    hash = fnv(hash, &it->x, sizeof(it->x));
+    hash = fnv(hash, &it->y, sizeof(it->y));
+    hash = fnv(hash, &it->w, sizeof(it->w));
+    hash = fnv(hash, &it->h, sizeof(it->h));
+    hash = fnv(hash, &it->fg, sizeof(it->fg));
+    hash = fnv(hash, &it->bg, sizeof(it->bg));
+    if (it->kind != ITEM_FILL) {
+        const char* text = &text_pool[it->text];
+        hash = fnv(hash, text, strlen(text));
+    }
+    return hash;
+}
+
+static void draw_direct(const Item* it) {
+    const char* text = &text_pool[it->text];
+    switch (it->kind) {
+        case ITEM_FILL:
+            extapp_pushRectUniform(it->x, it->y, it->w, it->h, it->fg);
+            break;
+        case ITEM_STATIC:
+            if (it->large) text_cache_draw_large(text, it->x, it->y, it->fg, it->bg);
+            else text_cache_draw_small(text, it->x, it->y, it->fg, it->bg);
+            break;
+        default:
+            if (it->large) extapp_drawTextLarge(text, it->x, it->y, it->fg, it->bg, false);
+            else extapp_drawTextSmall(text, it->x, it->y, it->fg, it->bg, false);
+            break;
+    }
+}
+
+static Item* add_item(ItemKind kind, int16_t x, int16_t y, uint16_t fg, uint16_t bg) {
+    if (item_count == COMPOSITOR_MAX_ITEMS) {
+        stats.dropped_items++;
+        return NULL;
+    }
+    Item* it = &items[item_count];
+    it->kind = (uint8_t)kind;
+    it->x = x;
+    it->y = y;
+    it->fg = fg;
+    it->bg = bg;
+    it->text = 0;
+    return it;
+}
+
+static void add_text(ItemKind kind, bool large, const char* text, size_t len, int16_t x, int16_t y,
+                     uint16_t fg, uint16_t bg) {
+    Item* it = add_item(kind, x, y, fg, bg);
+    if (!it) return;
+    if (text_used + len + 1 > COMPOSITOR_TEXT_POOL) {
+        stats.dropped_items++;
+        return;
+    }
+
+    char* copy = &text_pool[text_used];
+    memcpy(copy, text, len);
+    copy[len] = '\0';
+    it->text = (uint16_t)text_used;
+    text_used += (uint32_t)(len + 1);
+    it->large = large;
+    it->h = large ? TEXT_LARGE_HEIGHT : TEXT_SMALL_HEIGHT;
+    // Medir sin dibujar
+    int16_t end = large ? extapp_drawTextLarge(copy, x, y, fg, bg, true)
+                        : extapp_drawTextSmall(copy, x, y, fg, bg, true);
+    it->w = (int16_t)(end - x);
+    it->hash = item_hash(it);
+    item_count++;
+
+    if (!enabled) draw_direct(it);
+}
+
+void compositor_begin(uint16_t bg) {
+    // Entre frames, y con el compositor desactivado, la banda no se usa
+    text_cache_set_scratch(band, LCD_WIDTH * COMPOSITOR_BAND_HEIGHT);
+    item_count = 0;
+    text_used = 0;
+    background = bg;
+    if (!enabled) extapp_pushRectUniform(0, 0, LCD_WIDTH, LCD_HEIGHT, bg);
+}
+
+void compositor_fill(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    Item* it = add_item(ITEM_FILL, x, y, color, color);
+    if (!it) return;
+    it->w = (int16_t)w;
+    it->h = (int16_t)h;
+    it->large = false;
+    it->hash = item_hash(it);
+    item_count++;
+
+    if (!enabled) draw_direct(it);
+}
+
+void compositor_text_small(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg) {
+    add_text(ITEM_TEXT, false, text, strlen(text), x, y, fg, bg);
+}
+
+void compositor_text_large(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg) {
+    add_text(ITEM_TEXT, true, text, strlen(text), x, y, fg, bg);
+}
+
+void compositor_view_small(StrView text, int16_t x, int16_t y, uint16_t fg, uint16_t bg) {
+    add_text(ITEM_TEXT, false, text.ptr, text.len, x, y, fg, bg);
+}
+
+void compositor_static_small(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg) {
+    add_text(ITEM_STATIC, false, text, strlen(text), x, y, fg, bg);
+}
+
+void compositor_static_large(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg) {
+    add_text(ITEM_STATIC, true, text, strlen(text), x, y, fg, bg);
+}
+
+static bool was_shown(uint32_t hash) {
+    for (uint32_t i = 0; i < shown_count; i++) {
+        if (shown_hash[i] == hash) return true;
+    }
+    return false;
+}
+
+static bool intersects(const Item* it, int y0, int y1) {
+    return it->y < y1 && it->y + it->h > y0 && it->w > 0 && it->h > 0;
+}
+
+static bool overlaps(const Item* a, const Item* b) {
+    return a->x < b->x + b->w && b->x < a->x + a->w && intersects(a, b->y, b->y + b->h);
+}
+
+// Textos dinámicos de la banda en curso cuyos píxeles se leyeron del LCD,
+// en orden de la lista: lo que va debajo no los pisa
+static const Item* kept[COMPOSITOR_MAX_ITEMS];
+static uint32_t kept_count;
+
+// Rellena [x0, x1) de una fila sin tocar los textos conservados desde `first`
+static void fill_span(uint16_t* dst, int row, int x0, int x1, uint16_t color, uint32_t first) {
+    for (uint32_t k = first; k < kept_count && x0 < x1; k++) {
+        const Item* t = kept[k];
+        if (row < t->y || row >= t->y + t->h || t->x >= x1 || t->x + t->w <= x0) continue;
+        fill_span(dst, row, x0, t->x, color, k + 1);
+        x0 = t->x + t->w;
+    }
+    for (int col = x0; col < x1; col++) dst[col] = color;
+}
+
+// `first`: primer texto conservado que va encima de lo que se rellena
+static void fill_rows(int x, int w, int row0, int row1, int y0, uint16_t color, uint32_t first) {
+    if (x < 0) { w += x; x = 0; }
+    if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
+    if (w <= 0) return;
+    for (int row = row0; row < row1; row++) {
+        fill_span(&band[(row - y0) * LCD_WIDTH], row, x, x + w, color, first);
+    }
+}
+
+// Compone un ítem en la banda [y0, y1). Devuelve true si hay que dibujarlo
+// encima después de enviar la banda.
+static bool compose_item(const Item* it, int y0, int y1, uint32_t first) {
+    int row0 = it->y > y0 ? it->y : y0;
+    int row1 = it->y + it->h < y1 ? it->y + it->h : y1;
+    int x = it->x, w = it->w;
+
+    if (it->kind == ITEM_FILL) {
+        fill_rows(x, w, row0, row1, y0, it->fg, first);
+        return false;
+    }
+
+    if (it->kind == ITEM_STATIC) {
+        if (x >= 0 && text_cache_blit(&text_pool[it->text], it->large, it->fg, it->bg, row0 - it->y, row1 - row0,
+                                      &band[(row0 - y0) * LCD_WIDTH + x], LCD_WIDTH, (uint16_t)(LCD_WIDTH - x))) {
+            return false;
+        }
+    } else if (first > 0 && kept[first - 1] == it) {
+        return false;       // Ya está en la banda
+    }
+
+    fill_rows(x, w, row0, row1, y0, it->bg, first);
+    return true;
+}
+
+// Un texto dinámico se conserva si ningún texto fijo anterior lo pisa (el
+// sprite se copia por filas enteras, sin recortes)
+static bool can_keep(uint32_t index, int y0, int y1) {
+    const Item* it = &items[index];
+    if (it->kind != ITEM_TEXT || !intersects(it, y0, y1) || it->x >= LCD_WIDTH || it->x + it->w <= 0) return false;
+    for (uint32_t i = 0; i < index; i++) {
+        if (items[i].kind == ITEM_STATIC && overlaps(&items[i], it)) return false;
+    }
+    return true;
+}
+
+// Lee del LCD, con un solo pullRect, el rectángulo que cubre los textos
+// dinámicos de la banda. Los que cambiaron se dibujan antes en su sitio: así
+// la banda sale ya con ellos y el LCD nunca los muestra en blanco.
+static void keep_texts(int y0, int y1, bool* drawn) {
+    int x0 = LCD_WIDTH, x1 = 0, row0 = y1, row1 = y0;
+    kept_count = 0;
+    for (uint32_t i = 0; i < item_count; i++) {
+        if (!can_keep(i, y0, y1)) continue;
+        const Item* it = &items[i];
+        if (!drawn[i]) {
+            if (valid && was_shown(it->hash)) {
+                stats.preserved_texts++;
+            } else {
+                draw_direct(it);
+            }
+            drawn[i] = true;
+        }
+        kept[kept_count++] = it;
+        if (it->x < x0) x0 = it->x;
+        if (it->x + it->w > x1) x1 = it->x + it->w;
+        if (it->y < row0) row0 = it->y;
+        if (it->y + it->h > row1) row1 = it->y + it->h;
+    }
+    if (kept_count == 0) return;
+    if (x0 < 0) x0 = 0;
+    if (x1 > LCD_WIDTH) x1 = LCD_WIDTH;
+    if (row0 < y0) row0 = y0;
+    if (row1 > y1) row1 = y1;
+
+    // Llega seguido desde su primera fila; se reparte de la última a la
+    // primera, y cada fila sólo se mueve hacia delante. Lo que queda entre
+    // medias lo tapan el fondo y los ítems.
+    int w = x1 - x0;
+    uint16_t* start = &band[(row0 - y0) * LCD_WIDTH + x0];
+    extapp_pullRect((int16_t)x0, (int16_t)row0, (uint16_t)w, (uint16_t)(row1 - row0), start);
+    for (int row = row1 - row0 - 1; row > 0; row--) {
+        memmove(&start[row * LCD_WIDTH], &start[row * w], (size_t)w * sizeof(uint16_t));
+    }
+}
+
+void compositor_end(void) {
+    static bool overlay[COMPOSITOR_MAX_ITEMS];
+    static bool drawn[COMPOSITOR_MAX_ITEMS];
+
+    if (layer) layer();
+    stats.frames++;
+    if (!enabled) return;
+
+    ProfMark mark = profiler_begin();
+
+    memset(overlay, 0, sizeof(overlay));
+    memset(drawn, 0, sizeof(drawn));
+    for (int b = 0; b < BAND_COUNT; b++) {
+        int y0 = b * COMPOSITOR_BAND_HEIGHT;
+        int y1 = y0 + COMPOSITOR_BAND_HEIGHT > LCD_HEIGHT ? LCD_HEIGHT : y0 + COMPOSITOR_BAND_HEIGHT;
+
+        uint32_t hash = fnv(2166136261u, &background, sizeof(background));
+        for (uint32_t i = 0; i < item_count; i++) {
+            if (intersects(&items[i], y0, y1)) hash = fnv(hash, &items[i].hash, sizeof(items[i].hash));
+        }
+        if (valid && hash == band_hash[b]) {
+            stats.bands_skipped++;
+            continue;
+        }
+
+        keep_texts(y0, y1, drawn);
+        fill_rows(0, LCD_WIDTH, y0, y1, y0, background, 0);
+        uint32_t first = 0;
+        for (uint32_t i = 0; i < item_count; i++) {
+            if (first < kept_count && kept[first] == &items[i]) first++;
+            if (intersects(&items[i], y0, y1) && compose_item(&items[i], y0, y1, first)) overlay[i] = true;
+        }
+        extapp_pushRect(0, (int16_t)y0, LCD_WIDTH, (uint16_t)(y1 - y0), band);
+        band_hash[b] = hash;
+        stats.bands_pushed++;
+    }
+
+    // Textos sin sprite que no se pudieron conservar, encima de las bandas
+    // ya enviadas (en orden)
+    for (uint32_t i = 0; i < item_count; i++) {
+        if (!overlay[i]) continue;
+        draw_direct(&items[i]);
+        stats.overlay_texts++;
+    }
+
+    // Sólo cuenta como mostrado lo que ningún ítem posterior tapó (p. ej. la
+    // capa del perfilador): si no, se conservarían píxeles de la capa
+    shown_count = 0;
+    for (uint32_t i = 0; i < item_count; i++) {
+        bool covered = false;
+        for (uint32_t j = i + 1; j < item_count && !covered; j++) {
+            covered = overlaps(&items[i], &items[j]);
+        }
+        if (!covered) shown_hash[shown_count++] = items[i].hash;
+    }
+    valid = true;
+    profiler_end(PROF_PRESENT, mark);
+}
+
+void compositor_set_layer(CompositorLayer draw) {
+    layer = draw;
+}
+
+void compositor_invalidate(void) {
+    valid = false;
+}
+
+void compositor_set_enabled(bool on) {
+    enabled = on;
+    valid = false;
+}
+
+void compositor_get_stats(CompositorStats* out) {
+    *out = stats;
+}
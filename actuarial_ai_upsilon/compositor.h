@@ -0,0 +1,65 @@
+// Compositor por bandas (compositor.c)
+//
+// Cada pantalla se describe entre compositor_begin() y compositor_end() como
+// una lista de rectángulos y textos. Al terminar, la pantalla se recorre en
+// bandas de COMPOSITOR_BAND_HEIGHT filas: sólo las bandas cuyo contenido
+// cambió respecto al frame anterior se componen en un buffer fuera de
+// pantalla y se envían con un único extapp_pushRect. No hay borrado previo
+// del LCD, así que no aparece el frame en blanco intermedio.
+//
+// Los textos fijos salen de text_cache. El resto (p. ej. el RTT) no se puede
+// rasterizar fuera del LCD: si cambió se dibuja primero en su sitio, y
+// luego el rectángulo que ocupan en la banda se lee con un solo pullRect
+// antes de componer el resto alrededor. La banda sale ya con el texto, así que no
+// parpadea ni al repintarla ni al cambiar el texto.
+
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "strview.h"
+
+#define COMPOSITOR_BAND_HEIGHT  16
+#define COMPOSITOR_MAX_ITEMS    64
+#define COMPOSITOR_TEXT_POOL    2048    // Copia de los textos de un frame
+
+typedef struct {
+    uint32_t frames;
+    uint32_t bands_pushed;
+    uint32_t bands_skipped;     // Sin cambios: no se tocó el LCD
+    uint32_t overlay_texts;     // Textos dibujados directamente sobre la banda
+    uint32_t preserved_texts;   // Textos dinámicos sin cambios: sólo se leen del LCD
+    uint32_t dropped_items;     // No cabían en la lista del frame
+} CompositorStats;
+
+void compositor_begin(uint16_t background);
+void compositor_fill(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color);
+
+// Texto que cambia entre frames
+void compositor_text_small(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg);
+void compositor_text_large(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg);
+
+// Trozo de un texto más largo, sin copiarlo aparte ni terminarlo en '\0'
+void compositor_view_small(StrView text, int16_t x, int16_t y, uint16_t fg, uint16_t bg);
+
+// Texto fijo: se guarda como sprite en text_cache
+void compositor_static_small(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg);
+void compositor_static_large(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg);
+
+void compositor_end(void);
+
+// Capa que se añade al final de cada frame, encima de la pantalla (p. ej.
+// la superposición del perfilador); NULL la quita
+typedef void (*CompositorLayer)(void);
+void compositor_set_layer(CompositorLayer layer);
+
+// Olvida lo que hay en el LCD: el próximo frame se envía completo
+void compositor_invalidate(void);
+
+// Desactivado, cada primitiva se dibuja al momento tras borrar la pantalla
+// (comportamiento anterior, para comparar en el host)
+void compositor_set_enabled(bool enabled);
+void compositor_get_stats(CompositorStats* stats);
+
+#endif
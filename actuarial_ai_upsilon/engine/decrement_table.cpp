@@ -0,0 +1,165 @@
+// Tablas de decrementos: validación, consultas y construcción del bloque
+
+#include <cstring>
+#include "decrement_table.h"
+
+namespace actuarial {
+
+static const char kMagic[4] = { 'A', 'C', 'T', 'B' };
+
+static size_t align4(size_t offset) {
+    return (offset + 3) & ~(size_t)3;
+}
+
+// Posición de cada sección; la comparten attach() y write()
+struct TableLayout {
+    size_t tables;
+    size_t decrements;
+    size_t slots;
+    size_t columns;
+    size_t end;
+};
+
+static TableLayout layout(int table_count, int decrement_count, int slot_count, int column_count, int ages) {
+    TableLayout l;
+    l.tables = align4(sizeof(TableFileHeader));
+    l.decrements = l.tables + table_count * sizeof(TableEntry);
+    l.slots = l.decrements + decrement_count * sizeof(DecrementEntry);
+    l.columns = align4(l.slots + slot_count * sizeof(uint16_t));
+    l.end = l.columns + (size_t)column_count * ages * sizeof(float);
+    return l;
+}
+
+TableSet::TableSet() : ages_(0), tables_(0), decrements_(0), slots_(0), columns_(0) {
+    std::memset(&header_, 0, sizeof(header_));
+}
+
+bool TableSet::attach(const void* data, size_t size) {
+    const uint8_t* base = static_cast<const uint8_t*>(data);
+    TableFileHeader h;
+    if (!data || ((uintptr_t)base & 3) || size < sizeof(h)) return false;
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kTableFileVersion) return false;
+    if (h.min_age > h.max_age || h.max_age > kMaxAge || h.size > size) return false;
+
+    const int ages = h.max_age - h.min_age + 1;
+    const TableLayout l = layout(h.table_count, h.decrement_count, h.slot_count, h.column_count, ages);
+    if (l.end != h.size) return false;
+
+    const TableEntry* tables = reinterpret_cast<const TableEntry*>(base + l.tables);
+    const DecrementEntry* decrements = reinterpret_cast<const DecrementEntry*>(base + l.decrements);
+    const uint16_t* slots = reinterpret_cast<const uint16_t*>(base + l.slots);
+    for (int t = 0; t < h.table_count; t++) {
+        if (tables[t].decrement_count == 0 ||
+            tables[t].first_decrement + tables[t].decrement_count > h.decrement_count) return false;
+    }
+    for (int d = 0; d < h.decrement_count; d++) {
+        if (decrements[d].select_years > kMaxSelectYears ||
+            decrements[d].first_slot + decrements[d].select_years + 1 > h.slot_count) return false;
+    }
+    for (int s = 0; s < h.slot_count; s++) {
+        if (slots[s] >= h.column_count) return false;
+    }
+
+    header_ = h;
+    ages_ = ages;
+    tables_ = tables;
+    decrements_ = decrements;
+    slots_ = slots;
+    columns_ = reinterpret_cast<const float*>(base + l.columns);
+    return true;
+}
+
+double TableSet::total(int table, int issue_age, int duration) const {
+    double sum = 0.0;
+    for (int d = 0; d < tables_[table].decrement_count; d++) sum += q(table, d, issue_age, duration);
+    return sum < 1.0 ? sum : 1.0;
+}
+
+void TableSet::fill_in_force(int table, int issue_age, int years, double* surv) const {
+    surv[0] = 1.0;
+    for (int k = 0; k < years; k++) surv[k + 1] = surv[k] * (1.0 - total(table, issue_age, k));
+}
+
+TableSetBuilder::TableSetBuilder(int min_age, int max_age)
+    : min_age_(min_age), ages_(max_age - min_age + 1), table_count_(0), decrement_count_(0),
+      slot_count_(0), column_count_(0), failed_(min_age < 0 || max_age > kMaxAge || min_age > max_age) {
+}
+
+bool TableSetBuilder::begin_table() {
+    if (failed_ || table_count_ == kMaxTables) return false;
+    TableEntry& t = tables_[table_count_++];
+    t.first_decrement = (uint16_t)decrement_count_;
+    t.decrement_count = 0;
+    t.reserved = 0;
+    return true;
+}
+
+// Índice de una columna igual ya guardada o de una nueva. La comparación
+// es sobre los float que se escriben: dos columnas que sólo difieren por
+// debajo de la precisión del formato se comparten.
+int TableSetBuilder::add_column(const double* values) {
+    float column[kAges];
+    for (int a = 0; a < ages_; a++) column[a] = (float)values[a];
+    for (int c = 0; c < column_count_; c++) {
+        if (std::memcmp(columns_[c], column, ages_ * sizeof(float)) == 0) return c;
+    }
+    if (column_count_ == kMaxColumns) return -1;
+    std::memcpy(columns_[column_count_], column, ages_ * sizeof(float));
+    return column_count_++;
+}
+
+bool TableSetBuilder::add_decrement(DecrementKind kind, int select_years, const double* const* columns) {
+    if (failed_ || table_count_ == 0 || decrement_count_ == kMaxDecrements ||
+        select_years < 0 || select_years > kMaxSelectYears || slot_count_ + select_years + 1 > kMaxSlots) {
+        failed_ = true;
+        return false;
+    }
+    DecrementEntry& d = decrements_[decrement_count_++];
+    d.first_slot = (uint16_t)slot_count_;
+    d.select_years = (uint8_t)select_years;
+    d.kind = (uint8_t)kind;
+    for (int s = 0; s <= select_years; s++) {
+        const int column = add_column(columns[s]);
+        if (column < 0) {
+            failed_ = true;
+            return false;
+        }
+        slots_[slot_count_++] = (uint16_t)column;
+    }
+    tables_[table_count_ - 1].decrement_count++;
+    return true;
+}
+
+size_t TableSetBuilder::size() const {
+    return layout(table_count_, decrement_count_, slot_count_, column_count_, ages_).end;
+}
+
+size_t TableSetBuilder::write(void* out, size_t capacity) const {
+    const TableLayout l = layout(table_count_, decrement_count_, slot_count_, column_count_, ages_);
+    if (failed_ || table_count_ == 0 || l.end > capacity) return 0;
+
+    uint8_t* base = static_cast<uint8_t*>(out);
+    std::memset(base, 0, l.end);
+    TableFileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kTableFileVersion;
+    h.min_age = (uint8_t)min_age_;
+    h.max_age = (uint8_t)(min_age_ + ages_ - 1);
+    h.table_count = (uint8_t)table_count_;
+    h.decrement_count = (uint8_t)decrement_count_;
+    h.slot_count = (uint16_t)slot_count_;
+    h.column_count = (uint16_t)column_count_;
+    h.size = (uint32_t)l.end;
+    std::memcpy(base, &h, sizeof(h));
+    std::memcpy(base + l.tables, tables_, table_count_ * sizeof(TableEntry));
+    std::memcpy(base + l.decrements, decrements_, decrement_count_ * sizeof(DecrementEntry));
+    std::memcpy(base + l.slots, slots_, slot_count_ * sizeof(uint16_t));
+    for (int c = 0; c < column_count_; c++) {
+        std::memcpy(base + l.columns + (size_t)c * ages_ * sizeof(float), columns_[c], ages_ * sizeof(float));
+    }
+    return l.end;
+}
+
+}  // namespace actuarial
@@ -0,0 +1,161 @@
+// Tablas select-y-última y de decrementos múltiples en formato compacto
+// (engine/decrement_table.cpp)
+//
+// Un bloque contiene varias tablas. Cada tabla tiene uno o más decrementos
+// (fallecimiento, caída, invalidez...) y cada decremento tiene su periodo
+// select: una columna por duración select, indexada por edad de entrada, y
+// la última, indexada por edad alcanzada. Las columnas van en un fondo
+// común sin repetidos: si el fallecimiento de una tabla de decrementos
+// múltiples es la mortalidad de otra tabla del bloque, sus columnas se
+// guardan una sola vez.
+//
+//   cabecera   TableFileHeader (20 bytes)
+//   tablas     TableEntry[table_count]
+//   decrem.    DecrementEntry[decrement_count]
+//   índices    uint16_t[slot_count]     columna de cada duración
+//   columnas   float[column_count][max_age - min_age + 1]
+//
+// Little-endian y alineado a 4 bytes: el bloque se usa tal cual desde
+// flash en el dispositivo o desde un fichero mapeado (mmap) en el host, sin
+// copiarlo. attach() valida todos los índices una vez, así que cada
+// consulta son tres lecturas y ninguna comprobación.
+
+#ifndef ENGINE_DECREMENT_TABLE_H
+#define ENGINE_DECREMENT_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "mortality.h"
+
+namespace actuarial {
+
+enum DecrementKind {
+    DECREMENT_DEATH,
+    DECREMENT_LAPSE,
+    DECREMENT_DISABILITY,
+    DECREMENT_OTHER
+};
+
+struct TableFileHeader {
+    char magic[4];              // "ACTB"
+    uint16_t version;
+    uint16_t flags;             // Reservado, 0
+    uint8_t min_age;
+    uint8_t max_age;
+    uint8_t table_count;
+    uint8_t decrement_count;
+    uint16_t slot_count;
+    uint16_t column_count;
+    uint32_t size;              // Bytes del bloque completo
+};
+
+struct TableEntry {
+    uint16_t first_decrement;
+    uint8_t decrement_count;
+    uint8_t reserved;
+};
+
+struct DecrementEntry {
+    uint16_t first_slot;        // select_years + 1 índices: duraciones y última
+    uint8_t select_years;
+    uint8_t kind;               // DecrementKind
+};
+
+const uint16_t kTableFileVersion = 1;
+const int kMaxSelectYears = 15;
+
+// Vista de solo lectura sobre un bloque; no copia nada
+class TableSet {
+public:
+    TableSet();
+
+    // Valida el bloque; false si está truncado, mal alineado o tiene
+    // índices fuera de rango
+    bool attach(const void* data, size_t size);
+
+    int table_count() const { return header_.table_count; }
+    int decrement_count(int table) const { return tables_[table].decrement_count; }
+    DecrementKind kind(int table, int decrement) const {
+        return (DecrementKind)entry(table, decrement).kind;
+    }
+    int min_age() const { return header_.min_age; }
+    int max_age() const { return header_.max_age; }
+    size_t size() const { return header_.size; }
+    int column_count() const { return header_.column_count; }
+    int slot_count() const { return header_.slot_count; }
+
+    // q del decremento para una póliza con edad de entrada `issue_age` en
+    // el año `duration`; la edad alcanzada se limita a max_age
+    float q(int table, int decrement, int issue_age, int duration) const {
+        const DecrementEntry& d = entry(table, decrement);
+        const int select = duration < d.select_years;
+        int age = select ? issue_age : issue_age + duration;
+        if (age > header_.max_age) age = header_.max_age;
+        const int slot = select ? duration : d.select_years;
+        return columns_[slots_[d.first_slot + slot] * ages_ + age - header_.min_age];
+    }
+
+    // Probabilidad de salida por cualquier decremento
+    double total(int table, int issue_age, int duration) const;
+
+    // surv[k] = probabilidad de seguir en vigor k años después de la
+    // entrada (rejilla anual, para Basis con Annual)
+    void fill_in_force(int table, int issue_age, int years, double* surv) const;
+
+private:
+    const DecrementEntry& entry(int table, int decrement) const {
+        return decrements_[tables_[table].first_decrement + decrement];
+    }
+
+    TableFileHeader header_;
+    int ages_;
+    const TableEntry* tables_;
+    const DecrementEntry* decrements_;
+    const uint16_t* slots_;
+    const float* columns_;
+};
+
+// Construcción del bloque (host o arranque): reúne las columnas, elimina
+// las repetidas y escribe el formato anterior
+class TableSetBuilder {
+public:
+    static const int kMaxTables = 8;
+    static const int kMaxDecrements = 16;
+    static const int kMaxSlots = 64;
+    static const int kMaxColumns = 48;
+    static const int kAges = kMaxAge + 1;
+
+    TableSetBuilder(int min_age, int max_age);
+
+    // Abre una tabla nueva; los decrementos siguientes son suyos
+    bool begin_table();
+    // columns[s] para s = 0..select_years: las select por edad de entrada
+    // y la última por edad alcanzada, cada una desde min_age hasta max_age
+    bool add_decrement(DecrementKind kind, int select_years, const double* const* columns);
+
+    size_t size() const;
+    // Bytes escritos, o 0 si `capacity` no alcanza
+    size_t write(void* out, size_t capacity) const;
+
+    int columns_referenced() const { return slot_count_; }
+    int columns_stored() const { return column_count_; }
+
+private:
+    int add_column(const double* values);
+
+    int min_age_;
+    int ages_;
+    int table_count_;
+    int decrement_count_;
+    int slot_count_;
+    int column_count_;
+    bool failed_;
+    TableEntry tables_[kMaxTables];
+    DecrementEntry decrements_[kMaxDecrements];
+    uint16_t slots_[kMaxSlots];
+    float columns_[kMaxColumns][kAges];
+};
+
+}  // namespace actuarial
+
+#endif
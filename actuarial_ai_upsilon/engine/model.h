@@ -0,0 +1,214 @@
+// Modelo de valoración con recálculo incremental (engine/model.h)
+//
+// Guarda los resultados intermedios de un seguro temporal por etapas, cada
+// una con sus dependencias:
+//
+//   edad, ley  --> supervivencia --+
+//                                  +--> conmutados --> resultados
+//   tipo/curva --> descuento ------+         ^             ^
+//   plazo  ----------------------------------+             |
+//   capital  ----------------------------------------------+
+//
+// Cambiar un supuesto sólo marca como sucias las etapas que dependen de él;
+// results() rehace esas y reutiliza el resto. "¿Y al 4% en vez del 5%?"
+// no vuelve a calcular la supervivencia, y cambiar el capital sólo escala.
+// Los vectores se guardan hasta el plazo más largo pedido: acortar el plazo
+// sólo rehace los conmutados. Con set_curve() el descuento sale de la tabla
+// de la curva en lugar del tipo plano.
+//
+// Los conmutados son sumas acumuladas desde el final (N para rentas, M para
+// seguros): con ellos la renta, el seguro y la reserva en cualquier
+// duración salen en O(1), así que el vector de reservas completo es O(n).
+// Sólo frecuencias Mthly<M>.
+//
+// Sólo para el host (benchmarks y herramientas): cada modelo guarda cinco
+// vectores de kMaxAge * kSteps + 1 doubles, unos 57 KB con Monthly y 6 KB
+// con Annual, muy por encima de la arena (2 KB) y de la pila del
+// dispositivo. La app no lo enlaza; su tabla de primas sale de
+// premium_schedule.h.
+
+#ifndef ENGINE_MODEL_H
+#define ENGINE_MODEL_H
+
+#include <cmath>
+#include "valuation.h"
+
+namespace actuarial {
+
+struct ModelStageCounts {
+    unsigned survival;
+    unsigned discount;
+    unsigned commutation;
+    unsigned results;
+};
+
+struct ModelResults {
+    double annuity;             // ä (o a) por unidad, anualizada
+    double insurance;           // A¹ por unidad de capital
+    double premium;             // Prima anual para el capital
+    double reserve[kMaxAge + 1];    // Reserva al inicio de cada año, para el capital
+    int years;
+};
+
+// Renta desde el paso k: N[k] / D[k] (Due) o desplazada un paso (Immediate)
+template <int M, class Timing> struct ModelAnnuity;
+
+template <int M> struct ModelAnnuity<M, Due> {
+    static double value(const double* n, const double* d, int k, int) {
+        return n[k] / d[k] / M;
+    }
+};
+
+template <int M> struct ModelAnnuity<M, Immediate> {
+    static double value(const double* n, const double* d, int k, int end) {
+        return (n[k] - d[k] + d[end]) / d[k] / M;
+    }
+};
+
+template <class Freq, class Timing>
+class ValuationModel {
+public:
+    static const int kSteps = Freq::kSteps;
+    static const int kMaxPoints = kMaxAge * kSteps + 1;
+
+    ValuationModel()
+        : law_(kStandardUltimate), age_(35), years_(20), rate_(0.05), sum_assured_(1.0), curve_(0),
+          surv_years_(0), disc_years_(0),
+          dirty_survival_(true), dirty_discount_(true), dirty_commutation_(true), dirty_results_(true) {
+        counts_.survival = counts_.discount = counts_.commutation = counts_.results = 0;
+    }
+
+    void set_law(const MakehamLaw& law) {
+        law_ = law;
+        dirty_survival_ = true;
+    }
+    void set_age(int age) {
+        if (age == age_) return;
+        age_ = age;
+        dirty_survival_ = true;
+    }
+    void set_years(int years) {
+        if (years > kMaxAge) years = kMaxAge;
+        if (years == years_) return;
+        years_ = years;
+        dirty_commutation_ = true;
+    }
+    void set_rate(double rate) {
+        if (rate == rate_) return;
+        rate_ = rate;
+        dirty_discount_ = true;
+    }
+    // Descuento desde una curva (0 vuelve al tipo plano); la curva debe
+    // seguir viva y, si se reconstruye, hay que volver a llamar a set_curve()
+    void set_curve(const YieldCurve* curve) {
+        curve_ = curve;
+        dirty_discount_ = true;
+    }
+    void set_sum_assured(double sum_assured) {
+        if (sum_assured == sum_assured_) return;
+        sum_assured_ = sum_assured;
+        dirty_results_ = true;
+    }
+
+    // Todo sucio: la siguiente valoración es completa
+    void invalidate() {
+        dirty_survival_ = dirty_discount_ = dirty_commutation_ = dirty_results_ = true;
+    }
+
+    const ModelResults& results() {
+        // Un plazo más largo que el de los vectores también los invalida
+        if (dirty_survival_ || years_ > surv_years_) {
+            surv_years_ = years_ > surv_years_ || dirty_survival_ ? years_ : surv_years_;
+            fill_survival<Freq>(law_, age_, surv_years_, surv_);
+            counts_.survival++;
+            dirty_survival_ = false;
+            dirty_commutation_ = true;
+        }
+        if (dirty_discount_ || years_ > disc_years_) {
+            disc_years_ = years_ > disc_years_ || dirty_discount_ ? years_ : disc_years_;
+            if (curve_) fill_discount<Freq>(*curve_, disc_years_, disc_);
+            else fill_discount<Freq>(rate_, disc_years_, disc_);
+            counts_.discount++;
+            dirty_discount_ = false;
+            dirty_commutation_ = true;
+        }
+        if (dirty_commutation_) {
+            commute();
+            counts_.commutation++;
+            dirty_commutation_ = false;
+            dirty_results_ = true;
+        }
+        if (dirty_results_) {
+            evaluate();
+            counts_.results++;
+            dirty_results_ = false;
+        }
+        return results_;
+    }
+
+    const ModelStageCounts& stage_counts() const { return counts_; }
+
+    // Vectores de la última valoración, para las plantillas de valuation.h
+    Basis basis() const {
+        Basis b = { surv_, disc_, years_, (double)age_, std::log(1.0 + rate_), &law_, 0 };
+        return b;
+    }
+
+private:
+    // D[k] = v^t t p_x; N[k] = suma de D desde k; M[k] = suma de C desde k,
+    // con C[k] = v^(t+h) (t p_x - (t+h) p_x)
+    void commute() {
+        const int n = years_ * kSteps;
+        d_[n] = surv_[n] * disc_[n];
+        n_[n] = 0.0;
+        m_[n] = 0.0;
+        for (int k = n - 1; k >= 0; k--) {
+            d_[k] = surv_[k] * disc_[k];
+            n_[k] = n_[k + 1] + d_[k];
+            m_[k] = m_[k + 1] + disc_[k + 1] * (surv_[k] - surv_[k + 1]);
+        }
+    }
+
+    double annuity_at(int year) const {
+        return ModelAnnuity<kSteps, Timing>::value(n_, d_, year * kSteps, years_ * kSteps);
+    }
+
+    void evaluate() {
+        results_.years = years_;
+        results_.annuity = annuity_at(0);
+        results_.insurance = m_[0];
+        const double unit_premium = results_.insurance / results_.annuity;
+        results_.premium = unit_premium * sum_assured_;
+        for (int t = 0; t < years_; t++) {
+            const int k = t * kSteps;
+            results_.reserve[t] = sum_assured_ * (m_[k] / d_[k] - unit_premium * annuity_at(t));
+        }
+        results_.reserve[years_] = 0.0;
+    }
+
+    MakehamLaw law_;
+    int age_;
+    int years_;
+    double rate_;
+    double sum_assured_;
+    const YieldCurve* curve_;
+    int surv_years_;            // Longitud calculada de cada vector
+    int disc_years_;
+
+    bool dirty_survival_;
+    bool dirty_discount_;
+    bool dirty_commutation_;
+    bool dirty_results_;
+    ModelStageCounts counts_;
+
+    double surv_[kMaxPoints];
+    double disc_[kMaxPoints];
+    double d_[kMaxPoints];
+    double n_[kMaxPoints];
+    double m_[kMaxPoints];
+    ModelResults results_;
+};
+
+}  // namespace actuarial
+
+#endif
@@ -0,0 +1,18 @@
+// Ley de Gompertz-Makeham
+
+#include <cmath>
+#include "mortality.h"
+
+namespace actuarial {
+
+const MakehamLaw kStandardUltimate = { 0.00022, 2.7e-6, 1.124 };
+
+double MakehamLaw::force(double age) const {
+    return A + B * std::pow(c, age);
+}
+
+double MakehamLaw::survival(double age, double t) const {
+    return std::exp(-A * t - B * std::pow(c, age) * (std::pow(c, t) - 1.0) / std::log(c));
+}
+
+}  // namespace actuarial
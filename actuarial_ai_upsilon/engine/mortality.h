@@ -0,0 +1,29 @@
+// Mortalidad paramétrica para el motor de valoración (engine/mortality.cpp)
+//
+// Ley de Gompertz-Makeham: mu(x) = A + B c^x. La supervivencia tiene forma
+// cerrada, así que cualquier rejilla (anual, mensual, m-ésima) sale exacta.
+
+#ifndef ENGINE_MORTALITY_H
+#define ENGINE_MORTALITY_H
+
+namespace actuarial {
+
+const int kMaxAge = 120;    // Edad final: la supervivencia se toma como 0
+
+struct MakehamLaw {
+    double A;
+    double B;
+    double c;
+
+    double force(double age) const;
+    // t p_x
+    double survival(double age, double t) const;
+};
+
+// Standard Ultimate Survival Model (Dickson, Hardy y Waters):
+// A = 0.00022, B = 2.7e-6, c = 1.124
+extern const MakehamLaw kStandardUltimate;
+
+}  // namespace actuarial
+
+#endif
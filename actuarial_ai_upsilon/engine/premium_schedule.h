@@ -0,0 +1,93 @@
+// Tabla de primas de seguro temporal por edad de emisión y plazo en una
+// sola pasada (engine/premium_schedule.h)
+//
+// Cada celda por separado (fill_survival + fill_discount + term_premium)
+// rellena y recorre sus propios vectores, aunque casi todos coinciden con
+// los de la celda vecina. Aquí se calculan una vez para toda la tabla:
+//
+//   surv[k]  supervivencia desde la edad mínima, hasta la edad máxima más
+//            el plazo máximo; t p_x = surv[x+t] / surv[x] y el divisor se
+//            cancela en el cociente de la prima
+//   disc[k]  v^(k h) hasta el plazo máximo, común a todas las edades
+//
+// El bucle exterior avanza paso a paso en la duración y el interior recorre
+// las edades, cada una con sus acumuladores: sumas independientes que el
+// compilador vectoriza sin reordenar ninguna (con Annual, surv se lee de
+// forma contigua). Al cerrar el último paso de cada año se leen las primas
+// de ese plazo para todas las edades, así que cada plazo sale de la misma
+// pasada. Sólo frecuencias Mthly<M>.
+
+#ifndef ENGINE_PREMIUM_SCHEDULE_H
+#define ENGINE_PREMIUM_SCHEDULE_H
+
+#include "valuation.h"
+
+namespace actuarial {
+
+// Edades de emisión y plazos (en años, ambos inclusive). La edad máxima
+// más el plazo máximo no debe pasar de kMaxAge.
+struct ScheduleGrid {
+    int min_age;
+    int max_age;
+    int min_term;
+    int max_term;
+
+    int ages() const { return max_age - min_age + 1; }
+    int terms() const { return max_term - min_term + 1; }
+    int cells() const { return ages() * terms(); }
+};
+
+namespace detail {
+
+template <class Freq> struct ScheduleSteps;
+template <int M> struct ScheduleSteps<Mthly<M> > {
+    static const int kSteps = M;
+};
+
+}  // namespace detail
+
+// Doubles de trabajo que necesita premium_schedule
+template <class Freq>
+inline int schedule_work_size(const ScheduleGrid& g) {
+    return grid_points<Freq>(g.max_age - g.min_age + g.max_term) + grid_points<Freq>(g.max_term) + 2 * g.ages();
+}
+
+// Prima neta anual por unidad de capital de cada celda, pagada con la
+// frecuencia y el momento indicados: out[edad * terms() + plazo], con los
+// índices relativos a min_age y min_term. `work` tiene
+// schedule_work_size<Freq>(g) doubles.
+template <class Freq, class Timing, class T>
+void premium_schedule(const MakehamLaw& law, double rate, const ScheduleGrid& g, double* work, T* out) {
+    const int M = detail::ScheduleSteps<Freq>::kSteps;
+    const int shift = detail::PaymentShift<Timing>::kValue;
+    const int ages = g.ages(), terms = g.terms();
+
+    double* surv = work;
+    double* disc = surv + grid_points<Freq>(g.max_age - g.min_age + g.max_term);
+    double* ann = disc + grid_points<Freq>(g.max_term);
+    double* ins = ann + ages;
+    fill_survival<Freq>(law, g.min_age, g.max_age - g.min_age + g.max_term, surv);
+    fill_discount<Freq>(rate, g.max_term, disc);
+    for (int j = 0; j < ages; j++) ann[j] = ins[j] = 0.0;
+
+    const int n = g.max_term * M;
+    for (int k = 0; k < n; k++) {
+        const double va = disc[k + shift], vi = disc[k + 1];
+        const double* l = surv + k;
+        for (int j = 0; j < ages; j++) {
+            const double l0 = l[j * M], l1 = l[j * M + 1];
+            ann[j] += va * l[j * M + shift];
+            ins[j] += vi * (l0 - l1);
+        }
+
+        if ((k + 1) % M != 0) continue;
+        const int term = (k + 1) / M;
+        if (term < g.min_term) continue;
+        T* column = out + (term - g.min_term);
+        for (int j = 0; j < ages; j++) column[j * terms] = (T)(ins[j] * M / ann[j]);
+    }
+}
+
+}  // namespace actuarial
+
+#endif
@@ -0,0 +1,252 @@
+// Raíces de funciones de valoración: tipos, primas y rendimientos
+// implícitos (engine/solver.h)
+//
+// Las plantillas de valuation.h dan el valor para unos supuestos; aquí se
+// busca el supuesto que da un valor: "¿a qué tipo cuesta esta renta
+// 150000?", "¿qué prima de tarifa deja beneficio cero?". solve() busca la
+// raíz dentro de un intervalo [lo, hi] con cambio de signo, con el esquema
+// de Brent (Brent, Algorithms for Minimization without Derivatives, 1973)
+// y Newton como primer candidato de cada paso:
+//
+//   1. Newton desde el mejor punto, si la función da derivada
+//   2. Si no, o si el paso de Newton se sale del intervalo o no acorta a la
+//      mitad el penúltimo paso: interpolación cuadrática inversa (o secante)
+//   3. Si tampoco cumple esas condiciones: bisección
+//
+// El intervalo con cambio de signo se conserva siempre, así que una
+// derivada mala o un Newton que cicla sólo cuestan pasos, nunca la
+// convergencia. Cerca de la raíz Newton converge cuadráticamente y cada
+// paso es una sola evaluación. Se evalúa como mucho limits.max_evals
+// veces (sin derivada, el peor caso de Brent es del orden de
+// log2((hi - lo) / x_tol)^2 evaluaciones); al llegar al límite se devuelve
+// el mejor punto con kSolveMaxEvals.
+//
+// La función es un objeto con `double operator()(double x, double* slope)
+// const`: devuelve f(x) y escribe f'(x) en *slope, o 0 si no la conoce.
+// Abajo están las de tipo implícito (con derivada analítica respecto de i
+// en la misma pasada) y la de prima de tarifa. Sólo frecuencias Mthly<M>.
+
+#ifndef ENGINE_SOLVER_H
+#define ENGINE_SOLVER_H
+
+#include <cmath>
+#include <cfloat>
+#include "valuation.h"
+
+namespace actuarial {
+
+enum SolveStatus {
+    kSolveConverged,
+    kSolveNoBracket,        // f(lo) y f(hi) con el mismo signo
+    kSolveMaxEvals
+};
+
+struct SolveLimits {
+    double x_tol;           // Anchura del intervalo (más 2 eps |x|)
+    double f_tol;           // |f(x)| que ya se da por raíz
+    int max_evals;
+};
+
+const SolveLimits kSolveDefaults = { 1e-12, 0.0, 60 };
+
+struct SolveResult {
+    double x;
+    double f;
+    int evals;
+    int newton_steps;
+    int interpolation_steps;
+    int bisection_steps;
+    SolveStatus status;
+};
+
+template <class Fn>
+SolveResult solve(const Fn& fn, double lo, double hi, const SolveLimits& limits = kSolveDefaults) {
+    SolveResult r = { lo, 0.0, 2, 0, 0, 0, kSolveNoBracket };
+    double a = lo, b = hi, da = 0.0, db = 0.0;
+    double fa = fn(a, &da), fb = fn(b, &db);
+    if ((fa > 0.0) == (fb > 0.0) && fa != 0.0 && fb != 0.0) {
+        r.x = std::fabs(fa) < std::fabs(fb) ? a : b;
+        r.f = std::fabs(fa) < std::fabs(fb) ? fa : fb;
+        return r;
+    }
+
+    // b: mejor punto; c: extremo opuesto del intervalo; a: punto anterior.
+    // d, e: último paso y el anterior.
+    double c = a, fc = fa, dc = da;
+    double d = b - a, e = d;
+    for (;;) {
+        if ((fb > 0.0) == (fc > 0.0)) {
+            c = a;
+            fc = fa;
+            dc = da;
+            d = e = b - a;
+        }
+        if (std::fabs(fc) < std::fabs(fb)) {
+            a = b; b = c; c = a;
+            fa = fb; fb = fc; fc = fa;
+            da = db; db = dc; dc = da;
+        }
+
+        const double tol = 2.0 * DBL_EPSILON * std::fabs(b) + 0.5 * limits.x_tol;
+        const double xm = 0.5 * (c - b);
+        r.x = b;
+        r.f = fb;
+        if (std::fabs(xm) <= tol || std::fabs(fb) <= limits.f_tol) {
+            r.status = kSolveConverged;
+            return r;
+        }
+        if (r.evals >= limits.max_evals) {
+            r.status = kSolveMaxEvals;
+            return r;
+        }
+
+        // Un paso se acepta si va hacia c sin pasar de 3/4 del intervalo y
+        // es menor que la mitad del penúltimo
+        bool taken = false;
+        if (db != 0.0 && std::fabs(e) >= tol) {
+            const double step = -fb / db;
+            if (step * xm > 0.0 && 2.0 * std::fabs(step) < std::fmin(3.0 * std::fabs(xm) - tol, std::fabs(e))) {
+                e = d;
+                d = step;
+                r.newton_steps++;
+                taken = true;
+            }
+        }
+        if (!taken && std::fabs(e) >= tol && std::fabs(fa) > std::fabs(fb)) {
+            double p, q;
+            const double s = fb / fa;
+            if (a == c) {
+                p = 2.0 * xm * s;
+                q = 1.0 - s;
+            } else {
+                const double qa = fa / fc, rb = fb / fc;
+                p = s * (2.0 * xm * qa * (qa - rb) - (b - a) * (rb - 1.0));
+                q = (qa - 1.0) * (rb - 1.0) * (s - 1.0);
+            }
+            if (p > 0.0) q = -q;
+            p = std::fabs(p);
+            if (2.0 * p < std::fmin(3.0 * xm * q - std::fabs(tol * q), std::fabs(e * q))) {
+                e = d;
+                d = p / q;
+                r.interpolation_steps++;
+                taken = true;
+            }
+        }
+        if (!taken) {
+            d = xm;
+            e = d;
+            r.bisection_steps++;
+        }
+
+        a = b;
+        fa = fb;
+        da = db;
+        b += std::fabs(d) > tol ? d : (xm > 0.0 ? tol : -tol);
+        fb = fn(b, &db);
+        r.evals++;
+    }
+}
+
+// Renta y seguro temporales por unidad al tipo i, y sus derivadas respecto
+// de i: d(v^t)/di = -t v^t / (1 + i)
+struct RateValues {
+    double annuity;
+    double d_annuity;
+    double insurance;
+    double d_insurance;
+};
+
+// Rellena `disc` (grid_points<Freq>(years) doubles) al tipo `rate` y
+// recorre los vectores una vez
+template <class Freq, class Timing>
+RateValues rate_values(const double* surv, int years, double rate, double* disc) {
+    const int M = Freq::kSteps, n = years * M;
+    const int shift = detail::PaymentShift<Timing>::kValue;
+    fill_discount<Freq>(rate, years, disc);
+    double ann = 0.0, ann_t = 0.0, ins = 0.0, ins_t = 0.0;
+    for (int k = 0; k < n; k++) {
+        const double pay = surv[k + shift] * disc[k + shift];
+        const double claim = (surv[k] - surv[k + 1]) * disc[k + 1];
+        ann += pay;
+        ann_t += (k + shift) * pay;
+        ins += claim;
+        ins_t += (k + 1) * claim;
+    }
+    const double dt = -1.0 / (M * (1.0 + rate));      // t = k / M
+    RateValues v;
+    v.annuity = ann / M;
+    v.d_annuity = ann_t * dt / M;
+    v.insurance = ins;
+    v.d_insurance = ins_t * dt;
+    return v;
+}
+
+// Tipo al que una renta de `payment` al año cuesta `price`:
+// payment ä(i) - price = 0
+template <class Freq, class Timing>
+struct AnnuityYield {
+    const double* surv;
+    int years;
+    double payment;
+    double price;
+    double* disc;           // Trabajo: grid_points<Freq>(years)
+
+    double operator()(double rate, double* slope) const {
+        const RateValues v = rate_values<Freq, Timing>(surv, years, rate, disc);
+        *slope = payment * v.d_annuity;
+        return payment * v.annuity - price;
+    }
+};
+
+// Tipo de equilibrio de una prima: aquel al que `premium` al año es la
+// prima neta del seguro temporal de `sum_assured`:
+// premium ä(i) - sum_assured A(i) = 0
+template <class Freq, class Timing>
+struct BreakEvenRate {
+    const double* surv;
+    int years;
+    double premium;
+    double sum_assured;
+    double* disc;
+
+    double operator()(double rate, double* slope) const {
+        const RateValues v = rate_values<Freq, Timing>(surv, years, rate, disc);
+        *slope = premium * v.d_annuity - sum_assured * v.d_insurance;
+        return premium * v.annuity - sum_assured * v.insurance;
+    }
+};
+
+// Gastos de un seguro temporal, sobre la prima de tarifa anual G
+struct Expenses {
+    double initial_pct;     // Del primer año de prima
+    double renewal_pct;     // De cada prima
+    double initial_fixed;   // Al emitir
+    double renewal_fixed;   // Anual, con cada prima
+    double claim_fixed;     // Por siniestro
+};
+
+// Valor esperado del beneficio con prima de tarifa G:
+// G ä (1 - renewal_pct) - G initial_pct - initial_fixed - renewal_fixed ä
+// - (sum_assured + claim_fixed) A. Es lineal en G, así que con la
+// derivada Newton llega en un paso.
+template <class Freq, class Timing>
+struct GrossPremium {
+    double annuity;
+    double insurance;
+    double sum_assured;
+    Expenses expenses;
+
+    GrossPremium(const Basis& b, double sum, const Expenses& e)
+        : annuity(actuarial::annuity<Freq, Timing>(b)), insurance(term_insurance<Freq>(b)),
+          sum_assured(sum), expenses(e) {}
+
+    double operator()(double gross, double* slope) const {
+        *slope = annuity * (1.0 - expenses.renewal_pct) - expenses.initial_pct;
+        return gross * *slope - expenses.initial_fixed - expenses.renewal_fixed * annuity -
+               (sum_assured + expenses.claim_fixed) * insurance;
+    }
+};
+
+}  // namespace actuarial
+
+#endif
@@ -0,0 +1,245 @@
+// Rentas, seguros, primas y reservas con la frecuencia y el momento de pago
+// como parámetros de plantilla (engine/valuation.h)
+//
+// Cada valoración trabaja sobre dos vectores en una rejilla de
+// 1/Freq::kSteps años: supervivencia (t p_x) y descuento (v^t). Con la
+// frecuencia y el momento de pago fijados en compilación, cada bucle es un
+// producto escalar de longitud conocida y sin ramas; valuation_generic.h
+// hace lo mismo decidiendo en tiempo de ejecución, para comparar.
+//
+//   Mthly<M>    M pagos al año (Annual, Quarterly, Monthly)
+//   Continuous  pago continuo: trapecio mensual con corrección de
+//               Euler-Maclaurin (error O(h^4)); el momento no aplica
+//   Immediate   pago al final de cada periodo (a)
+//   Due         pago al principio (ä)
+//
+// Los seguros pagan al final del periodo m-ésimo del fallecimiento (o en
+// el instante, con Continuous). `from_year` valora desde la duración t
+// (x+t), para reservas prospectivas sobre los mismos vectores.
+//
+// Con una curva de tipos (yield_curve.h) el descuento sale de su tabla y
+// Basis::forward lleva el forward de cada paso (forwards() de la curva, en
+// la rejilla mensual de Continuous); Continuous aplica entonces la
+// corrección paso a paso con el forward medio del mes, con un error
+// relativo del orden de 1e-6 en lugar de O(h^4).
+//
+// Los vectores se rellenan como cadenas de productos (un exp por paso en la
+// supervivencia, un producto en el descuento): es lo más barato con libm,
+// y el error relativo que crece con k se queda por debajo de 1e-11 en
+// cualquier plazo del motor (host/grid_bench.cpp lo comprueba).
+
+#ifndef ENGINE_VALUATION_H
+#define ENGINE_VALUATION_H
+
+#include <cmath>
+#include "mortality.h"
+#include "yield_curve.h"
+
+namespace actuarial {
+
+template <int M> struct Mthly {
+    static const int kSteps = M;
+};
+typedef Mthly<1> Annual;
+typedef Mthly<4> Quarterly;
+typedef Mthly<12> Monthly;
+
+struct Continuous {
+    static const int kSteps = 12;
+};
+
+struct Immediate {};
+struct Due {};
+
+// Vectores de una valoración ya calculados (ver fill_survival/fill_discount)
+struct Basis {
+    const double* surv;         // surv[k] = (k h) p_x
+    const double* disc;         // disc[k] = v^(k h)
+    int years;
+    double age;
+    double delta;               // ln(1 + i)
+    const MakehamLaw* law;
+    const double* forward;      // Curva: fuerza de interés en [k h, (k+1) h); 0 = delta
+};
+
+template <class Freq>
+inline int grid_points(int years) {
+    return years * Freq::kSteps + 1;
+}
+
+template <class Freq>
+void fill_survival(const MakehamLaw& law, double age, int years, double* surv) {
+    const int n = years * Freq::kSteps;
+    const double h = 1.0 / Freq::kSteps;
+    // Supervivencia de un paso: exp(-A h - B c^(x+t) (c^h - 1) / ln c)
+    const double a_h = law.A * h;
+    const double c_h = std::pow(law.c, h);
+    const double g = law.B * (c_h - 1.0) / std::log(law.c);
+    double cx = std::pow(law.c, age);
+    double s = 1.0;
+    surv[0] = 1.0;
+    for (int k = 1; k <= n; k++) {
+        s *= std::exp(-a_h - g * cx);
+        cx *= c_h;
+        surv[k] = s;
+    }
+}
+
+template <class Freq>
+void fill_discount(double rate, int years, double* disc) {
+    const int n = years * Freq::kSteps;
+    const double v_h = std::pow(1.0 + rate, -1.0 / Freq::kSteps);
+    double v = 1.0;
+    for (int k = 0; k <= n; k++) {
+        disc[k] = v;
+        v *= v_h;
+    }
+}
+
+template <class Freq>
+void fill_discount(const YieldCurve& curve, int years, double* disc) {
+    curve.fill_discount(Freq::kSteps, years, disc);
+}
+
+namespace detail {
+
+// Primer término de la renta: v^k (Due) o v^(k+1) (Immediate)
+template <class Timing> struct PaymentShift;
+template <> struct PaymentShift<Due> {
+    static const int kValue = 0;
+};
+template <> struct PaymentShift<Immediate> {
+    static const int kValue = 1;
+};
+
+// Valor en x+from_year de un flujo sumado sobre los vectores desde x
+inline double rebase(const Basis& b, int k) {
+    return b.surv[k] * b.disc[k];
+}
+
+template <class Freq, class Timing> struct AnnuitySum;
+
+template <int M> struct AnnuitySum<Mthly<M>, Due> {
+    static double value(const Basis& b, int from_year) {
+        const int first = from_year * M, n = b.years * M;
+        double sum = 0.0;
+        for (int k = first; k < n; k++) sum += b.surv[k] * b.disc[k];
+        return sum / M / rebase(b, first);
+    }
+};
+
+template <int M> struct AnnuitySum<Mthly<M>, Immediate> {
+    static double value(const Basis& b, int from_year) {
+        const int first = from_year * M, n = b.years * M;
+        double sum = 0.0;
+        for (int k = first + 1; k <= n; k++) sum += b.surv[k] * b.disc[k];
+        return sum / M / rebase(b, first);
+    }
+};
+
+// Con forward por paso: trapecio con la corrección de Euler-Maclaurin en
+// cada paso (derivadas laterales, porque f' salta en los nodos). Devuelve
+// la integral de v^t t p_x y, en `weighted`, la de forward * v^t t p_x.
+inline double continuous_curve(const Basis& b, int first, int n, double* weighted) {
+    const double h = 1.0 / Continuous::kSteps;
+    const double c_h = std::pow(b.law->c, h);
+    double cx = std::pow(b.law->c, b.age + first * h);
+    double plain = 0.0, with_forward = 0.0;
+    for (int k = first; k < n; k++) {
+        const double f0 = rebase(b, k), f1 = rebase(b, k + 1);
+        const double mu0 = b.law->A + b.law->B * cx;
+        cx *= c_h;
+        const double mu1 = b.law->A + b.law->B * cx;
+        const double step = h * 0.5 * (f0 + f1) +
+                            h * h / 12.0 * ((b.forward[k] + mu1) * f1 - (b.forward[k] + mu0) * f0);
+        plain += step;
+        with_forward += b.forward[k] * step;
+    }
+    if (weighted) *weighted = with_forward;
+    return plain;
+}
+
+template <class Timing> struct AnnuitySum<Continuous, Timing> {
+    static double value(const Basis& b, int from_year) {
+        const int S = Continuous::kSteps;
+        if (b.forward) {
+            return continuous_curve(b, from_year * S, b.years * S, 0) / rebase(b, from_year * S);
+        }
+        const int first = from_year * S, n = b.years * S;
+        const double h = 1.0 / S;
+        double sum = 0.0;
+        for (int k = first + 1; k < n; k++) sum += b.surv[k] * b.disc[k];
+        const double f0 = rebase(b, first), fn = rebase(b, n);
+        double trapezoid = h * (sum + 0.5 * (f0 + fn));
+        // f'(t) = -(delta + mu) f(t)
+        double slope0 = (b.delta + b.law->force(b.age + from_year)) * f0;
+        double slopen = (b.delta + b.law->force(b.age + b.years)) * fn;
+        return (trapezoid + h * h / 12.0 * (slopen - slope0)) / f0;
+    }
+};
+
+template <class Freq> struct InsuranceSum;
+
+template <int M> struct InsuranceSum<Mthly<M> > {
+    static double value(const Basis& b, int from_year) {
+        const int first = from_year * M, n = b.years * M;
+        double sum = 0.0;
+        for (int k = first; k < n; k++) sum += b.disc[k + 1] * (b.surv[k] - b.surv[k + 1]);
+        return sum / rebase(b, first);
+    }
+};
+
+template <> struct InsuranceSum<Continuous> {
+    static double value(const Basis& b, int from_year) {
+        // 1 - v^n n p_x = delta ā + Ā¹ (con curva, la integral de forward v^t t p_x)
+        const int first = from_year * Continuous::kSteps, n = b.years * Continuous::kSteps;
+        if (b.forward) {
+            double weighted;
+            continuous_curve(b, first, n, &weighted);
+            return 1.0 - (weighted + rebase(b, n)) / rebase(b, first);
+        }
+        double a = AnnuitySum<Continuous, Due>::value(b, from_year);
+        return 1.0 - b.delta * a - rebase(b, n) / rebase(b, first);
+    }
+};
+
+}  // namespace detail
+
+// Renta temporal hasta el final de los vectores
+template <class Freq, class Timing>
+inline double annuity(const Basis& b, int from_year = 0) {
+    return detail::AnnuitySum<Freq, Timing>::value(b, from_year);
+}
+
+// Seguro temporal de fallecimiento
+template <class Freq>
+inline double term_insurance(const Basis& b, int from_year = 0) {
+    return detail::InsuranceSum<Freq>::value(b, from_year);
+}
+
+template <class Freq>
+inline double pure_endowment(const Basis& b, int from_year = 0) {
+    const int first = from_year * Freq::kSteps, n = b.years * Freq::kSteps;
+    return detail::rebase(b, n) / detail::rebase(b, first);
+}
+
+template <class Freq>
+inline double endowment_insurance(const Basis& b, int from_year = 0) {
+    return term_insurance<Freq>(b, from_year) + pure_endowment<Freq>(b, from_year);
+}
+
+// Prima neta anual de un seguro temporal pagada con la misma frecuencia
+template <class Freq, class Timing>
+inline double term_premium(const Basis& b) {
+    return term_insurance<Freq>(b) / annuity<Freq, Timing>(b);
+}
+
+// Reserva prospectiva por unidad de capital en la duración t
+template <class Freq, class Timing>
+inline double term_reserve(const Basis& b, double premium, int t) {
+    return term_insurance<Freq>(b, t) - premium * annuity<Freq, Timing>(b, t);
+}
+
+}  // namespace actuarial
+
+#endif
@@ -0,0 +1,86 @@
+// Valoración genérica: frecuencia y momento de pago decididos en cada paso
+
+#include <cmath>
+#include "valuation_generic.h"
+
+namespace actuarial {
+
+void fill_survival_runtime(const MakehamLaw& law, double age, int years, int steps, double* surv) {
+    const int n = years * steps;
+    surv[0] = 1.0;
+    for (int k = 1; k <= n; k++) {
+        surv[k] = surv[k - 1] * law.survival(age + (double)(k - 1) / steps, 1.0 / steps);
+    }
+}
+
+void fill_discount_runtime(double rate, int years, int steps, double* disc) {
+    const int n = years * steps;
+    for (int k = 0; k <= n; k++) {
+        disc[k] = std::pow(1.0 + rate, -(double)k / steps);
+    }
+}
+
+double annuity_runtime(const Basis& b, RuntimeFrequency freq, int from_year) {
+    const int first = from_year * freq.steps, n = b.years * freq.steps;
+    const double h = 1.0 / freq.steps;
+    if (freq.timing == TIMING_CONTINUOUS && b.forward) {
+        return detail::continuous_curve(b, first, n, 0) / detail::rebase(b, first);
+    }
+    double sum = 0.0;
+
+    for (int k = first; k <= n; k++) {
+        double weight;
+        switch (freq.timing) {
+            case TIMING_DUE:
+                weight = k < n ? h : 0.0;
+                break;
+            case TIMING_IMMEDIATE:
+                weight = k > first ? h : 0.0;
+                break;
+            default:
+                weight = (k == first || k == n) ? 0.5 * h : h;
+                break;
+        }
+        sum += weight * b.surv[k] * b.disc[k];
+    }
+
+    const double f0 = b.surv[first] * b.disc[first];
+    if (freq.timing == TIMING_CONTINUOUS) {
+        const double fn = b.surv[n] * b.disc[n];
+        double slope0 = (b.delta + b.law->force(b.age + from_year)) * f0;
+        double slopen = (b.delta + b.law->force(b.age + b.years)) * fn;
+        sum += h * h / 12.0 * (slopen - slope0);
+    }
+    return sum / f0;
+}
+
+double term_insurance_runtime(const Basis& b, RuntimeFrequency freq, int from_year) {
+    const int first = from_year * freq.steps, n = b.years * freq.steps;
+    const double f0 = b.surv[first] * b.disc[first];
+
+    if (freq.timing == TIMING_CONTINUOUS && b.forward) {
+        double weighted;
+        detail::continuous_curve(b, first, n, &weighted);
+        return 1.0 - (weighted + b.surv[n] * b.disc[n]) / f0;
+    }
+    if (freq.timing == TIMING_CONTINUOUS) {
+        RuntimeFrequency due = { freq.steps, TIMING_CONTINUOUS };
+        return 1.0 - b.delta * annuity_runtime(b, due, from_year) - b.surv[n] * b.disc[n] / f0;
+    }
+
+    double sum = 0.0;
+    for (int k = first; k < n; k++) {
+        sum += b.disc[k + 1] * (b.surv[k] - b.surv[k + 1]);
+    }
+    return sum / f0;
+}
+
+double term_premium_runtime(const Basis& b, RuntimeFrequency freq) {
+    return term_insurance_runtime(b, freq) / annuity_runtime(b, freq);
+}
+
+double term_reserve_runtime(const Basis& b, RuntimeFrequency freq, double premium, int t) {
+    return term_insurance_runtime(b, freq, t) - premium * annuity_runtime(b, freq, t);
+}
+
+}  // namespace actuarial
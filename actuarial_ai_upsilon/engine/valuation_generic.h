@@ -0,0 +1,36 @@
+// Valoración con la frecuencia y el momento de pago en tiempo de ejecución
+// (engine/valuation_generic.cpp)
+//
+// Mismos vectores y fórmulas que valuation.h, pero cada bucle decide con un
+// switch en cada paso. Es la referencia del benchmark de plantillas y la
+// vía para frecuencias que no se conocen al compilar.
+
+#ifndef ENGINE_VALUATION_GENERIC_H
+#define ENGINE_VALUATION_GENERIC_H
+
+#include "valuation.h"
+
+namespace actuarial {
+
+enum PaymentTiming {
+    TIMING_IMMEDIATE,
+    TIMING_DUE,
+    TIMING_CONTINUOUS       // La rejilla es la de Continuous::kSteps
+};
+
+struct RuntimeFrequency {
+    int steps;              // Pagos (o pasos de la rejilla) por año
+    PaymentTiming timing;
+};
+
+void fill_survival_runtime(const MakehamLaw& law, double age, int years, int steps, double* surv);
+void fill_discount_runtime(double rate, int years, int steps, double* disc);
+
+double annuity_runtime(const Basis& b, RuntimeFrequency freq, int from_year = 0);
+double term_insurance_runtime(const Basis& b, RuntimeFrequency freq, int from_year = 0);
+double term_premium_runtime(const Basis& b, RuntimeFrequency freq);
+double term_reserve_runtime(const Basis& b, RuntimeFrequency freq, double premium, int t);
+
+}  // namespace actuarial
+
+#endif
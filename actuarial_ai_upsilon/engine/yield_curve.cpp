@@ -0,0 +1,165 @@
+// Curva de tipos: construcción, interpolación y tabla de descuentos
+
+#include <cmath>
+#include "yield_curve.h"
+
+namespace actuarial {
+
+// Derivadas de Fritsch-Carlson: media armónica ponderada de las pendientes
+// vecinas, 0 en los extremos locales. Garantiza que la cúbica de Hermite
+// sea monótona allí donde los nodos lo son.
+static void monotone_slopes(const double* x, const double* y, int count, double* slope) {
+    if (count < 2) {
+        if (count == 1) slope[0] = 0.0;
+        return;
+    }
+    double prev_h = x[1] - x[0];
+    double prev_d = (y[1] - y[0]) / prev_h;
+    slope[0] = prev_d;
+    for (int i = 1; i < count - 1; i++) {
+        const double h = x[i + 1] - x[i];
+        const double d = (y[i + 1] - y[i]) / h;
+        if (prev_d * d <= 0.0) {
+            slope[i] = 0.0;
+        } else {
+            const double w1 = 2.0 * h + prev_h, w2 = h + 2.0 * prev_h;
+            slope[i] = (w1 + w2) / (w1 / prev_d + w2 / d);
+        }
+        prev_h = h;
+        prev_d = d;
+    }
+    slope[count - 1] = prev_d;
+}
+
+// Valor en t; constante fuera de [x[0], x[count - 1]]
+static double interpolate(const double* x, const double* y, const double* slope, int count,
+                          CurveInterpolation interp, double t) {
+    if (t <= x[0]) return y[0];
+    if (t >= x[count - 1]) return y[count - 1];
+
+    int lo = 0, hi = count - 1;
+    while (hi - lo > 1) {
+        const int mid = (lo + hi) / 2;
+        if (x[mid] <= t) lo = mid;
+        else hi = mid;
+    }
+    const double h = x[hi] - x[lo];
+    const double s = (t - x[lo]) / h;
+    if (interp == CURVE_LINEAR) return y[lo] + s * (y[hi] - y[lo]);
+
+    const double s2 = s * s, s3 = s2 * s;
+    return (2.0 * s3 - 3.0 * s2 + 1.0) * y[lo] + (s3 - 2.0 * s2 + s) * h * slope[lo] +
+           (-2.0 * s3 + 3.0 * s2) * y[hi] + (s3 - s2) * h * slope[hi];
+}
+
+static bool valid_tenors(const double* tenors, int count, bool whole_years) {
+    if (count < 1 || count > YieldCurve::kMaxNodes) return false;
+    for (int i = 0; i < count; i++) {
+        if (!(tenors[i] > 0.0) || tenors[i] > kMaxAge) return false;
+        if (i > 0 && !(tenors[i] > tenors[i - 1])) return false;
+        if (whole_years && tenors[i] != std::floor(tenors[i])) return false;
+    }
+    return true;
+}
+
+YieldCurve::YieldCurve() : count_(0), interp_(CURVE_LINEAR) {
+    const double flat = 0.0;
+    const double tenor = 1.0;
+    set_nodes(&tenor, &flat, 1, CURVE_LINEAR);
+}
+
+bool YieldCurve::set_nodes(const double* tenors, const double* zero_rates, int count, CurveInterpolation interp) {
+    count_ = count;
+    interp_ = interp;
+    for (int i = 0; i < count; i++) {
+        tenor_[i] = tenors[i];
+        zero_[i] = zero_rates[i];
+    }
+    monotone_slopes(tenor_, zero_, count_, slope_);
+    tabulate();
+    return true;
+}
+
+bool YieldCurve::build_from_spot(const double* tenors, const double* spots, int count, CurveInterpolation interp) {
+    if (!valid_tenors(tenors, count, false)) return false;
+    double zero[kMaxNodes];
+    for (int i = 0; i < count; i++) {
+        if (!(spots[i] > -1.0)) return false;
+        zero[i] = std::log(1.0 + spots[i]);
+    }
+    return set_nodes(tenors, zero, count, interp);
+}
+
+// Bootstrap: un bono par de plazo n y cupón c vale 1, así que
+// v(n) = (1 - c * suma v(j), j < n) / (1 + c). Los rendimientos par de los
+// años sin cotización se interpolan con el mismo método que la curva.
+bool YieldCurve::build_from_par(const double* tenors, const double* par, int count, CurveInterpolation interp) {
+    if (!valid_tenors(tenors, count, true)) return false;
+
+    double slope[kMaxNodes];
+    monotone_slopes(tenors, par, count, slope);
+
+    const int last = (int)tenors[count - 1];
+    double years[kMaxNodes];
+    double zero[kMaxNodes];
+    double annuity = 0.0;
+    for (int n = 1; n <= last; n++) {
+        const double c = interpolate(tenors, par, slope, count, interp, n);
+        const double v = (1.0 - c * annuity) / (1.0 + c);
+        if (!(v > 0.0)) return false;
+        annuity += v;
+        years[n - 1] = n;
+        zero[n - 1] = -std::log(v) / n;
+    }
+    return set_nodes(years, zero, last, interp);
+}
+
+double YieldCurve::zero_rate(double t) const {
+    return interpolate(tenor_, zero_, slope_, count_, interp_, t);
+}
+
+void YieldCurve::tabulate() {
+    const double h = 1.0 / kSteps;
+    table_[0] = 1.0;
+    for (int k = 1; k < kPoints; k++) {
+        const double t = k * h;
+        table_[k] = std::exp(-zero_rate(t) * t);
+        forward_[k - 1] = std::log(table_[k - 1] / table_[k]) * kSteps;
+        // Parábola por ln v en los extremos y el punto medio del mes
+        const double mid = t - 0.5 * h;
+        const double log_mid = -zero_rate(mid) * mid;
+        bend_[k - 1] = 4.0 * (0.5 * (std::log(table_[k - 1]) + std::log(table_[k])) - log_mid);
+    }
+    forward_[kPoints - 1] = forward_[kPoints - 2];
+    bend_[kPoints - 1] = 0.0;
+}
+
+double YieldCurve::discount(double t) const {
+    if (t <= 0.0) return 1.0;
+    const double s = t * kSteps;
+    int k = (int)s;
+    if (k >= kPoints - 1) k = kPoints - 1;
+    const double u = s - k;
+    return table_[k] * std::exp(-forward_[k] * u / kSteps + bend_[k] * u * (u - 1.0));
+}
+
+double YieldCurve::spot(double t) const {
+    if (t <= 0.0) return std::exp(zero_[0]) - 1.0;
+    return std::pow(discount(t), -1.0 / t) - 1.0;
+}
+
+void YieldCurve::fill_discount(int steps, int years, double* disc) const {
+    const int n = years * steps;
+    if (kSteps % steps == 0) {
+        const int stride = kSteps / steps;
+        for (int k = 0; k <= n; k++) disc[k] = table_[k * stride];
+    } else {
+        for (int k = 0; k <= n; k++) disc[k] = discount((double)k / steps);
+    }
+}
+
+double YieldCurve::discount_direct(double t) const {
+    return std::exp(-zero_rate(t) * t);
+}
+
+}  // namespace actuarial
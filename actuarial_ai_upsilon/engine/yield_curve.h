@@ -0,0 +1,75 @@
+// Curva de tipos con tabla densa de factores de descuento
+// (engine/yield_curve.cpp)
+//
+// La curva se construye una vez a partir de tipos spot o de rendimientos
+// par (con bootstrap de bonos de cupón anual) y se interpola sobre tipos
+// cero continuos, linealmente o con cúbica monótona (Fritsch-Carlson: sin
+// sobreoscilaciones entre nodos). Al construirla se tabulan, hasta kMaxAge
+// años y mes a mes, v(t), el forward medio de cada mes y la curvatura de
+// ln v(t) dentro del mes. A partir de ahí una consulta en la rejilla es una
+// lectura, y entre puntos una parábola en ln v y una sola exp.
+//
+// Las valoraciones la usan a través de fill_discount() o, con frecuencia
+// mensual, apuntando Basis::disc directamente a table(). Más allá del
+// último nodo el tipo cero se mantiene constante.
+
+#ifndef ENGINE_YIELD_CURVE_H
+#define ENGINE_YIELD_CURVE_H
+
+#include "mortality.h"
+
+namespace actuarial {
+
+enum CurveInterpolation {
+    CURVE_LINEAR,
+    CURVE_MONOTONE_CUBIC
+};
+
+class YieldCurve {
+public:
+    static const int kMaxNodes = kMaxAge;
+    static const int kSteps = 12;
+    static const int kPoints = kMaxAge * kSteps + 1;
+
+    YieldCurve();
+
+    // Plazos en años, crecientes; tipos spot efectivos anuales
+    bool build_from_spot(const double* tenors, const double* spots, int count, CurveInterpolation interp);
+    // Plazos enteros en años, crecientes; rendimientos par de cupón anual
+    bool build_from_par(const double* tenors, const double* par, int count, CurveInterpolation interp);
+
+    double discount(double t) const;
+    double discount_at(int step) const { return table_[step]; }
+    // Fuerza de interés constante dentro del paso [step, step + 1)
+    double forward_at(int step) const { return forward_[step]; }
+    // Tipo spot efectivo anual
+    double spot(double t) const;
+
+    const double* table() const { return table_; }
+    const double* forwards() const { return forward_; }
+
+    // v(k/Steps) para k = 0..years*Steps; Steps debe dividir a kSteps o
+    // se interpola entre los puntos de la tabla
+    void fill_discount(int steps, int years, double* disc) const;
+
+    // Evalúa la interpolación sin la tabla (referencia del benchmark)
+    double discount_direct(double t) const;
+
+private:
+    bool set_nodes(const double* tenors, const double* zero_rates, int count, CurveInterpolation interp);
+    double zero_rate(double t) const;
+    void tabulate();
+
+    int count_;
+    CurveInterpolation interp_;
+    double tenor_[kMaxNodes];
+    double zero_[kMaxNodes];        // Tipo cero continuo en cada nodo
+    double slope_[kMaxNodes];       // Derivadas de Hermite (cúbica monótona)
+    double table_[kPoints];
+    double forward_[kPoints];
+    double bend_[kPoints];          // ln v = ln v_k - f_k h s + bend_k s (s - 1)
+};
+
+}  // namespace actuarial
+
+#endif
@@ -0,0 +1,188 @@
+// Latido en segundo plano y estado del enlace en caché
+
+#include <string.h>
+#include "link_monitor.h"
+#include "uart_hardware.h"
+
+#define LINK_LINE_MAX 32
+
+static struct {
+    LinkState state;
+    bool ping_pending;
+    uint64_t ping_sent_at;
+    uint64_t next_ping_at;
+    uint32_t rtt_ms;
+    uint32_t rtt_avg_ms;
+    uint8_t misses;
+    uint32_t rounds;
+    bool last_ok;
+    char line[LINK_LINE_MAX];
+    uint8_t line_len;
+} monitor;
+
+// NULL: latido como líneas de texto directamente sobre el UART
+static Transport* transport;
+static const uint8_t ping_message[] = { 'P', 'I', 'N', 'G' };
+
+void link_monitor_init(uint64_t now) {
+    memset(&monitor, 0, sizeof(monitor));
+    monitor.state = LINK_UNKNOWN;
+    monitor.next_ping_at = now;  // Primer latido en cuanto haya UART
+    transport = NULL;
+}
+
+void link_monitor_use_transport(Transport* t) {
+    transport = t;
+}
+
+static void finish_round(bool ok) {
+    monitor.ping_pending = false;
+    monitor.rounds++;
+    monitor.last_ok = ok;
+}
+
+static void handle_pong(uint64_t now) {
+    uint32_t rtt = (uint32_t)(now - monitor.ping_sent_at);
+
+    monitor.rtt_ms = rtt;
+    monitor.rtt_avg_ms = monitor.rtt_avg_ms ? (monitor.rtt_avg_ms * 7 + rtt) / 8 : rtt;
+    monitor.misses = 0;
+    monitor.state = LINK_UP;
+    monitor.next_ping_at = now + LINK_HEARTBEAT_MS;
+    finish_round(true);
+}
+
+static void handle_line(uint64_t now) {
+    monitor.line[monitor.line_len] = '\0';
+    monitor.line_len = 0;
+
+    if (!monitor.ping_pending) return;
+    if (strcmp(monitor.line, "PONG") == 0 || strstr(monitor.line, "TEST_OK") != NULL) {
+        handle_pong(now);
+    }
+}
+
+static void handle_miss(uint64_t now) {
+    if (monitor.misses < 255) monitor.misses++;
+    monitor.state = monitor.misses >= LINK_DOWN_MISSES ? LINK_DOWN : LINK_DEGRADED;
+    monitor.next_ping_at = now + LINK_HEARTBEAT_MS;
+    finish_round(false);
+}
+
+static void poll_line(uint64_t now) {
+    uint8_t byte;
+
+    while (uart_hardware_poll_byte(&byte)) {
+        if (byte == '\n') {
+            handle_line(now);
+        } else if (byte != '\r' && monitor.line_len < LINK_LINE_MAX - 1) {
+            monitor.line[monitor.line_len++] = (char)byte;
+        }
+    }
+}
+
+// El receptor del transporte sólo es del latido mientras espera su PONG
+static void poll_transport(uint64_t now) {
+    transport_poll(transport);
+    if (!monitor.ping_pending || !transport_rx_complete(transport)) return;
+
+    monitor.line_len = (uint8_t)transport_rx_length(transport);
+    handle_line(now);
+    // Otro mensaje (una respuesta tardía): seguir esperando el PONG
+    if (monitor.ping_pending) transport_set_rx_buffer(transport, (uint8_t*)monitor.line, LINK_LINE_MAX - 1);
+}
+
+static bool send_ping(void) {
+    if (!transport) return uart_hardware_send_string("PING\n");
+    transport_set_rx_buffer(transport, (uint8_t*)monitor.line, LINK_LINE_MAX - 1);
+    return transport_send(transport, ping_message, sizeof(ping_message));
+}
+
+void link_monitor_tick(uint64_t now) {
+    if (transport) {
+        poll_transport(now);
+    } else {
+        poll_line(now);
+    }
+
+    if (monitor.ping_pending && now - monitor.ping_sent_at >= LINK_PING_TIMEOUT_MS) {
+        handle_miss(now);
+    }
+
+    if (!monitor.ping_pending && now >= monitor.next_ping_at) {
+        monitor.line_len = 0;
+        if (send_ping()) {
+            monitor.ping_pending = true;
+            monitor.ping_sent_at = now;
+        } else {
+            handle_miss(now);
+        }
+    }
+}
+
+void link_monitor_probe(uint64_t now) {
+    if (!monitor.ping_pending) monitor.next_ping_at = now;
+}
+
+// Una petición por el transporte se queda con el receptor y descarta ella el
+// PONG del latido que siguiera en vuelo: ese latido no cuenta como perdido
+static void release_receiver(void) {
+    if (transport) monitor.ping_pending = false;
+}
+
+void link_monitor_note_alive(uint64_t now) {
+    release_receiver();
+    monitor.misses = 0;
+    monitor.state = LINK_UP;
+    monitor.next_ping_at = now + LINK_HEARTBEAT_MS;
+}
+
+void link_monitor_note_failure(uint64_t now) {
+    release_receiver();
+    // Un timeout puede ser la nube y no el enlace: degradar y comprobar ya
+    if (monitor.state == LINK_UP || monitor.state == LINK_UNKNOWN) {
+        monitor.state = LINK_DEGRADED;
+    }
+    link_monitor_probe(now);
+}
+
+void link_monitor_note_pong(uint64_t now) {
+    if (monitor.ping_pending) handle_pong(now);
+}
+
+LinkState link_monitor_state(void) {
+    return monitor.state;
+}
+
+bool link_monitor_is_down(void) {
+    return monitor.state == LINK_DOWN;
+}
+
+uint32_t link_monitor_rtt_ms(void) {
+    return monitor.rtt_ms;
+}
+
+uint32_t link_monitor_rtt_avg_ms(void) {
+    return monitor.rtt_avg_ms;
+}
+
+bool link_monitor_ping_pending(void) {
+    return monitor.ping_pending;
+}
+
+uint32_t link_monitor_rounds(void) {
+    return monitor.rounds;
+}
+
+bool link_monitor_last_ok(void) {
+    return monitor.last_ok;
+}
+
+const char* link_state_name(LinkState state) {
+    switch (state) {
+        case LINK_UP:       return "UP";
+        case LINK_DEGRADED: return "DEGRADED";
+        case LINK_DOWN:     return "DOWN";
+        default:            return "CHECKING";
+    }
+}
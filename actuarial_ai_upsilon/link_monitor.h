@@ -0,0 +1,64 @@
+// Latido en segundo plano hacia el Pi (link_monitor.c)
+//
+// Cada LINK_HEARTBEAT_MS se envía "PING\n" sin bloquear y se espera "PONG"
+// (o "TEST_OK") mientras el bucle principal sigue corriendo. El estado del
+// enlace y el RTT medido quedan en caché para la cabecera y para que las
+// peticiones fallen al instante si el Pi no responde.
+//
+// Con el transporte fiable (ACTUARIAL_RELIABLE_LINK) el latido no puede ir
+// como texto suelto entre las tramas: link_monitor_use_transport() hace que
+// "PING" y "PONG" viajen como mensajes del transporte.
+
+#ifndef LINK_MONITOR_H
+#define LINK_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "uart_transport.h"
+
+#define LINK_HEARTBEAT_MS     3000
+#define LINK_PING_TIMEOUT_MS  1000
+#define LINK_DOWN_MISSES      3      // Latidos perdidos seguidos para darlo por caído
+
+typedef enum {
+    LINK_UNKNOWN,    // Aún no hubo respuesta ni fallo
+    LINK_UP,
+    LINK_DEGRADED,   // Se perdió algún latido
+    LINK_DOWN
+} LinkState;
+
+void link_monitor_init(uint64_t now);
+
+// Latido por mensajes del transporte en lugar de líneas; NULL vuelve a las
+// líneas. Quien haga un intercambio por el mismo transporte debe llamar
+// después a note_alive() o note_failure(), que le ceden el receptor.
+void link_monitor_use_transport(Transport* t);
+
+// Llamar en cada vuelta del bucle principal: lee bytes pendientes, envía el
+// siguiente latido cuando toca y vence los que no tuvieron respuesta.
+void link_monitor_tick(uint64_t now);
+
+// Adelanta el próximo latido (p. ej. "Test Connection")
+void link_monitor_probe(uint64_t now);
+
+// Tráfico normal también informa del estado del enlace
+void link_monitor_note_alive(uint64_t now);
+void link_monitor_note_failure(uint64_t now);
+
+// Quien lea de la línea un PONG que no era suyo lo entrega aquí: cierra el
+// latido pendiente en lugar de dejarlo vencer como perdido
+void link_monitor_note_pong(uint64_t now);
+
+LinkState link_monitor_state(void);
+bool link_monitor_is_down(void);
+uint32_t link_monitor_rtt_ms(void);       // Último RTT medido
+uint32_t link_monitor_rtt_avg_ms(void);   // Media móvil (1/8)
+bool link_monitor_ping_pending(void);
+
+// Latidos terminados (con respuesta o vencidos) y resultado del último
+uint32_t link_monitor_rounds(void);
+bool link_monitor_last_ok(void);
+
+const char* link_state_name(LinkState state);
+
+#endif
@@ -0,0 +1,98 @@
+// Marca de agua de la pila y pico de arena por estado
+
+#include "mem_monitor.h"
+#include "arena.h"
+
+#define PAINT_WORD   0xA5A5A5A5u
+#define PAINT_GUARD  512    // Bajo extapp_main sin pintar: marcos de este módulo
+
+// Fondo de la pila de la app, del linker script del firmware (ion). Débil:
+// sin él (en el host, con pilas de megas) sólo limita MEM_STACK_PAINT_BYTES.
+extern uint32_t _stack_end[] __attribute__((weak));
+
+static volatile uint32_t* paint_low;    // Palabra más profunda pintada
+static volatile uint32_t* paint_high;   // Fin de la zona pintada (exclusivo)
+static uintptr_t top;
+
+static MemStateStats states[MEM_MONITOR_STATES];
+static uint32_t high_water;
+static uint32_t frame_arena;
+static bool saturated;
+
+static __attribute__((noinline)) void paint(volatile uint32_t* from, volatile uint32_t* to) {
+    for (volatile uint32_t* word = from; word < to; word++) {
+        *word = PAINT_WORD;
+    }
+}
+
+// Mismo nivel de llamada que mem_monitor_frame(): ambos parten del marco
+// de extapp_main, así la zona de guarda cubre a los dos
+__attribute__((noinline)) void mem_monitor_begin(void) {
+    volatile uint32_t marker = 0;
+    top = (uintptr_t)&marker & ~(uintptr_t)(sizeof(uint32_t) - 1);
+    uintptr_t low = top - MEM_STACK_PAINT_BYTES;
+    uintptr_t limit = (uintptr_t)_stack_end;
+    if (limit && low < limit) low = limit;
+
+    mem_monitor_reset_stats();
+    if (low + sizeof(uint32_t) > top - PAINT_GUARD) {
+        paint_low = NULL;       // Sin sitio por debajo de la guarda: no se mide
+        return;
+    }
+    paint_high = (volatile uint32_t*)(top - PAINT_GUARD);
+    paint_low = (volatile uint32_t*)low;
+    paint(paint_low, paint_high);
+}
+
+size_t mem_monitor_stack_painted(void) {
+    return paint_low ? (size_t)(top - (uintptr_t)paint_low) : 0;
+}
+
+__attribute__((noinline)) void mem_monitor_frame(uint8_t state) {
+    if (!paint_low) return;
+
+    // Desde el fondo hacia arriba hasta la primera palabra tocada
+    volatile uint32_t* word = paint_low;
+    while (word < paint_high && *word == PAINT_WORD) word++;
+
+    uint32_t used = (uint32_t)(top - (uintptr_t)word);
+    if (word == paint_low) saturated = true;
+    // Lo que hay entre `word` y la guarda ya no está en uso: se repinta
+    paint(word, paint_high);
+
+    frame_arena = (uint32_t)arena_take_peak();
+    if (used > high_water) high_water = used;
+
+    if (state >= MEM_MONITOR_STATES) return;
+    MemStateStats* s = &states[state];
+    s->frames++;
+    if (used > s->stack_peak) s->stack_peak = used;
+    if (frame_arena > s->arena_peak) s->arena_peak = frame_arena;
+}
+
+size_t mem_monitor_stack_high_water(void) {
+    return high_water;
+}
+
+bool mem_monitor_stack_saturated(void) {
+    return saturated;
+}
+
+const MemStateStats* mem_monitor_state(uint8_t state) {
+    static const MemStateStats empty;
+    return state < MEM_MONITOR_STATES ? &states[state] : &empty;
+}
+
+size_t mem_monitor_frame_arena(void) {
+    return frame_arena;
+}
+
+void mem_monitor_reset_stats(void) {
+    for (int i = 0; i < MEM_MONITOR_STATES; i++) {
+        states[i].frames = 0;
+        states[i].stack_peak = 0;
+        states[i].arena_peak = 0;
+    }
+    high_water = 0;
+    saturated = false;
+}
@@ -0,0 +1,51 @@
+// Instrumentación de memoria de la app (mem_monitor.c)
+//
+// Pila: al arrancar se pintan MEM_STACK_PAINT_BYTES por debajo del marco de
+// extapp_main con un patrón fijo. La marca de agua es el punto más profundo
+// en el que el patrón ya no está. Al cerrar cada frame la medida se atribuye
+// al estado que lo ejecutó y se repinta sólo la zona usada, así cada estado
+// guarda su propio máximo. La arena (arena.c) se mide igual, por frame.
+//
+// Sólo se pinta por debajo de extapp_main y nunca por debajo del fondo de
+// la pila (_stack_end del linker script del firmware): si al firmware le
+// quedan menos de MEM_STACK_PAINT_BYTES, se pinta lo que hay.
+
+#ifndef MEM_MONITOR_H
+#define MEM_MONITOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MEM_STACK_PAINT_BYTES  4096
+#define MEM_MONITOR_STATES     10
+
+typedef struct {
+    uint32_t frames;
+    uint32_t stack_peak;    // Bytes por debajo de extapp_main
+    uint32_t arena_peak;
+} MemStateStats;
+
+// Llamar desde extapp_main, antes de nada más
+void mem_monitor_begin(void);
+
+// Fin de un frame ejecutado en `state` (índice < MEM_MONITOR_STATES)
+void mem_monitor_frame(uint8_t state);
+
+// Máximo de pila de todos los estados desde el arranque
+size_t mem_monitor_stack_high_water(void);
+
+// Bytes bajo extapp_main que cubre la zona pintada (0: no se pudo pintar)
+size_t mem_monitor_stack_painted(void);
+
+// La pila llegó al fondo de la zona pintada: la marca de agua es un mínimo
+bool mem_monitor_stack_saturated(void);
+
+const MemStateStats* mem_monitor_state(uint8_t state);
+
+// Arena del último frame cerrado (sonda de RAM del shim en el host)
+size_t mem_monitor_frame_arena(void);
+
+void mem_monitor_reset_stats(void);
+
+#endif
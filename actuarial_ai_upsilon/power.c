@@ -0,0 +1,34 @@
+// Esperas con WFI en lugar de bucles activos
+
+#include <extapp_api.h>
+#include "power.h"
+
+#ifdef UART_HW_EMULATED
+extern void extapp_shim_idle(uint32_t ms);
+#endif
+
+static PowerStats stats;
+
+void power_wait(void) {
+    uint64_t before = extapp_millis();
+#ifdef UART_HW_EMULATED
+    extapp_shim_idle(1);
+#else
+    // DSB: que las escrituras pendientes (p. ej. al LCD) terminen antes de dormir
+    __asm__ volatile ("dsb\n\twfi" ::: "memory");
+#endif
+    stats.wakeups++;
+    stats.idle_ms += extapp_millis() - before;
+}
+
+void power_sleep(uint32_t ms) {
+    uint64_t start = extapp_millis();
+    stats.sleeps++;
+    while (extapp_millis() - start < ms) {
+        power_wait();
+    }
+}
+
+void power_get_stats(PowerStats* out) {
+    *out = stats;
+}
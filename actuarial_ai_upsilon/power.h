@@ -0,0 +1,34 @@
+// Esperas con el núcleo dormido (power.c)
+//
+// extapp_msleep() del firmware espera en un bucle activo, igual que el
+// sondeo del UART durante los hasta 30 s que tarda el Pi en consultar la
+// nube: el núcleo corre a 216 MHz sin hacer nada. Aquí cada espera es un
+// WFI: el Cortex-M7 para el reloj del núcleo hasta la siguiente
+// interrupción (el SysTick de 1 ms del firmware, el UART/DMA o el
+// teclado) y sólo despierta para mirar si ya toca seguir.
+//
+// En el host (UART_HW_EMULATED) cada WFI adelanta 1 ms el reloj virtual
+// del shim como tiempo inactivo (extapp_shim_idle).
+
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t sleeps;        // power_sleep()
+    uint32_t wakeups;       // WFI terminados
+    uint64_t idle_ms;       // Tiempo dormido según extapp_millis()
+} PowerStats;
+
+// Sustituye a extapp_msleep(): duerme hasta que pasen `ms`
+void power_sleep(uint32_t ms);
+
+// Un solo WFI: vuelve en la siguiente interrupción (1 ms como mucho). Para
+// esperas que sondean algo, como uart_hardware_receive_byte().
+void power_wait(void);
+
+void power_get_stats(PowerStats* stats);
+
+#endif
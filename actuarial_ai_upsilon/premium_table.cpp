@@ -0,0 +1,18 @@
+// Tabla de primas por edad y plazo (fachada en C del motor)
+
+#include "premium_table.h"
+#include "engine/premium_schedule.h"
+
+using namespace actuarial;
+
+static const ScheduleGrid kGrid = { PREMIUM_TABLE_MIN_AGE, PREMIUM_TABLE_MAX_AGE,
+                                    PREMIUM_TABLE_MIN_TERM, PREMIUM_TABLE_MAX_TERM };
+
+// Supervivencia de 18 a 105 años, descuento a 30 y dos acumuladores por edad
+static double work[(PREMIUM_TABLE_MAX_AGE - PREMIUM_TABLE_MIN_AGE + PREMIUM_TABLE_MAX_TERM + 1) +
+                   (PREMIUM_TABLE_MAX_TERM + 1) + 2 * PREMIUM_TABLE_AGES];
+
+void premium_table_fill(uint16_t rate_bp, float out[PREMIUM_TABLE_CELLS]) {
+    premium_schedule<Annual, Due>(kStandardUltimate, rate_bp / 10000.0, kGrid, work, out);
+    for (int i = 0; i < PREMIUM_TABLE_CELLS; i++) out[i] *= 1000.0f;
+}
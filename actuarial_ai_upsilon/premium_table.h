@@ -0,0 +1,35 @@
+// Tabla de primas por edad y plazo para la pantalla "Premium Schedule"
+// (premium_table.cpp)
+//
+// Fachada en C sobre engine/premium_schedule.h: la app es C y el motor
+// C++11. Toda la tabla sale en una pasada sobre vectores compartidos, sin
+// pasar por el Pi. Base fija: Standard Ultimate Survival Model, prima anual
+// pagadera al principio de cada año. `make engine-bench` la compara celda
+// a celda con term_premium y `make schedule-csv` la exporta a CSV.
+
+#ifndef PREMIUM_TABLE_H
+#define PREMIUM_TABLE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PREMIUM_TABLE_MIN_AGE   18
+#define PREMIUM_TABLE_MAX_AGE   75
+#define PREMIUM_TABLE_MIN_TERM  5
+#define PREMIUM_TABLE_MAX_TERM  30
+#define PREMIUM_TABLE_AGES      (PREMIUM_TABLE_MAX_AGE - PREMIUM_TABLE_MIN_AGE + 1)
+#define PREMIUM_TABLE_TERMS     (PREMIUM_TABLE_MAX_TERM - PREMIUM_TABLE_MIN_TERM + 1)
+#define PREMIUM_TABLE_CELLS     (PREMIUM_TABLE_AGES * PREMIUM_TABLE_TERMS)
+
+// Prima por cada 1000 de capital al interés `rate_bp` (500 = 5.00%):
+// out[edad * PREMIUM_TABLE_TERMS + plazo], relativos a los mínimos
+void premium_table_fill(uint16_t rate_bp, float out[PREMIUM_TABLE_CELLS]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
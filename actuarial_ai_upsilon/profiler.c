@@ -0,0 +1,132 @@
+// Tiempos por etapa: último y peor, con superposición en pantalla
+
+#include <extapp_api.h>
+#include <stdio.h>
+#include <string.h>
+#include "profiler.h"
+#include "compositor.h"
+#include "trace.h"
+
+#ifdef UART_HW_EMULATED
+#include <time.h>
+#else
+#define DEMCR           0xE000EDFC
+#define DEMCR_TRCENA    (1u << 24)
+#define DWT_CTRL        0xE0001000
+#define DWT_CYCCNT      0xE0001004
+#define DWT_LAR         0xE0001FB0
+#define DWT_LAR_KEY     0xC5ACCE55
+#define DWT_CTRL_CYCCNTENA  (1u << 0)
+#define REG(addr)       (*(volatile uint32_t*)(addr))
+#endif
+
+#define OVERLAY_X       142
+#define OVERLAY_Y       48
+#define OVERLAY_W       178
+#define OVERLAY_LINE    13
+#define OVERLAY_BG      0x0000
+#define OVERLAY_FG      0xFFE0
+
+static ProfStageStats stages[PROF_STAGE_COUNT];
+static bool overlay;
+
+static const char* stage_names[PROF_STAGE_COUNT] = {
+    "encode", "send", "wait", "receive", "parse",
+    "menu", "edit", "result", "error", "diag", "history", "schedule", "present"
+};
+
+static uint32_t read_ticks(void) {
+#ifdef UART_HW_EMULATED
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000ull + ts.tv_nsec / 1000);
+#else
+    return REG(DWT_CYCCNT);
+#endif
+}
+
+void profiler_init(void) {
+#ifndef UART_HW_EMULATED
+    REG(DEMCR) |= DEMCR_TRCENA;
+    REG(DWT_LAR) = DWT_LAR_KEY;     // El M7 bloquea el DWT tras el reset
+    REG(DWT_CYCCNT) = 0;
+    REG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;
+#endif
+    profiler_reset();
+}
+
+ProfMark profiler_begin(void) {
+    ProfMark mark;
+    mark.millis = (uint32_t)extapp_millis();
+    mark.ticks = read_ticks();
+    return mark;
+}
+
+uint32_t profiler_elapsed_us(ProfMark from, ProfMark to) {
+#ifdef UART_HW_EMULATED
+    (void)from.millis;
+    return to.ticks - from.ticks;
+#else
+    // Resta en módulo 2^32: correcta mientras no pase una vuelta entera
+    uint32_t ms = to.millis - from.millis;
+    if (ms >= PROFILER_LONG_MS) return ms * 1000u;
+    return (to.ticks - from.ticks) / (PROFILER_CPU_HZ / 1000000u);
+#endif
+}
+
+static void record(ProfStage stage, uint32_t us) {
+    ProfStageStats* s = &stages[stage];
+    s->count++;
+    s->last_us = us;
+    if (us > s->worst_us) s->worst_us = us;
+    trace_event(TRACE_STAGE, (uint8_t)stage, 0, us);
+}
+
+void profiler_end(ProfStage stage, ProfMark mark) {
+    record(stage, profiler_elapsed_us(mark, profiler_begin()));
+}
+
+ProfMark profiler_lap(ProfStage stage, ProfMark mark) {
+    ProfMark now = profiler_begin();
+    record(stage, profiler_elapsed_us(mark, now));
+    return now;
+}
+
+const ProfStageStats* profiler_stage(ProfStage stage) {
+    return &stages[stage];
+}
+
+const char* profiler_stage_name(ProfStage stage) {
+    return stage_names[stage];
+}
+
+void profiler_reset(void) {
+    memset(stages, 0, sizeof(stages));
+}
+
+bool profiler_overlay_enabled(void) {
+    return overlay;
+}
+
+void profiler_toggle_overlay(void) {
+    overlay = !overlay;
+}
+
+void profiler_draw_overlay(void) {
+    if (!overlay) return;
+
+    compositor_fill(OVERLAY_X, OVERLAY_Y, OVERLAY_W, (PROF_STAGE_COUNT + 1) * OVERLAY_LINE + 4, OVERLAY_BG);
+    char line[32];
+    snprintf(line, sizeof(line), "%-8s %7s %7s", "stage", "last_us", "worst");
+    compositor_text_small(line, OVERLAY_X + 2, OVERLAY_Y + 2, OVERLAY_FG, OVERLAY_BG);
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        const ProfStageStats* s = &stages[i];
+        if (s->count == 0) {
+            snprintf(line, sizeof(line), "%-8s %7s %7s", stage_names[i], "-", "-");
+        } else {
+            snprintf(line, sizeof(line), "%-8s %7lu %7lu", stage_names[i],
+                     (unsigned long)s->last_us, (unsigned long)s->worst_us);
+        }
+        compositor_text_small(line, OVERLAY_X + 2, OVERLAY_Y + 2 + (i + 1) * OVERLAY_LINE, 0xFFFF, OVERLAY_BG);
+    }
+}
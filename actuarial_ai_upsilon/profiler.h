@@ -0,0 +1,76 @@
+// Perfilado por etapas (profiler.c)
+//
+// Cada etapa de la petición y del dibujo se mide con un par
+// profiler_begin()/profiler_end(), o con profiler_lap() cuando una etapa
+// empieza justo donde acaba la anterior. Se guarda la última duración y la
+// peor de cada etapa, en microsegundos.
+//
+// En el dispositivo el reloj es el contador de ciclos del Cortex-M7
+// (DWT->CYCCNT a PROFILER_CPU_HZ): una lectura de registro por sonda. El
+// contador da la vuelta a los ~19 s, así que las etapas de más de
+// PROFILER_LONG_MS (la espera al Pi) se miden con extapp_millis(). En el
+// host (UART_HW_EMULATED) se usa CLOCK_MONOTONIC: mide el trabajo real de
+// la CPU del host, no el reloj virtual del shim.
+//
+// La superposición (profiler_draw_overlay) pinta la tabla encima de
+// cualquier pantalla; se registra como capa del compositor.
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PROFILER_CPU_HZ     216000000u
+#define PROFILER_LONG_MS    10000u
+
+typedef enum {
+    // Petición al Pi
+    PROF_ENCODE,        // Registro de parámetros y consulta a la caché
+    PROF_SEND,          // uart_hardware_send_string
+    PROF_WAIT,          // Hasta el primer byte de la respuesta
+    PROF_RECEIVE,       // Resto de la línea
+    PROF_PARSE,         // Prefijo SOLUTION: y guardado en la caché
+    // Dibujo: describir la pantalla (incluye PROF_PRESENT)
+    PROF_DRAW_MENU,
+    PROF_DRAW_EDIT,
+    PROF_DRAW_RESULT,
+    PROF_DRAW_ERROR,
+    PROF_DRAW_DIAG,
+    PROF_DRAW_HISTORY,
+    PROF_DRAW_SCHEDULE,
+    PROF_PRESENT,       // compositor_end: bandas al LCD
+    PROF_STAGE_COUNT
+} ProfStage;
+
+typedef struct {
+    uint32_t ticks;         // Ciclos (dispositivo) o microsegundos (host)
+    uint32_t millis;
+} ProfMark;
+
+typedef struct {
+    uint32_t count;
+    uint32_t last_us;
+    uint32_t worst_us;
+} ProfStageStats;
+
+// Activa el contador de ciclos; llamar una vez al arrancar
+void profiler_init(void);
+
+ProfMark profiler_begin(void);
+void profiler_end(ProfStage stage, ProfMark mark);
+// Cierra `stage` y devuelve la marca con la que empieza la siguiente
+ProfMark profiler_lap(ProfStage stage, ProfMark mark);
+// Microsegundos entre dos marcas, sin registrar ninguna etapa
+uint32_t profiler_elapsed_us(ProfMark from, ProfMark to);
+
+const ProfStageStats* profiler_stage(ProfStage stage);
+const char* profiler_stage_name(ProfStage stage);
+void profiler_reset(void);
+
+bool profiler_overlay_enabled(void);
+void profiler_toggle_overlay(void);
+// Añade la tabla al frame en curso del compositor si está activada
+void profiler_draw_overlay(void);
+
+#endif
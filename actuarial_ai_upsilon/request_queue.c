@@ -0,0 +1,329 @@
+// Cola persistente de peticiones y tanda al volver el enlace
+
+#include <extapp_api.h>
+#include <string.h>
+#include "request_queue.h"
+#include "response_cache.h"
+#include "link_monitor.h"
+#include "uart_hardware.h"
+#include "uart_transport.h"
+#include "text_layout.h"
+#include "trace.h"
+
+#define QUEUE_MAGIC     0x51525441u     // "ATRQ"
+#define QUEUE_VERSION   1
+#define QUEUE_LINE_MAX  (9 + QUEUE_RESULT_SIZE + 1)    // "SOLUTION:" + resultado
+#define QUEUE_MESSAGE_MAX 40
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t sequence;      // Última secuencia asignada
+} QueueFileHeader;
+
+// Cabecera y entradas contiguas: el fichero se escribe de una vez
+static struct {
+    QueueFileHeader header;
+    QueueEntry entries[QUEUE_SLOTS];    // La más reciente primero
+} queue;
+
+// Tanda en curso: las respuestas llegan en el orden de envío
+static struct {
+    bool active;
+    uint32_t sequences[QUEUE_SLOTS];
+    uint32_t count;
+    uint32_t sent;          // Con el transporte salen de una en una
+    uint32_t next;
+    uint64_t last_activity;
+    char line[QUEUE_LINE_MAX];
+    uint16_t line_len;
+    bool truncated;
+    char message[QUEUE_MESSAGE_MAX];    // Vivo hasta que el transporte lo confirma
+} batch;
+
+static QueueStats stats;
+static Transport* transport;    // NULL: protocolo de líneas
+
+static void save(void) {
+    queue.header.magic = QUEUE_MAGIC;
+    queue.header.version = QUEUE_VERSION;
+    size_t bytes = sizeof(queue.header) + queue.header.count * sizeof(QueueEntry);
+    if (!extapp_fileWrite(QUEUE_FILE_NAME, (const char*)&queue, bytes, EXTAPP_RAM_FILE_SYSTEM)) {
+        stats.saves_failed++;
+    }
+}
+
+void request_queue_init(void) {
+    memset(&queue, 0, sizeof(queue));
+    memset(&batch, 0, sizeof(batch));
+    transport = NULL;
+
+    size_t len;
+    const char* data = extapp_fileRead(QUEUE_FILE_NAME, &len, EXTAPP_RAM_FILE_SYSTEM);
+    if (!data || len < sizeof(QueueFileHeader)) return;
+
+    QueueFileHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != QUEUE_MAGIC || header.version != QUEUE_VERSION || header.count > QUEUE_SLOTS ||
+        len != sizeof(header) + header.count * sizeof(QueueEntry)) {
+        return;     // Fichero de otra versión o dañado: se empieza de cero
+    }
+    memcpy(&queue, data, len);
+
+    for (uint32_t i = 0; i < queue.header.count; i++) {
+        QueueEntry* e = &queue.entries[i];
+        if (e->status == QUEUE_SENT) e->status = QUEUE_PENDING;
+        if (e->result_len > QUEUE_RESULT_SIZE) e->result_len = QUEUE_RESULT_SIZE;
+    }
+}
+
+void request_queue_use_transport(Transport* t) {
+    transport = t;
+}
+
+bool request_queue_add(const uint8_t record[CALC_RECORD_SIZE]) {
+    uint32_t count = queue.header.count;
+    for (uint32_t i = 0; i < count; i++) {
+        const QueueEntry* e = &queue.entries[i];
+        if (e->status == QUEUE_PENDING && memcmp(e->record, record, CALC_RECORD_SIZE) == 0) return true;
+    }
+
+    if (count == QUEUE_SLOTS) {
+        // Sitio de la entrada terminada más antigua; las pendientes no se pierden
+        int victim = -1;
+        for (int i = (int)count - 1; i >= 0 && victim < 0; i--) {
+            uint8_t status = queue.entries[i].status;
+            if (status == QUEUE_DONE || status == QUEUE_FAILED) victim = i;
+        }
+        if (victim < 0) {
+            stats.rejected++;
+            return false;
+        }
+        memmove(&queue.entries[victim], &queue.entries[victim + 1], (count - victim - 1) * sizeof(QueueEntry));
+        count--;
+    }
+
+    memmove(&queue.entries[1], &queue.entries[0], count * sizeof(QueueEntry));
+    QueueEntry* e = &queue.entries[0];
+    memset(e, 0, sizeof(*e));
+    memcpy(e->record, record, CALC_RECORD_SIZE);
+    e->status = QUEUE_PENDING;
+    e->sequence = ++queue.header.sequence;
+    queue.header.count = (uint16_t)(count + 1);
+    stats.queued++;
+    save();
+    return true;
+}
+
+uint32_t request_queue_pending(void) {
+    uint32_t pending = 0;
+    for (uint32_t i = 0; i < queue.header.count; i++) {
+        if (queue.entries[i].status == QUEUE_PENDING) pending++;
+    }
+    return pending;
+}
+
+static QueueEntry* find_sequence(uint32_t sequence) {
+    for (uint32_t i = 0; i < queue.header.count; i++) {
+        if (queue.entries[i].sequence == sequence) return &queue.entries[i];
+    }
+    return NULL;
+}
+
+static void set_result(QueueEntry* e, StrView text) {
+    e->result_len = (uint16_t)(text.len < QUEUE_RESULT_SIZE ? text.len : QUEUE_RESULT_SIZE);
+    memcpy(e->result, text.ptr, e->result_len);
+}
+
+// Mensaje de protocolo de una entrada, sin '\n'; 0 si el registro no vale
+static size_t entry_message(QueueEntry* e, char* message) {
+    CalcParams params;
+    if (!calc_params_decode(e->record, &params)) {
+        e->status = QUEUE_FAILED;
+        set_result(e, sv_from_cstr("Invalid request record"));
+        return 0;
+    }
+    return calc_params_to_message(&params, message, QUEUE_MESSAGE_MAX - 1);
+}
+
+static void mark_sent(QueueEntry* e, size_t len) {
+    trace_event(TRACE_UART_TX, (uint8_t)batch.message[0], (uint16_t)len, e->sequence);
+    e->attempts++;
+    batch.sent++;
+    stats.sent++;
+}
+
+// Siguiente entrada de la tanda por el transporte, tras la respuesta de la
+// anterior. Si el latido aún ocupa el emisor se reintenta en el próximo tick.
+static void send_next_framed(void) {
+    QueueEntry* e = find_sequence(batch.sequences[batch.sent]);
+    size_t len = e ? entry_message(e, batch.message) : 0;
+    if (len == 0) {
+        batch.sent++;
+        batch.next++;
+        return;
+    }
+    transport_set_rx_buffer(transport, (uint8_t*)batch.line, QUEUE_LINE_MAX - 1);
+    if (transport_send(transport, (const uint8_t*)batch.message, len)) mark_sent(e, len);
+}
+
+bool request_queue_flush_start(uint64_t now) {
+    if (batch.active) return false;
+    batch.count = 0;
+    batch.sent = 0;
+
+    // De la más antigua a la más reciente, todas seguidas
+    for (int i = (int)queue.header.count - 1; i >= 0; i--) {
+        QueueEntry* e = &queue.entries[i];
+        if (e->status != QUEUE_PENDING) continue;
+
+        // Con el transporte sólo se apuntan: salen desde request_queue_tick()
+        if (transport) {
+            e->status = QUEUE_SENT;
+            batch.sequences[batch.count++] = e->sequence;
+            continue;
+        }
+
+        size_t len = entry_message(e, batch.message);
+        if (len == 0) continue;
+        batch.message[len++] = '\n';
+        batch.message[len] = '\0';
+        if (!uart_hardware_send_string(batch.message)) break;     // El resto espera a la próxima tanda
+        mark_sent(e, len);
+
+        e->status = QUEUE_SENT;
+        batch.sequences[batch.count++] = e->sequence;
+    }
+    if (batch.count == 0) return false;
+
+    batch.active = true;
+    batch.next = 0;
+    batch.last_activity = now;
+    batch.line_len = 0;
+    batch.truncated = false;
+    stats.batches++;
+    save();
+    return true;
+}
+
+static void finish_batch(void) {
+    batch.active = false;
+    save();
+}
+
+static void handle_line(uint64_t now) {
+    StrView line = sv_make(batch.line, batch.line_len);
+    bool truncated = batch.truncated;
+    batch.line_len = 0;
+    batch.truncated = false;
+
+    // PONG de un latido que seguía en vuelo al empezar la tanda
+    if (sv_equals(line, "PONG")) {
+        link_monitor_note_pong(now);
+        return;
+    }
+
+    link_monitor_note_alive(now);
+    QueueEntry* e = find_sequence(batch.sequences[batch.next++]);
+    if (e) {
+        bool solution = text_strip_solution(&line);
+        set_result(e, line);
+        e->status = solution ? QUEUE_DONE : QUEUE_FAILED;
+        trace_event(TRACE_RESPONSE, solution, (uint16_t)line.len, e->sequence);
+        // Respuesta completa: repetir el cálculo ya no necesita al Pi
+        if (solution && !truncated) response_cache_store(e->record, line, NULL);
+        stats.answered++;
+    }
+    if (batch.next == batch.count) finish_batch();
+}
+
+static void expire_batch(uint64_t now) {
+    for (uint32_t i = batch.next; i < batch.count; i++) {
+        QueueEntry* e = find_sequence(batch.sequences[i]);
+        if (!e) continue;
+        if (e->attempts >= QUEUE_MAX_ATTEMPTS) {
+            e->status = QUEUE_FAILED;
+            set_result(e, sv_from_cstr("No response from Pi"));
+        } else {
+            e->status = QUEUE_PENDING;
+        }
+    }
+    stats.timeouts++;
+    link_monitor_note_failure(now);
+    finish_batch();
+}
+
+static void tick_lines(uint64_t now) {
+    uint8_t byte;
+
+    // Al cerrar la tanda los bytes que sigan son del latido
+    while (batch.active && uart_hardware_poll_byte(&byte)) {
+        batch.last_activity = now;
+        if (byte == '\n') {
+            handle_line(now);
+        } else if (byte == '\r') {
+            continue;
+        } else if (batch.line_len < QUEUE_LINE_MAX - 1) {
+            batch.line[batch.line_len++] = (char)byte;
+        } else {
+            batch.truncated = true;
+        }
+    }
+}
+
+// Una entrada en vuelo cada vez: su respuesta llega como un mensaje entero
+static void tick_framed(uint64_t now) {
+    transport_poll(transport);
+    if (batch.sent == batch.next) {
+        send_next_framed();
+        if (batch.next == batch.count) finish_batch();
+        return;
+    }
+    if (!transport_rx_complete(transport)) return;
+
+    batch.last_activity = now;
+    batch.line_len = (uint16_t)transport_rx_length(transport);
+    batch.truncated = transport_rx_truncated(transport);
+    handle_line(now);
+    // PONG de un latido: la respuesta sigue pendiente
+    if (batch.active && batch.sent > batch.next) {
+        transport_set_rx_buffer(transport, (uint8_t*)batch.line, QUEUE_LINE_MAX - 1);
+    }
+}
+
+void request_queue_tick(uint64_t now) {
+    if (!batch.active) return;
+    if (transport) {
+        tick_framed(now);
+    } else {
+        tick_lines(now);
+    }
+
+    if (batch.active && now - batch.last_activity >= QUEUE_TIMEOUT_MS) expire_batch(now);
+}
+
+bool request_queue_flushing(void) {
+    return batch.active;
+}
+
+uint32_t request_queue_count(void) {
+    return queue.header.count;
+}
+
+const QueueEntry* request_queue_entry(uint32_t index) {
+    return index < queue.header.count ? &queue.entries[index] : NULL;
+}
+
+const char* request_queue_status_name(QueueStatus status) {
+    switch (status) {
+        case QUEUE_PENDING: return "pending";
+        case QUEUE_SENT:    return "sent";
+        case QUEUE_DONE:    return "done";
+        default:            return "failed";
+    }
+}
+
+void request_queue_get_stats(QueueStats* out) {
+    *out = stats;
+}
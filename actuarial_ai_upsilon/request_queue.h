@@ -0,0 +1,83 @@
+// Cola de peticiones sin enlace e historial (request_queue.c)
+//
+// Una petición que no puede llegar al Pi (enlace caído o sin respuesta)
+// se guarda como registro de calc_params.h en una cola acotada que se
+// persiste en el almacenamiento de la calculadora (QUEUE_FILE_NAME), así
+// que sobrevive a salir de la app. Cuando el latido vuelve a ver el enlace,
+// request_queue_flush_start() envía todas las pendientes seguidas como una
+// tanda y request_queue_tick() recoge las respuestas sin bloquear, en el
+// mismo orden, mientras la interfaz sigue respondiendo. Igual que el
+// latido, usa el protocolo de líneas, o con request_queue_use_transport()
+// mensajes del transporte fiable, una petición en vuelo cada vez.
+//
+// Cada entrada guarda su resultado y forma el historial que la app muestra,
+// de la más reciente a la más antigua. Al llenarse se descarta la entrada
+// terminada más antigua; si todas siguen pendientes, la nueva se rechaza.
+
+#ifndef REQUEST_QUEUE_H
+#define REQUEST_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "calc_params.h"
+#include "uart_transport.h"
+
+#define QUEUE_SLOTS         6
+#define QUEUE_RESULT_SIZE   128     // Se guarda el principio de la respuesta
+#define QUEUE_FILE_NAME     "actuarial.queue"
+#define QUEUE_TIMEOUT_MS    30000   // Sin ningún byte del Pi durante la tanda
+#define QUEUE_MAX_ATTEMPTS  3       // Tandas sin respuesta antes de darla por fallida
+
+typedef enum {
+    QUEUE_PENDING,      // Espera al enlace
+    QUEUE_SENT,         // En la tanda en curso
+    QUEUE_DONE,         // Respuesta SOLUTION:
+    QUEUE_FAILED        // El Pi respondió con otra cosa o se agotaron los intentos
+} QueueStatus;
+
+typedef struct {
+    uint8_t record[CALC_RECORD_SIZE];
+    uint8_t status;         // QueueStatus
+    uint8_t attempts;
+    uint16_t result_len;
+    uint32_t sequence;      // Orden de llegada a la cola
+    char result[QUEUE_RESULT_SIZE];
+} QueueEntry;
+
+typedef struct {
+    uint32_t queued;
+    uint32_t rejected;      // Cola llena de pendientes
+    uint32_t batches;
+    uint32_t sent;
+    uint32_t answered;
+    uint32_t timeouts;      // Tandas que vencieron sin todas sus respuestas
+    uint32_t saves_failed;
+} QueueStats;
+
+// Carga la cola guardada; las que estaban en vuelo vuelven a pendientes
+void request_queue_init(void);
+
+// Tandas por mensajes del transporte en lugar de líneas; NULL vuelve a las
+// líneas
+void request_queue_use_transport(Transport* t);
+
+// false si la cola está llena de pendientes. Un registro que ya está
+// pendiente no se duplica.
+bool request_queue_add(const uint8_t record[CALC_RECORD_SIZE]);
+uint32_t request_queue_pending(void);
+
+// Envía la tanda; false si no había nada que enviar
+bool request_queue_flush_start(uint64_t now);
+// Mientras dura la tanda sustituye a link_monitor_tick(): consume las
+// líneas que llegan del Pi
+void request_queue_tick(uint64_t now);
+bool request_queue_flushing(void);
+
+// Historial: 0 es la entrada más reciente
+uint32_t request_queue_count(void);
+const QueueEntry* request_queue_entry(uint32_t index);
+
+const char* request_queue_status_name(QueueStatus status);
+void request_queue_get_stats(QueueStats* stats);
+
+#endif
@@ -0,0 +1,76 @@
+// Caché LRU de respuestas del Pi
+
+#include <string.h>
+#include "response_cache.h"
+
+typedef struct {
+    uint8_t record[CALC_RECORD_SIZE];
+    bool used;
+    uint16_t len;
+    uint32_t last_use;
+    SolutionFields fields;
+    char text[RESPONSE_CACHE_SLOT_SIZE];
+} Slot;
+
+static Slot slots[RESPONSE_CACHE_SLOTS];
+static uint32_t use_clock;
+static ResponseCacheStats stats;
+
+bool response_cache_find(const uint8_t record[CALC_RECORD_SIZE], StrView* response, SolutionFields* fields) {
+    for (int i = 0; i < RESPONSE_CACHE_SLOTS; i++) {
+        Slot* slot = &slots[i];
+        if (slot->used && memcmp(slot->record, record, CALC_RECORD_SIZE) == 0) {
+            slot->last_use = ++use_clock;
+            *response = sv_make(slot->text, slot->len);
+            if (fields) *fields = slot->fields;
+            stats.hits++;
+            return true;
+        }
+    }
+    stats.misses++;
+    return false;
+}
+
+bool response_cache_contains(const uint8_t record[CALC_RECORD_SIZE]) {
+    for (int i = 0; i < RESPONSE_CACHE_SLOTS; i++) {
+        if (slots[i].used && memcmp(slots[i].record, record, CALC_RECORD_SIZE) == 0) return true;
+    }
+    return false;
+}
+
+void response_cache_store(const uint8_t record[CALC_RECORD_SIZE], StrView response, const SolutionFields* fields) {
+    if (response.len > RESPONSE_CACHE_SLOT_SIZE) {
+        stats.too_long++;
+        return;
+    }
+
+    // Misma clave o, si no está, la ranura libre o la más antigua
+    Slot* target = &slots[0];
+    for (int i = 0; i < RESPONSE_CACHE_SLOTS; i++) {
+        Slot* slot = &slots[i];
+        if (slot->used && memcmp(slot->record, record, CALC_RECORD_SIZE) == 0) {
+            target = slot;
+            break;
+        }
+        if (!slot->used || (target->used && slot->last_use < target->last_use)) target = slot;
+    }
+
+    memcpy(target->record, record, CALC_RECORD_SIZE);
+    memcpy(target->text, response.ptr, response.len);
+    target->len = (uint16_t)response.len;
+    // Los desplazamientos son relativos al texto: valen también en la copia
+    if (fields) target->fields = *fields;
+    else solution_parse(sv_make(target->text, target->len), &target->fields);
+    target->used = true;
+    target->last_use = ++use_clock;
+    stats.stored++;
+}
+
+void response_cache_clear(void) {
+    memset(slots, 0, sizeof(slots));
+    use_clock = 0;
+}
+
+void response_cache_get_stats(ResponseCacheStats* out) {
+    *out = stats;
+}
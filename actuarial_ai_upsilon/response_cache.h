@@ -0,0 +1,39 @@
+// Caché de respuestas por registro de parámetros (response_cache.c)
+//
+// La clave es el registro binario de calc_params.h: los mismos parámetros
+// dan los mismos bytes, así que repetir un cálculo no vuelve a pasar por el
+// Pi (y funciona aunque el enlace esté caído). Al llenarse se reemplaza la
+// entrada usada hace más tiempo. Las respuestas más largas que una ranura
+// no se guardan. Cada ranura guarda también los campos numéricos de la
+// respuesta (solution_fields.h), analizados una sola vez al guardarla.
+
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "calc_params.h"
+#include "strview.h"
+#include "solution_fields.h"
+
+#define RESPONSE_CACHE_SLOTS      4
+#define RESPONSE_CACHE_SLOT_SIZE  384
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t stored;
+    uint32_t too_long;
+} ResponseCacheStats;
+
+// La vista apunta a la ranura y vale hasta el siguiente response_cache_store.
+// Con `fields` copia además sus campos, relativos a la vista.
+bool response_cache_find(const uint8_t record[CALC_RECORD_SIZE], StrView* response, SolutionFields* fields);
+// Sólo consulta: no cuenta como acierto ni refresca la entrada
+bool response_cache_contains(const uint8_t record[CALC_RECORD_SIZE]);
+// `fields` son los de `response` si ya se analizaron; con NULL se analiza aquí
+void response_cache_store(const uint8_t record[CALC_RECORD_SIZE], StrView response, const SolutionFields* fields);
+void response_cache_clear(void);
+void response_cache_get_stats(ResponseCacheStats* stats);
+
+#endif
@@ -0,0 +1,238 @@
+// Campos numéricos con etiqueta, analizados sobre la respuesta
+
+#include "solution_fields.h"
+
+#define SPAN_MAX  255
+
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+// Fin de segmento: ',', ';', '\n' o un punto final de frase
+static bool is_separator(const char* text, size_t i, size_t len) {
+    char c = text[i];
+    if (c == ',' || c == ';' || c == '\n') return true;
+    return c == '.' && (i + 1 == len || text[i + 1] == ' ' || text[i + 1] == '\n');
+}
+
+static bool is_prefix(char c) {
+    return c == '-' || c == '+' || c == '$';
+}
+
+// ¿Empieza un número en `i`? Hasta dos de signo y '$' ("-$5", "$-5") y
+// luego una cifra o ".cifra". Tiene que ir al principio de una palabra.
+static bool number_starts(const char* text, size_t i, size_t len, size_t segment) {
+    if (i > segment && text[i - 1] != ' ' && text[i - 1] != ':' && text[i - 1] != '(') return false;
+    for (int n = 0; n < 2 && i < len && is_prefix(text[i]); n++) i++;
+    if (i < len && is_digit(text[i])) return true;
+    return i + 1 < len && text[i] == '.' && is_digit(text[i + 1]);
+}
+
+static SolutionSpan make_span(size_t from, size_t to) {
+    if (to - from > SPAN_MAX) to = from + SPAN_MAX;
+    SolutionSpan span = { (uint16_t)from, (uint8_t)(to - from) };
+    return span;
+}
+
+// Lee el número que empieza en `*pos` y deja `*pos` detrás (y detrás del
+// '%'). false si tiene más cifras enteras de las que se guardan.
+static bool parse_number(const char* text, size_t* pos, size_t len, SolutionField* field) {
+    size_t i = *pos;
+    bool negative = false;
+    field->unit = SOLUTION_PLAIN;
+    for (int n = 0; n < 2 && i < len && is_prefix(text[i]); n++, i++) {
+        if (text[i] == '$') field->unit = SOLUTION_CURRENCY;
+        else if (text[i] == '-') negative = true;
+    }
+
+    int64_t mantissa = 0;
+    int digits = 0;             // Significativas
+    uint8_t decimals = 0;
+    bool fraction = false;
+    while (i < len) {
+        char c = text[i];
+        if (is_digit(c)) {
+            if (digits < SOLUTION_MAX_DIGITS) {
+                if (mantissa || c != '0') digits++;
+                mantissa = mantissa * 10 + (c - '0');
+                if (fraction) decimals++;
+            } else if (!fraction) {
+                return false;
+            }
+            i++;
+        } else if (c == ',' && !fraction && i > *pos && is_digit(text[i - 1]) && i + 3 < len &&
+                   is_digit(text[i + 1]) && is_digit(text[i + 2]) && is_digit(text[i + 3]) &&
+                   (i + 4 >= len || !is_digit(text[i + 4]))) {
+            i++;                // Miles: "8,234"
+        } else if (c == '.' && !fraction && i + 1 < len && is_digit(text[i + 1])) {
+            fraction = true;
+            i++;
+        } else {
+            break;
+        }
+    }
+    if (i < len && text[i] == '%') {
+        field->unit = SOLUTION_PERCENT;
+        i++;
+    }
+
+    field->mantissa = negative ? -mantissa : mantissa;
+    field->decimals = decimals;
+    *pos = i;
+    return true;
+}
+
+size_t solution_parse(StrView response, SolutionFields* out) {
+    const char* text = response.ptr;
+    size_t len = response.len > UINT16_MAX ? UINT16_MAX : response.len;
+    out->count = 0;
+    out->dropped = 0;
+
+    size_t pos = 0;
+    while (pos < len) {
+        size_t segment = pos;
+        size_t i = segment;
+        while (i < len && !is_separator(text, i, len) && !number_starts(text, i, len, segment)) i++;
+        if (i >= len || is_separator(text, i, len)) {
+            pos = i + 1;        // Segmento sin número
+            continue;
+        }
+
+        // Etiqueta: lo que hay antes del número, sin lo anterior a un ':'
+        // ("Term Life: Age 35"); si el ':' va justo antes del número, lo que
+        // le precede ("Premium: $45.67")
+        size_t label_from = segment, label_to = i;
+        while (label_to > label_from && text[label_to - 1] == ' ') label_to--;
+        if (label_to > label_from && text[label_to - 1] == ':') label_to--;
+        for (size_t k = segment; k < label_to; k++) {
+            if (text[k] == ':') label_from = k + 1;
+        }
+        while (label_from < label_to && text[label_from] == ' ') label_from++;
+        while (label_to > label_from && text[label_to - 1] == ' ') label_to--;
+
+        SolutionField field;
+        bool valid = parse_number(text, &i, len, &field);
+
+        // Sufijo: hasta el separador, sin espacios en los extremos
+        while (i < len && text[i] == ' ') i++;
+        size_t suffix_from = i;
+        while (i < len && !is_separator(text, i, len)) i++;
+        size_t suffix_to = i;
+        while (suffix_to > suffix_from && text[suffix_to - 1] == ' ') suffix_to--;
+        pos = i + 1;
+
+        if (!valid) continue;
+        if (out->count == SOLUTION_MAX_FIELDS) {
+            out->dropped++;
+            continue;
+        }
+        field.label = make_span(label_from, label_to);
+        field.suffix = make_span(suffix_from, suffix_to);
+        out->fields[out->count++] = field;
+    }
+    return out->count;
+}
+
+StrView solution_span(StrView response, SolutionSpan span) {
+    return sv_take(sv_drop(response, span.offset), span.len);
+}
+
+const SolutionField* solution_find(const SolutionFields* fields, StrView response, const char* label) {
+    size_t n = strlen(label);
+    for (uint8_t i = 0; i < fields->count; i++) {
+        StrView candidate = solution_span(response, fields->fields[i].label);
+        if (candidate.len != n) continue;
+        size_t k = 0;
+        while (k < n && lower(candidate.ptr[k]) == lower(label[k])) k++;
+        if (k == n) return &fields->fields[i];
+    }
+    return NULL;
+}
+
+int solution_compare(const SolutionField* a, const SolutionField* b) {
+    // Se escala el de menos decimales; si se desborda, su magnitud es mayor
+    // que cualquier mantisa guardada y decide el signo
+    bool swap = a->decimals > b->decimals;
+    const SolutionField* lo = swap ? b : a;
+    const SolutionField* hi = swap ? a : b;
+    int64_t scaled = lo->mantissa;
+    for (int d = lo->decimals; d < hi->decimals; d++) {
+        if (scaled > INT64_MAX / 10 || scaled < INT64_MIN / 10) {
+            int sign = scaled > 0 ? 1 : -1;
+            return swap ? -sign : sign;
+        }
+        scaled *= 10;
+    }
+    int order = (scaled > hi->mantissa) - (scaled < hi->mantissa);
+    return swap ? -order : order;
+}
+
+double solution_value(const SolutionField* field) {
+    double value = (double)field->mantissa;
+    for (int d = 0; d < field->decimals; d++) value /= 10.0;
+    return value;
+}
+
+typedef struct {
+    char* out;
+    size_t cap;
+    size_t len;
+} Builder;
+
+static void put(Builder* b, char c) {
+    if (b->len + 1 < b->cap) b->out[b->len++] = c;
+}
+
+// Cifras de `value`, con ',' cada tres si `grouped` (sólo importes: un
+// "Table 2017 CSO" no lleva separador)
+static void put_digits(Builder* b, uint64_t value, bool grouped) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (n > 0) {
+        put(b, digits[--n]);
+        if (grouped && n > 0 && n % 3 == 0) put(b, ',');
+    }
+}
+
+size_t solution_format(const SolutionField* field, StrView response, char* out, size_t cap) {
+    if (cap == 0) return 0;
+    Builder b = { out, cap, 0 };
+    uint64_t magnitude = field->mantissa < 0 ? (uint64_t)(-field->mantissa) : (uint64_t)field->mantissa;
+    int decimals = field->decimals;
+
+    // Moneda siempre con dos decimales (redondeo al más cercano)
+    if (field->unit == SOLUTION_CURRENCY) {
+        for (; decimals > 2; decimals--) magnitude = (magnitude + (decimals == 3 ? 5 : 0)) / 10;
+        for (; decimals < 2; decimals++) magnitude *= 10;
+    }
+    uint64_t scale = 1;
+    for (int d = 0; d < decimals; d++) scale *= 10;
+
+    if (field->mantissa < 0 && magnitude) put(&b, '-');
+    if (field->unit == SOLUTION_CURRENCY) put(&b, '$');
+    put_digits(&b, magnitude / scale, field->unit == SOLUTION_CURRENCY);
+    if (decimals) {
+        put(&b, '.');
+        uint64_t frac = magnitude % scale;
+        for (uint64_t s = scale / 10; s; s /= 10) put(&b, (char)('0' + frac / s % 10));
+    }
+    if (field->unit == SOLUTION_PERCENT) put(&b, '%');
+
+    // "20 years", "$45.67/month"
+    StrView suffix = solution_span(response, field->suffix);
+    if (!sv_empty(suffix)) {
+        char c = lower(suffix.ptr[0]);
+        if ((c >= 'a' && c <= 'z') || is_digit(c)) put(&b, ' ');
+        for (size_t i = 0; i < suffix.len; i++) put(&b, suffix.ptr[i]);
+    }
+    out[b.len] = '\0';
+    return b.len;
+}
@@ -0,0 +1,73 @@
+// Campos numéricos con etiqueta de una respuesta del Pi (solution_fields.c)
+//
+// "Premium: $45.67/month, Present Value: $8,234.56, Risk: Low" da dos
+// campos: Premium = 45.67 (moneda, sufijo "/month") y Present Value =
+// 8234.56. Los segmentos sin número ("Risk: Low") no son campos. Se separa
+// por ',', ';', '\n' y por '.' seguido de espacio o del final; una coma
+// entre dígitos ("8,234") es separador de miles.
+//
+// Se analiza en el sitio y sin reservar memoria: etiqueta y sufijo son
+// desplazamientos dentro de la respuesta (sin el prefijo "SOLUTION:"), así
+// que el resultado vale para cualquier copia del texto, como la de la caché
+// de respuestas. El valor es decimal exacto: mantisa entera y número de
+// decimales, comparable sin volver a leer el texto.
+
+#ifndef SOLUTION_FIELDS_H
+#define SOLUTION_FIELDS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "strview.h"
+
+#define SOLUTION_MAX_FIELDS     8
+#define SOLUTION_MAX_DIGITS     15      // Cifras significativas que se guardan
+#define SOLUTION_FORMAT_MAX     32      // solution_format con el sufijo
+
+typedef enum {
+    SOLUTION_PLAIN,
+    SOLUTION_CURRENCY,      // "$1,234.50"
+    SOLUTION_PERCENT        // "5.25%"
+} SolutionUnit;
+
+// Trozo de la respuesta: [offset, offset + len)
+typedef struct {
+    uint16_t offset;
+    uint8_t len;
+} SolutionSpan;
+
+typedef struct {
+    int64_t mantissa;       // valor = mantissa / 10^decimals
+    SolutionSpan label;     // "Present Value"
+    SolutionSpan suffix;    // "/month", "years"; vacío si no hay
+    uint8_t decimals;
+    uint8_t unit;           // SolutionUnit
+} SolutionField;
+
+typedef struct {
+    uint8_t count;
+    uint8_t dropped;        // Campos que no cupieron en `fields`
+    SolutionField fields[SOLUTION_MAX_FIELDS];
+} SolutionFields;
+
+// Analiza `response` (sin el prefijo) y devuelve el número de campos. Las
+// respuestas de más de 64 KB sólo se analizan hasta ahí.
+size_t solution_parse(StrView response, SolutionFields* out);
+
+// Etiqueta o sufijo como vista sobre `response`
+StrView solution_span(StrView response, SolutionSpan span);
+
+// Primer campo con esa etiqueta (sin distinguir mayúsculas), o NULL
+const SolutionField* solution_find(const SolutionFields* fields, StrView response, const char* label);
+
+// <0, 0 o >0 según el valor de `a` frente al de `b`, sin pasar por double
+int solution_compare(const SolutionField* a, const SolutionField* b);
+
+double solution_value(const SolutionField* field);
+
+// Valor con formato uniforme: moneda con dos decimales y miles con ',', y
+// el sufijo detrás ("$8,234.56", "5.25%", "20 years"). Recorta a
+// `cap - 1` bytes; devuelve los bytes escritos.
+size_t solution_format(const SolutionField* field, StrView response, char* out, size_t cap);
+
+#endif
@@ -1,3 +1,4 @@
 app_external_src += $(addprefix apps/external/app/,\
 	actuarial_ai.c \
+	text_layout.c \
 )
\ No newline at end of file
@@ -1,4 +1,23 @@
 app_external_src += $(addprefix apps/external/actuarial_ai/,\
 	actuarial_ai_complete.c \
 	uart_hardware.c \
+	uart_session.c \
+	uart_transport.c \
+	link_monitor.c \
+	calc_params.c \
+	response_cache.c \
+	request_queue.c \
+	speculate.c \
+	startup.c \
+	power.c \
+	text_layout.c \
+	solution_fields.c \
+	premium_table.cpp \
+	engine/mortality.cpp \
+	text_cache.c \
+	compositor.c \
+	arena.c \
+	mem_monitor.c \
+	profiler.c \
+	trace.c \
 ) 
\ No newline at end of file
@@ -1,3 +1,12 @@
 app_external_src += $(addprefix apps/external/actuarial_ai/,\
 	actuarial_ai_uart.c \
+	startup.c \
+	power.c \
+	text_layout.c \
+	text_cache.c \
+	compositor.c \
+	arena.c \
+	mem_monitor.c \
+	profiler.c \
+	trace.c \
 ) 
\ No newline at end of file
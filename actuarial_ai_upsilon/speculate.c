@@ -0,0 +1,218 @@
+// Petición especulativa de la fila resaltada o del editor
+
+#include <extapp_api.h>
+#include <string.h>
+#include "speculate.h"
+#include "response_cache.h"
+#include "link_monitor.h"
+#include "uart_hardware.h"
+#include "text_layout.h"
+
+#define SPECULATE_LINE_MAX  (9 + RESPONSE_CACHE_SLOT_SIZE + 1)    // "SOLUTION:" + lo que cabe en la caché
+
+static bool enabled;
+
+// Registro que el usuario tiene delante y desde cuándo
+static struct {
+    bool valid;
+    uint8_t record[CALC_RECORD_SIZE];
+    uint64_t since;
+} dwell;
+
+// Petición en vuelo
+static struct {
+    bool active;
+    bool cancelled;
+    uint8_t record[CALC_RECORD_SIZE];
+    uint64_t last_activity;
+    uint32_t bytes;         // Enviados y recibidos
+    char line[SPECULATE_LINE_MAX];
+    uint16_t line_len;
+    bool truncated;
+} job;
+
+// Respuestas especulativas que aún no pidió nadie, la más antigua primero
+static struct {
+    uint8_t record[CALC_RECORD_SIZE];
+    uint32_t bytes;
+} recent[SPECULATE_RECENT];
+static uint32_t recent_count;
+
+static SpeculateStats stats;
+
+static bool same(const uint8_t* a, const uint8_t* b) {
+    return memcmp(a, b, CALC_RECORD_SIZE) == 0;
+}
+
+static int find_recent(const uint8_t record[CALC_RECORD_SIZE]) {
+    for (uint32_t i = 0; i < recent_count; i++) {
+        if (same(recent[i].record, record)) return (int)i;
+    }
+    return -1;
+}
+
+static void drop_recent(uint32_t index) {
+    memmove(&recent[index], &recent[index + 1], (recent_count - index - 1) * sizeof(recent[0]));
+    recent_count--;
+}
+
+static void remember(const uint8_t record[CALC_RECORD_SIZE], uint32_t bytes) {
+    // La más antigua probablemente ya salió de la caché: trabajo perdido
+    if (recent_count == SPECULATE_RECENT) {
+        stats.unused++;
+        stats.wasted_bytes += recent[0].bytes;
+        drop_recent(0);
+    }
+    memcpy(recent[recent_count].record, record, CALC_RECORD_SIZE);
+    recent[recent_count].bytes = bytes;
+    recent_count++;
+}
+
+static void abandon(void) {
+    job.active = false;
+    if (job.cancelled) stats.cancelled++;
+    stats.wasted_bytes += job.bytes;
+}
+
+static void finish_line(uint64_t now) {
+    StrView line = sv_make(job.line, job.line_len);
+    bool truncated = job.truncated;
+    job.line_len = 0;
+    job.truncated = false;
+
+    // PONG de un latido que seguía en vuelo
+    if (sv_equals(line, "PONG")) {
+        link_monitor_note_pong(now);
+        return;
+    }
+
+    link_monitor_note_alive(now);
+    if (job.cancelled || truncated || !text_strip_solution(&line)) {
+        abandon();
+        return;
+    }
+    job.active = false;
+    response_cache_store(job.record, line, NULL);
+    stats.completed++;
+    remember(job.record, job.bytes);
+}
+
+static void feed(uint8_t byte, uint64_t now) {
+    job.bytes++;
+    job.last_activity = now;
+    if (byte == '\n') {
+        finish_line(now);
+    } else if (byte == '\r') {
+        return;
+    } else if (job.line_len < SPECULATE_LINE_MAX - 1) {
+        job.line[job.line_len++] = (char)byte;
+    } else {
+        job.truncated = true;
+    }
+}
+
+void speculate_set_enabled(bool on) {
+    enabled = on;
+    dwell.valid = false;    // Lo que esté en vuelo se cancela en el próximo frame
+}
+
+bool speculate_enabled(void) {
+    return enabled;
+}
+
+void speculate_hover(const uint8_t* record, uint64_t now, bool line_idle) {
+    if (!enabled) record = NULL;
+
+    // Lo que está en vuelo sólo vale si el usuario sigue ahí (o volvió)
+    if (job.active) job.cancelled = !record || !same(record, job.record);
+    if (!record) {
+        dwell.valid = false;
+        return;
+    }
+    if (!dwell.valid || !same(dwell.record, record)) {
+        dwell.valid = true;
+        memcpy(dwell.record, record, CALC_RECORD_SIZE);
+        dwell.since = now;
+        return;
+    }
+
+    if (job.active || !line_idle || now - dwell.since < SPECULATE_DWELL_MS) return;
+    if (find_recent(record) >= 0 || response_cache_contains(record)) return;
+
+    CalcParams params;
+    if (!calc_params_decode(record, &params)) return;
+    char message[40];
+    size_t len = calc_params_to_message(&params, message, sizeof(message) - 1);
+    message[len++] = '\n';
+    message[len] = '\0';
+    if (!uart_hardware_send_string(message)) return;
+
+    job.active = true;
+    job.cancelled = false;
+    memcpy(job.record, record, CALC_RECORD_SIZE);
+    job.last_activity = now;
+    job.bytes = (uint32_t)len;
+    job.line_len = 0;
+    job.truncated = false;
+    stats.started++;
+}
+
+void speculate_tick(uint64_t now) {
+    uint8_t byte;
+
+    // Al terminar, los bytes que sigan son del latido
+    while (job.active && uart_hardware_poll_byte(&byte)) {
+        feed(byte, now);
+    }
+
+    if (job.active && now - job.last_activity >= SPECULATE_TIMEOUT_MS) {
+        abandon();
+        link_monitor_note_failure(now);
+    }
+}
+
+bool speculate_busy(void) {
+    return job.active;
+}
+
+bool speculate_promote(const uint8_t record[CALC_RECORD_SIZE], uint32_t timeout_ms) {
+    dwell.valid = false;
+
+    // La de otro registro no se espera: la petición real sale detrás y la
+    // respuesta descartada se le pasa a speculate_claim_line()
+    if (job.active && !same(record, job.record)) {
+        job.cancelled = true;
+        return false;
+    }
+
+    bool in_flight = job.active;
+    if (in_flight) {
+        uint8_t byte;
+        while (job.active && uart_hardware_receive_byte(&byte, timeout_ms)) {
+            feed(byte, extapp_millis());
+        }
+        if (job.active) {
+            abandon();
+            link_monitor_note_failure(extapp_millis());
+            return false;
+        }
+    }
+
+    int index = find_recent(record);
+    if (index < 0) return false;
+    drop_recent((uint32_t)index);
+    stats.hits++;
+    if (in_flight) stats.promoted++;
+    return true;
+}
+
+bool speculate_claim_line(const char* line, uint64_t now) {
+    if (!job.active) return false;
+    while (*line) feed((uint8_t)*line++, now);
+    feed('\n', now);
+    return true;
+}
+
+void speculate_get_stats(SpeculateStats* out) {
+    *out = stats;
+}
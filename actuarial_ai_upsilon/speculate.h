@@ -0,0 +1,62 @@
+// Petición especulativa de lo que el usuario tiene delante (speculate.c)
+//
+// Con el modo activado (opcional, Shift en el menú), si el usuario se queda
+// SPECULATE_DWELL_MS sobre la misma fila del menú, o sobre los mismos
+// parámetros en el editor, se envía ya la petición de ese registro y la
+// respuesta se guarda en la caché de respuestas. Al pulsar OK el cálculo
+// suele estar hecho.
+//
+// Es de baja prioridad: sólo sale con el enlace arriba y la línea libre
+// (sin latido ni tanda de la cola en vuelo), y cualquier petición real la
+// adelanta. Como el protocolo de líneas no puede retirar lo ya enviado,
+// cancelar (moverse a otra fila) significa descartar la respuesta cuando
+// llegue; hasta entonces la línea sigue ocupada. Al pulsar OK,
+// speculate_promote() espera a la que esté en vuelo si es del mismo
+// registro; si es de otro, la petición real sale detrás sin esperar y el
+// Pi contesta en orden: la primera línea que llega es la descartada.
+
+#ifndef SPECULATE_H
+#define SPECULATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "calc_params.h"
+
+#define SPECULATE_DWELL_MS    600
+#define SPECULATE_TIMEOUT_MS  30000
+#define SPECULATE_RECENT      4     // Respuestas especulativas pendientes de uso que se siguen
+
+typedef struct {
+    uint32_t started;
+    uint32_t completed;     // Respuesta SOLUTION: guardada en la caché
+    uint32_t cancelled;     // Descartadas al llegar: el usuario ya no estaba ahí
+    uint32_t hits;          // OK servido por una respuesta especulativa
+    uint32_t promoted;      // ...de ellas, todavía en vuelo al pulsar OK
+    uint32_t unused;        // Completadas que salieron de la lista sin usarse
+    uint32_t wasted_bytes;  // Bytes enviados y recibidos de canceladas y no usadas
+} SpeculateStats;
+
+void speculate_set_enabled(bool on);
+bool speculate_enabled(void);
+
+// Llamar en cada frame con el registro que se ve (NULL si ninguno). La
+// petición sólo sale si `line_idle`.
+void speculate_hover(const uint8_t* record, uint64_t now, bool line_idle);
+
+// Mientras hay una en vuelo sustituye a link_monitor_tick()
+void speculate_tick(uint64_t now);
+bool speculate_busy(void);
+
+// Antes de una petición real. true si la respuesta de `record` salió de
+// una petición especulativa (ya está en la caché); sólo bloquea si esa
+// está todavía en vuelo.
+bool speculate_promote(const uint8_t record[CALC_RECORD_SIZE], uint32_t timeout_ms);
+
+// Línea recibida por una petición real enviada detrás de una cancelada:
+// true si era de la especulativa (cuenta como bytes perdidos) y hay que
+// seguir esperando la propia
+bool speculate_claim_line(const char* line, uint64_t now);
+
+void speculate_get_stats(SpeculateStats* stats);
+
+#endif
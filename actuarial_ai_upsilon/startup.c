@@ -0,0 +1,68 @@
+// Arranque diferido e instrumentación del tiempo de inicio
+
+#include "startup.h"
+
+static struct {
+    StartupTask tasks[STARTUP_MAX_TASKS];
+    uint8_t count;
+    uint8_t next;
+    StartupClock clock;
+    uint64_t begin;
+    bool presented;
+    uint32_t first_frame_ms;
+    uint32_t ready_ms;
+} startup;
+
+static uint32_t elapsed_ms(void) {
+    return (uint32_t)(startup.clock() - startup.begin);
+}
+
+void startup_begin(StartupClock clock) {
+    startup.count = 0;
+    startup.next = 0;
+    startup.clock = clock;
+    startup.begin = clock();
+    startup.presented = false;
+    startup.first_frame_ms = 0;
+    startup.ready_ms = 0;
+}
+
+bool startup_defer(StartupTask task) {
+    if (startup.count == STARTUP_MAX_TASKS) return false;
+    startup.tasks[startup.count++] = task;
+    return true;
+}
+
+void startup_frame_presented(void) {
+    if (startup.presented) return;
+    startup.presented = true;
+    startup.first_frame_ms = elapsed_ms();
+    if (startup.count == 0) startup.ready_ms = startup.first_frame_ms;
+}
+
+bool startup_run_deferred(void) {
+    // Nada de trabajo de arranque antes de que el usuario vea el menú
+    if (!startup.presented || startup.next == startup.count) return false;
+
+    startup.tasks[startup.next++]();
+    if (startup.next == startup.count) {
+        startup.ready_ms = elapsed_ms();
+    }
+    return true;
+}
+
+bool startup_done(void) {
+    return startup.presented && startup.next == startup.count;
+}
+
+uint32_t startup_first_frame_ms(void) {
+    return startup.first_frame_ms;
+}
+
+uint32_t startup_ready_ms(void) {
+    return startup.ready_ms;
+}
+
+bool startup_within_budget(void) {
+    return startup.presented && startup.first_frame_ms <= STARTUP_BUDGET_MS;
+}
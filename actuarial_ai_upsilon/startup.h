@@ -0,0 +1,34 @@
+// Arranque rápido (startup.c)
+//
+// El primer frame es el menú: la inicialización de hardware y cachés se
+// encola con startup_defer() y se ejecuta de a una tarea por vuelta del
+// bucle principal, después de que el menú ya esté en pantalla.
+
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define STARTUP_MAX_TASKS   8
+#define STARTUP_BUDGET_MS   50   // Máximo hasta el primer frame interactivo
+
+typedef void (*StartupTask)(void);
+typedef uint64_t (*StartupClock)(void);
+
+// Llamar al entrar en extapp_main con el reloj de la app (extapp_millis)
+void startup_begin(StartupClock clock);
+bool startup_defer(StartupTask task);
+
+// Marca el primer frame que acepta teclado
+void startup_frame_presented(void);
+
+// Ejecuta la siguiente tarea diferida; false si ya no queda ninguna
+bool startup_run_deferred(void);
+
+bool startup_done(void);
+uint32_t startup_first_frame_ms(void);   // Entrada a extapp_main -> primer frame
+uint32_t startup_ready_ms(void);         // Entrada -> última tarea diferida
+bool startup_within_budget(void);
+
+#endif
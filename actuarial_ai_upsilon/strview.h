@@ -0,0 +1,50 @@
+// Vistas de texto sin copia
+//
+// Un StrView apunta a bytes que pertenecen a otro (la arena, un literal) y
+// no tiene por qué terminar en '\0'. Recortar o partir una vista no mueve
+// datos: sólo cambia el puntero y la longitud.
+
+#ifndef STRVIEW_H
+#define STRVIEW_H
+
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+
+typedef struct {
+    const char* ptr;
+    size_t len;
+} StrView;
+
+static inline StrView sv_make(const char* ptr, size_t len) {
+    StrView v = { ptr, len };
+    return v;
+}
+
+static inline StrView sv_from_cstr(const char* str) {
+    return sv_make(str, str ? strlen(str) : 0);
+}
+
+static inline bool sv_empty(StrView v) {
+    return v.len == 0;
+}
+
+static inline StrView sv_drop(StrView v, size_t n) {
+    if (n > v.len) n = v.len;
+    return sv_make(v.ptr + n, v.len - n);
+}
+
+static inline StrView sv_take(StrView v, size_t n) {
+    return sv_make(v.ptr, n < v.len ? n : v.len);
+}
+
+static inline bool sv_starts_with(StrView v, const char* prefix) {
+    size_t n = strlen(prefix);
+    return v.len >= n && memcmp(v.ptr, prefix, n) == 0;
+}
+
+static inline bool sv_equals(StrView v, const char* str) {
+    return v.len == strlen(str) && memcmp(v.ptr, str, v.len) == 0;
+}
+
+#endif
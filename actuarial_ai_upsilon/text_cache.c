@@ -0,0 +1,182 @@
+// Caché de textos fijos como sprites de 4 bits con paleta
+
+#include <extapp_api.h>
+#include <string.h>
+#include "text_cache.h"
+
+#define PALETTE_SIZE    16      // Entradas reservadas delante de cada sprite
+
+typedef struct {
+    uint64_t key;
+    uint32_t offset;        // En palabras de 16 bits dentro del pool
+    uint16_t width;
+    uint16_t height;
+} TextSprite;
+
+static uint16_t pool[TEXT_CACHE_BUDGET / sizeof(uint16_t)];
+static TextSprite sprites[TEXT_CACHE_ENTRIES];
+static uint32_t sprite_count;
+static uint32_t pool_used;                                  // Palabras
+static uint32_t pool_limit = TEXT_CACHE_BUDGET / sizeof(uint16_t);
+static uint16_t* scratch;
+static uint32_t scratch_pixels;
+static TextCacheStats stats;
+
+// FNV-1a de 64 bits sobre texto, fuente y colores
+static uint64_t sprite_key(const char* text, int large, uint16_t fg, uint16_t bg) {
+    uint64_t hash = 14695981039346656037ull;
+    while (*text) {
+        hash = (hash ^ (uint8_t)*text++) * 1099511628211ull;
+    }
+    uint32_t extra = ((uint32_t)fg << 16) | bg;
+    for (int i = 0; i < 4; i++) {
+        hash = (hash ^ (uint8_t)(extra >> (i * 8))) * 1099511628211ull;
+    }
+    return (hash ^ (uint64_t)large) * 1099511628211ull;
+}
+
+static const TextSprite* find_sprite(uint64_t key) {
+    for (uint32_t i = 0; i < sprite_count; i++) {
+        if (sprites[i].key == key) return &sprites[i];
+    }
+    return NULL;
+}
+
+// Paleta y después los índices, dos píxeles por byte
+static uint32_t sprite_words(uint32_t pixels) {
+    return PALETTE_SIZE + (pixels + 3) / 4;
+}
+
+static const uint8_t* sprite_indices(const TextSprite* s) {
+    return (const uint8_t*)&pool[s->offset + PALETTE_SIZE];
+}
+
+// Filas [row0, row0 + rows) del sprite en dst, con `stride` píxeles por fila
+static void decode_rows(const TextSprite* s, int row0, int rows, uint16_t* dst, uint32_t stride) {
+    const uint16_t* palette = &pool[s->offset];
+    const uint8_t* indices = sprite_indices(s);
+    for (int row = 0; row < rows; row++) {
+        uint32_t i = (uint32_t)(row0 + row) * s->width;
+        uint16_t* out = &dst[row * stride];
+        for (uint32_t col = 0; col < s->width; col++, i++) {
+            out[col] = palette[(indices[i / 2] >> ((i & 1) * 4)) & 0x0F];
+        }
+    }
+}
+
+static uint32_t rows_per_chunk(uint16_t width) {
+    return scratch_pixels / width;
+}
+
+static void push_sprite(const TextSprite* s, int16_t x, int16_t y) {
+    uint32_t chunk = rows_per_chunk(s->width);
+    for (uint32_t row = 0; row < s->height; row += chunk) {
+        uint32_t rows = s->height - row < chunk ? s->height - row : chunk;
+        decode_rows(s, (int)row, (int)rows, scratch, s->width);
+        extapp_pushRect(x, (int16_t)(y + row), s->width, (uint16_t)rows, scratch);
+    }
+}
+
+// Copia del LCD lo recién dibujado; false si tiene más de PALETTE_SIZE
+// colores (con las fuentes de 4 bits del firmware no pasa)
+static bool capture_sprite(TextSprite* s, int16_t x, int16_t y) {
+    uint16_t* palette = &pool[s->offset];
+    uint8_t* indices = (uint8_t*)&pool[s->offset + PALETTE_SIZE];
+    uint32_t colors = 0;
+    uint32_t chunk = rows_per_chunk(s->width);
+    uint32_t i = 0;
+
+    memset(indices, 0, (size_t)(s->width * s->height + 1) / 2);
+    for (uint32_t row = 0; row < s->height; row += chunk) {
+        uint32_t rows = s->height - row < chunk ? s->height - row : chunk;
+        uint32_t count = rows * s->width;
+        extapp_pullRect(x, (int16_t)(y + row), s->width, (uint16_t)rows, scratch);
+        for (uint32_t p = 0; p < count; p++, i++) {
+            uint32_t c = 0;
+            while (c < colors && palette[c] != scratch[p]) c++;
+            if (c == colors) {
+                if (colors == PALETTE_SIZE) return false;
+                palette[colors++] = scratch[p];
+            }
+            indices[i / 2] |= (uint8_t)(c << ((i & 1) * 4));
+        }
+    }
+    return true;
+}
+
+static int16_t draw_cached(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg, int large) {
+    uint64_t key = sprite_key(text, large, fg, bg);
+
+    const TextSprite* s = find_sprite(key);
+    if (s && x >= 0 && y >= 0 && x + s->width <= LCD_WIDTH && y + s->height <= LCD_HEIGHT &&
+        scratch_pixels >= s->width) {
+        push_sprite(s, x, y);
+        stats.hits++;
+        return (int16_t)(x + s->width);
+    }
+
+    stats.misses++;
+    int16_t end = large ? extapp_drawTextLarge(text, x, y, fg, bg, false)
+                        : extapp_drawTextSmall(text, x, y, fg, bg, false);
+
+    // Copiar lo recién dibujado si entero cabe en pantalla y en el pool
+    int width = end - x;
+    int height = large ? TEXT_LARGE_HEIGHT : TEXT_SMALL_HEIGHT;
+    if (s || width <= 0 || x < 0 || y < 0 || end > LCD_WIDTH || y + height > LCD_HEIGHT) {
+        return end;
+    }
+    uint32_t words = sprite_words((uint32_t)(width * height));
+    if (sprite_count == TEXT_CACHE_ENTRIES || pool_used + words > pool_limit || scratch_pixels < (uint32_t)width) {
+        stats.rejected++;
+        return end;
+    }
+
+    TextSprite* added = &sprites[sprite_count];
+    added->key = key;
+    added->offset = pool_used;
+    added->width = (uint16_t)width;
+    added->height = (uint16_t)height;
+    if (!capture_sprite(added, x, y)) {
+        stats.rejected++;
+        return end;
+    }
+    sprite_count++;
+    pool_used += words;
+    return end;
+}
+
+int16_t text_cache_draw_small(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg) {
+    return draw_cached(text, x, y, fg, bg, 0);
+}
+
+int16_t text_cache_draw_large(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg) {
+    return draw_cached(text, x, y, fg, bg, 1);
+}
+
+bool text_cache_blit(const char* text, bool large, uint16_t fg, uint16_t bg, int row0, int rows,
+                     uint16_t* dst, uint32_t stride, uint16_t max_width) {
+    const TextSprite* s = find_sprite(sprite_key(text, large, fg, bg));
+    if (!s || s->width > max_width || row0 < 0 || row0 + rows > s->height) return false;
+    decode_rows(s, row0, rows, dst, stride);
+    stats.hits++;
+    return true;
+}
+
+void text_cache_set_scratch(uint16_t* pixels, uint32_t count) {
+    scratch = pixels;
+    scratch_pixels = count;
+}
+
+void text_cache_set_budget(size_t bytes) {
+    if (bytes > TEXT_CACHE_BUDGET) bytes = TEXT_CACHE_BUDGET;
+    pool_limit = (uint32_t)(bytes / sizeof(uint16_t));
+    pool_used = 0;
+    sprite_count = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+void text_cache_get_stats(TextCacheStats* out) {
+    *out = stats;
+    out->entries = sprite_count;
+    out->bytes_used = pool_used * sizeof(uint16_t);
+}
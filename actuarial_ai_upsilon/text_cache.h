@@ -0,0 +1,56 @@
+// Caché de textos fijos como sprites (text_cache.c)
+//
+// La primera vez que se dibuja un texto se rasteriza con extapp_drawText*
+// y se copia del LCD con extapp_pullRect; las siguientes se envía con un
+// solo extapp_pushRect. La clave es (texto, fuente, color, fondo), así que
+// un mismo texto vale en cualquier posición. Sólo para cadenas que no
+// cambian: cada variante ocupa memoria hasta que se reinicia la app.
+//
+// Las fuentes del firmware tienen 4 bits de alfa, así que un texto en dos
+// colores da como mucho 16 tonos: cada sprite guarda una paleta de 16
+// colores RGB565 y un índice de 4 bits por píxel, sin pérdida y en la
+// cuarta parte de memoria. Para copiar y para decodificar hace falta un
+// buffer RGB565: el de bandas del compositor (text_cache_set_scratch), que
+// está libre mientras se dibuja directamente.
+//
+// Los sprites viven en un pool estático de TEXT_CACHE_BUDGET bytes; cuando
+// no caben, el texto se sigue dibujando directamente.
+
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TEXT_CACHE_BUDGET   (40 * 1024)   // Los 45 textos fijos de la app completa (la UART usa 18 KB)
+#define TEXT_CACHE_ENTRIES  48
+
+#define TEXT_SMALL_HEIGHT   14
+#define TEXT_LARGE_HEIGHT   18
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t rejected;      // No cabían en el presupuesto
+    uint32_t entries;
+    uint32_t bytes_used;
+} TextCacheStats;
+
+int16_t text_cache_draw_small(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg);
+int16_t text_cache_draw_large(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg);
+
+// Decodifica las filas [row0, row0 + rows) de un sprite ya cacheado en dst
+// (`stride` píxeles por fila) sin dibujarlo; false si no está o si es más
+// ancho que max_width
+bool text_cache_blit(const char* text, bool large, uint16_t fg, uint16_t bg, int row0, int rows,
+                     uint16_t* dst, uint32_t stride, uint16_t max_width);
+
+// Buffer RGB565 de trabajo (al menos una fila de texto); sin él no se cachea
+void text_cache_set_scratch(uint16_t* pixels, uint32_t count);
+
+// Vacía la caché y fija el presupuesto (0 la desactiva; máximo TEXT_CACHE_BUDGET)
+void text_cache_set_budget(size_t bytes);
+void text_cache_get_stats(TextCacheStats* stats);
+
+#endif
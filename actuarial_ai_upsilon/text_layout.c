@@ -0,0 +1,51 @@
+// Prefijo de respuesta y ajuste de líneas sobre vistas
+
+#include <string.h>
+#include "text_layout.h"
+
+bool text_strip_solution(StrView* response) {
+    if (!sv_starts_with(*response, TEXT_SOLUTION_PREFIX)) return false;
+    *response = sv_drop(*response, sizeof(TEXT_SOLUTION_PREFIX) - 1);
+    return true;
+}
+
+StrView text_wrap_next(StrView* rest, size_t width) {
+    StrView text = *rest;
+    if (sv_empty(text)) return text;
+    if (width == 0) width = 1;
+
+    // Un '\n' que cae dentro de la línea la termina ahí
+    size_t window = text.len <= width ? text.len : width + 1;
+    const char* newline = memchr(text.ptr, '\n', window);
+    if (newline) {
+        size_t cut = (size_t)(newline - text.ptr);
+        *rest = sv_drop(text, cut + 1);
+        return sv_take(text, cut);
+    }
+
+    if (text.len <= width) {
+        *rest = sv_drop(text, text.len);
+        return text;
+    }
+
+    // Buscar espacio para cortar palabra completa
+    size_t cut = width;
+    while (cut > 0 && text.ptr[cut] != ' ') {
+        cut--;
+    }
+    if (cut == 0) cut = width;
+
+    StrView line = sv_take(text, cut);
+    text = sv_drop(text, cut);
+    if (!sv_empty(text) && text.ptr[0] == ' ') text = sv_drop(text, 1);   // Saltar espacio
+    *rest = text;
+    return line;
+}
+
+size_t text_copy_line(StrView line, char* out, size_t cap) {
+    if (cap == 0) return 0;
+    size_t n = line.len < cap - 1 ? line.len : cap - 1;
+    memcpy(out, line.ptr, n);
+    out[n] = '\0';
+    return n;
+}
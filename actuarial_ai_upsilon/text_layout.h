@@ -0,0 +1,32 @@
+// Respuestas del Pi y ajuste de texto a la pantalla (text_layout.c)
+//
+// Lo comparten las cuatro variantes de la app: quitar el prefijo
+// "SOLUTION:" y partir la respuesta en líneas de como mucho `width`
+// caracteres, cortando en el último espacio. Todo trabaja sobre vistas: no
+// se copia ni se mueve la respuesta. `make text-bench` mide su rendimiento
+// y `make text-fuzz` lo prueba con entradas aleatorias bajo sanitizers.
+
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "strview.h"
+
+#define TEXT_SOLUTION_PREFIX  "SOLUTION:"
+#define TEXT_LINE_MAX         48     // Ancho máximo admitido (caracteres)
+
+// Quita el prefijo "SOLUTION:" de `*response`; true si lo tenía
+bool text_strip_solution(StrView* response);
+
+// Siguiente línea de `*rest` y avanza `*rest` tras ella. Corta en el último
+// espacio que deje la línea en `width` caracteres (o en `width` si la
+// palabra no cabe) y en cada '\n'; el espacio o '\n' del corte no se
+// muestra. Con `*rest` vacío devuelve una vista vacía.
+StrView text_wrap_next(StrView* rest, size_t width);
+
+// Copia `line` terminada en '\0' para las llamadas de dibujo que la
+// necesitan; recorta a `cap - 1` bytes. Devuelve los bytes copiados.
+size_t text_copy_line(StrView line, char* out, size_t cap);
+
+#endif
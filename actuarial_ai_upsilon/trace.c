@@ -0,0 +1,72 @@
+// Anillo de eventos en RAM y volcado al almacenamiento
+
+#include <extapp_api.h>
+#include "trace.h"
+
+// Cabecera y anillo contiguos: tras ordenar el anillo se escriben de una vez
+static struct {
+    TraceFileHeader header;
+    TraceEvent events[TRACE_CAPACITY];
+} trace;
+
+static uint32_t head;       // Siguiente posición a escribir
+static uint32_t count;
+static uint32_t dropped;
+
+void trace_init(void) {
+    head = 0;
+    count = 0;
+    dropped = 0;
+    trace_event(TRACE_BOOT, 0, 0, TRACE_CAPACITY);
+}
+
+void trace_event(TraceEventType type, uint8_t a, uint16_t b, uint32_t value) {
+    TraceEvent* e = &trace.events[head];
+    e->time_ms = (uint32_t)extapp_millis();
+    e->type = (uint8_t)type;
+    e->a = a;
+    e->b = b;
+    e->value = value;
+    if (++head == TRACE_CAPACITY) head = 0;
+    if (count < TRACE_CAPACITY) count++;
+    else dropped++;
+}
+
+static void reverse(uint32_t from, uint32_t to) {
+    while (from + 1 < to) {
+        TraceEvent tmp = trace.events[from];
+        trace.events[from] = trace.events[to - 1];
+        trace.events[to - 1] = tmp;
+        from++;
+        to--;
+    }
+}
+
+bool trace_flush(void) {
+    trace_event(TRACE_FLUSH, 0, 0, dropped);
+
+    // Anillo lleno: el más antiguo está en `head`. Se rota en el sitio para
+    // que quede en la posición 0 sin un segundo buffer.
+    if (count == TRACE_CAPACITY && head != 0) {
+        reverse(0, head);
+        reverse(head, TRACE_CAPACITY);
+        reverse(0, TRACE_CAPACITY);
+        head = 0;
+    }
+
+    trace.header.magic = TRACE_MAGIC;
+    trace.header.version = TRACE_VERSION;
+    trace.header.count = (uint16_t)count;
+    trace.header.dropped = dropped;
+    trace.header.flushed_ms = (uint32_t)extapp_millis();
+    size_t bytes = sizeof(trace.header) + count * sizeof(TraceEvent);
+    return extapp_fileWrite(TRACE_FILE_NAME, (const char*)&trace, bytes, EXTAPP_RAM_FILE_SYSTEM);
+}
+
+uint32_t trace_count(void) {
+    return count;
+}
+
+uint32_t trace_dropped(void) {
+    return dropped;
+}
@@ -0,0 +1,84 @@
+// Traza binaria de eventos (trace.c)
+//
+// Cambios de estado, líneas enviadas y recibidas por el UART, errores del
+// periférico, timeouts, estado del enlace y cada etapa medida por el
+// perfilador quedan como registros de 12 bytes en un anillo fijo en RAM.
+// Registrar un evento son unas pocas escrituras; al llenarse el anillo se
+// pisan los más antiguos.
+//
+// trace_flush() guarda el anillo en el almacenamiento de la calculadora
+// (TRACE_FILE_NAME) en orden cronológico, con una cabecera. La app lo hace
+// al entrar en la pantalla de error y al salir, así que tras un "se colgó"
+// el fichero tiene los últimos TRACE_CAPACITY eventos. host/trace_decode.c
+// lo convierte en una línea de tiempo y un resumen de latencias.
+//
+// Formato (little-endian):
+//   TraceFileHeader                16 bytes
+//   TraceEvent[count]              12 bytes cada uno, del más antiguo al último
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TRACE_CAPACITY   256
+#define TRACE_FILE_NAME  "actuarial.trace"
+#define TRACE_MAGIC      0x43525441u    // "ATRC"
+#define TRACE_VERSION    1
+
+typedef enum {
+    TRACE_BOOT,         // value: TRACE_CAPACITY
+    TRACE_STATE,        // a: estado anterior, b: estado nuevo
+    TRACE_REQUEST,      // a: producto, b: 1 si salió de la caché
+    TRACE_UART_TX,      // a: primer byte, b: bytes de la línea; value: secuencia en la cola o 0
+    TRACE_UART_RX,      // a: primer byte, b: bytes de la línea
+    TRACE_UART_ERROR,   // a: TraceUartError, b: errores nuevos
+    TRACE_TIMEOUT,      // a: TraceTimeout, value: ms esperados
+    TRACE_RESPONSE,     // a: 1 correcta, 0 error; b: bytes; value: secuencia en la cola o 0
+    TRACE_LINK,         // a: LinkState anterior, b: LinkState nuevo
+    TRACE_STAGE,        // a: ProfStage, value: microsegundos
+    TRACE_FLUSH,        // value: eventos perdidos por vuelta del anillo
+    TRACE_EVENT_COUNT
+} TraceEventType;
+
+typedef enum {
+    TRACE_ERR_OVERRUN,
+    TRACE_ERR_FRAMING,
+    TRACE_ERR_NOISE,
+    TRACE_ERR_PARITY,
+    TRACE_ERR_TX_TIMEOUT,
+    TRACE_ERR_RECOVERY
+} TraceUartError;
+
+typedef enum {
+    TRACE_TIMEOUT_RESPONSE,     // El Pi no contestó a una petición
+    TRACE_TIMEOUT_LINK          // Petición rechazada: enlace caído
+} TraceTimeout;
+
+typedef struct {
+    uint32_t time_ms;       // extapp_millis()
+    uint8_t type;           // TraceEventType
+    uint8_t a;
+    uint16_t b;
+    uint32_t value;
+} TraceEvent;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t dropped;       // Eventos pisados antes de este volcado
+    uint32_t flushed_ms;
+} TraceFileHeader;
+
+void trace_init(void);
+void trace_event(TraceEventType type, uint8_t a, uint16_t b, uint32_t value);
+
+// Vuelca el anillo al almacenamiento; sigue registrando después
+bool trace_flush(void);
+
+uint32_t trace_count(void);     // Eventos en el anillo
+uint32_t trace_dropped(void);
+
+#endif
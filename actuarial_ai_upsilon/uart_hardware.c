@@ -3,167 +3,471 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
+#include "uart_hardware.h"
 
 // Direcciones de registros UART1 (STM32F730)
 #define UART1_BASE      0x40011000
 #define RCC_BASE        0x40023800
 #define GPIOA_BASE      0x40020000
+#define DMA2_BASE       0x40026400
+
+// Acceso a registros. En el host (UART_HW_EMULATED) se redirige al bloque
+// de registros emulado de host/uart_emu.c, que permite inyectar errores.
+#ifdef UART_HW_EMULATED
+extern uint32_t uart_emu_read(uint32_t addr);
+extern void uart_emu_write(uint32_t addr, uint32_t value);
+extern void uart_emu_attach_dma(uint8_t* buffer, uint32_t size);
+#define REG_READ(addr)          uart_emu_read(addr)
+#define REG_WRITE(addr, value)  uart_emu_write((addr), (value))
+#else
+#define REG_READ(addr)          (*(volatile uint32_t*)(addr))
+#define REG_WRITE(addr, value)  (*(volatile uint32_t*)(addr) = (value))
+#endif
+
+#define REG_SET(addr, bits)     REG_WRITE(addr, REG_READ(addr) | (bits))
+#define REG_CLEAR(addr, bits)   REG_WRITE(addr, REG_READ(addr) & ~(bits))
 
 // Registros UART1
-#define UART1_CR1       (*(volatile uint32_t*)(UART1_BASE + 0x00))
-#define UART1_CR2       (*(volatile uint32_t*)(UART1_BASE + 0x04))
-#define UART1_CR3       (*(volatile uint32_t*)(UART1_BASE + 0x08))
-#define UART1_BRR       (*(volatile uint32_t*)(UART1_BASE + 0x0C))
-#define UART1_ISR       (*(volatile uint32_t*)(UART1_BASE + 0x1C))
-#define UART1_ICR       (*(volatile uint32_t*)(UART1_BASE + 0x20))
-#define UART1_RDR       (*(volatile uint32_t*)(UART1_BASE + 0x24))
-#define UART1_TDR       (*(volatile uint32_t*)(UART1_BASE + 0x28))
+#define UART1_CR1       (UART1_BASE + 0x00)
+#define UART1_CR2       (UART1_BASE + 0x04)
+#define UART1_CR3       (UART1_BASE + 0x08)
+#define UART1_BRR       (UART1_BASE + 0x0C)
+#define UART1_ISR       (UART1_BASE + 0x1C)
+#define UART1_ICR       (UART1_BASE + 0x20)
+#define UART1_RDR       (UART1_BASE + 0x24)
+#define UART1_TDR       (UART1_BASE + 0x28)
 
 // Registros RCC (Reset and Clock Control)
-#define RCC_AHB1ENR     (*(volatile uint32_t*)(RCC_BASE + 0x30))
-#define RCC_APB2ENR     (*(volatile uint32_t*)(RCC_BASE + 0x44))
+#define RCC_AHB1ENR     (RCC_BASE + 0x30)
+#define RCC_APB2ENR     (RCC_BASE + 0x44)
 
 // Registros GPIO Puerto A
-#define GPIOA_MODER     (*(volatile uint32_t*)(GPIOA_BASE + 0x00))
-#define GPIOA_AFRL      (*(volatile uint32_t*)(GPIOA_BASE + 0x20))
-#define GPIOA_AFRH      (*(volatile uint32_t*)(GPIOA_BASE + 0x24))
+#define GPIOA_MODER     (GPIOA_BASE + 0x00)
+#define GPIOA_AFRL      (GPIOA_BASE + 0x20)
+#define GPIOA_AFRH      (GPIOA_BASE + 0x24)
+
+// DMA2 Stream 5, canal 4 = USART1_RX
+#define DMA2_HISR       (DMA2_BASE + 0x04)
+#define DMA2_HIFCR      (DMA2_BASE + 0x0C)
+#define DMA2_S5CR       (DMA2_BASE + 0x10 + 0x18 * 5)
+#define DMA2_S5NDTR     (DMA2_S5CR + 0x04)
+#define DMA2_S5PAR      (DMA2_S5CR + 0x08)
+#define DMA2_S5M0AR     (DMA2_S5CR + 0x0C)
+
+// Registros de caché del Cortex-M7
+#define SCB_CCR         0xE000ED14
+#define SCB_DCIMVAC     0xE000EF5C
 
 // Bits de control UART
 #define UART_CR1_UE     (1 << 0)   // UART Enable
 #define UART_CR1_RE     (1 << 2)   // Receiver Enable
 #define UART_CR1_TE     (1 << 3)   // Transmitter Enable
+#define UART_CR3_DMAR   (1 << 6)   // DMA para recepción
+#define UART_CR3_DDRE   (1 << 13)  // DMA en pausa tras un error de recepción
+#define UART_ISR_PE     (1 << 0)   // Parity Error
+#define UART_ISR_FE     (1 << 1)   // Framing Error
+#define UART_ISR_NF     (1 << 2)   // Noise detected Flag
+#define UART_ISR_ORE    (1 << 3)   // Overrun Error
 #define UART_ISR_TXE    (1 << 7)   // Transmit Data Register Empty
 #define UART_ISR_RXNE   (1 << 5)   // Read Data Register Not Empty
 #define UART_ISR_TC     (1 << 6)   // Transmission Complete
+#define UART_ISR_ERRORS (UART_ISR_PE | UART_ISR_FE | UART_ISR_NF | UART_ISR_ORE)
+
+// En ICR los bits PECF/FECF/NCF/ORECF ocupan las mismas posiciones que en ISR
+#define UART_ICR_ERRORS UART_ISR_ERRORS
+#define UART_ICR_TCCF   (1 << 6)   // Limpia TC
+
+// Bits de DMA
+#define DMA_SxCR_EN     (1 << 0)
+#define DMA_SxCR_CIRC   (1 << 8)
+#define DMA_SxCR_MINC   (1 << 10)
+#define DMA_SxCR_CH4    (4u << 25)
+#define DMA_HIFCR_S5    (0x3Du << 6)   // FEIF5, DMEIF5, TEIF5, HTIF5, TCIF5
+#define DMA_HISR_HTIF5  (1u << 10)     // Pasó por la mitad del anillo
+#define DMA_HISR_TCIF5  (1u << 11)     // Pasó por el final del anillo
+
+#define SCB_CCR_DC      (1 << 16)      // D-cache habilitada
 
 // Configuración de pines
 #define GPIO_AF7        0x07       // Función alternativa 7 para UART1
 
+// Política de errores
+#define UART_TX_RETRIES            3      // Reintentos por byte antes de rendirse
+#define UART_RECOVERY_THRESHOLD    4      // Errores seguidos antes de reiniciar el periférico
+#define UART_INTERBYTE_TIMEOUT_MS  100    // Silencio máximo dentro de una línea
+
+// Buffer circular de recepción. El USART1 sólo tiene un registro RDR: sin
+// DMA, cualquier byte que llegue mientras la app dibuja o duerme se pierde
+// por overrun. Con DMA circular la recepción sigue en segundo plano y
+// uart_hardware_poll_byte() sólo consume lo que ya está en RAM.
+//
+// Con DDRE un byte con FE/PE/NF no pasa al anillo: se queda en RDR y el DMA
+// se detiene hasta que el driver lo lee y limpia el flag, así que el byte
+// erróneo se identifica igual que sin DMA. FE/PE se descartan (el protocolo
+// de líneas no tiene CRC); NF se acepta y se entrega en su posición.
+#define UART_RX_RING_SIZE  1024
+
+static uint8_t rx_ring[UART_RX_RING_SIZE] __attribute__((aligned(32)));
+static uint32_t rx_ring_tail = 0;
+static uint32_t rx_ring_last_head = 0;  // Posición del DMA en el último sondeo
+
+// Byte con NF retenido fuera del anillo, a entregar cuando la cola llegue a
+// la posición en que se detuvo el DMA
+static bool rx_held;
+static uint8_t rx_held_byte;
+static uint32_t rx_held_pos;
+
+static UartStats stats;
+static uint32_t consecutive_errors = 0;
+static UartLineHook line_start_hook;
+static UartClock wait_clock;
+static UartIdleHook wait_idle;
+static UartTapHook tap_hook;
+
+static uint32_t rx_ring_head(void) {
+    // NDTR cuenta hacia atrás y se recarga sola en modo circular
+    uint32_t head = UART_RX_RING_SIZE - REG_READ(DMA2_S5NDTR);
+    return head >= UART_RX_RING_SIZE ? 0 : head;
+}
+
+// La CPU nunca escribe en el buffer, así que basta invalidar la línea
+// de caché antes de leerla para ver lo que escribió el DMA.
+static void rx_ring_invalidate(uint32_t index) {
+#ifndef UART_HW_EMULATED
+    if (*(volatile uint32_t*)SCB_CCR & SCB_CCR_DC) {
+        *(volatile uint32_t*)SCB_DCIMVAC = (uint32_t)(uintptr_t)&rx_ring[index] & ~31u;
+        __asm__ volatile ("dsb\n\tisb" ::: "memory");
+    }
+#else
+    (void)index;
+#endif
+}
+
+static void uart_start_rx_dma(void) {
+    REG_CLEAR(DMA2_S5CR, DMA_SxCR_EN);
+    for (uint32_t timeout = 10000; (REG_READ(DMA2_S5CR) & DMA_SxCR_EN) && timeout; timeout--);
+
+    REG_WRITE(DMA2_HIFCR, DMA_HIFCR_S5);
+    REG_WRITE(DMA2_S5PAR, UART1_RDR);
+    REG_WRITE(DMA2_S5M0AR, (uint32_t)(uintptr_t)rx_ring);
+#ifdef UART_HW_EMULATED
+    uart_emu_attach_dma(rx_ring, UART_RX_RING_SIZE);
+#endif
+    REG_WRITE(DMA2_S5NDTR, UART_RX_RING_SIZE);
+    REG_WRITE(DMA2_S5CR, DMA_SxCR_CH4 | DMA_SxCR_MINC | DMA_SxCR_CIRC);
+    REG_SET(DMA2_S5CR, DMA_SxCR_EN);
+
+    REG_WRITE(DMA2_HIFCR, DMA_HIFCR_S5);
+    rx_ring_tail = 0;
+    rx_ring_last_head = 0;
+    rx_held = false;
+}
+
+static void uart_configure(void) {
+    REG_WRITE(UART1_CR1, 0);  // Deshabilitar UART durante configuración
+
+    // Configurar baudrate 115200
+    // Asumiendo clock de 216 MHz: BRR = 216000000 / 115200 ≈ 1875
+    REG_WRITE(UART1_BRR, 1875);
+
+    // Configurar formato: 8 bits, sin paridad, 1 bit de stop (por defecto)
+    REG_WRITE(UART1_CR2, 0);
+    REG_WRITE(UART1_CR3, UART_CR3_DMAR | UART_CR3_DDRE);
+
+    // Limpiar errores pendientes de una sesión anterior
+    REG_WRITE(UART1_ICR, UART_ICR_ERRORS);
+
+    uart_start_rx_dma();
+
+    // Habilitar transmisor, receptor y UART
+    REG_WRITE(UART1_CR1, UART_CR1_UE | UART_CR1_RE | UART_CR1_TE);
+}
+
 bool uart_hardware_init(void) {
     // 1. Habilitar clocks
-    RCC_AHB1ENR |= (1 << 0);  // Habilitar clock GPIOA
-    RCC_APB2ENR |= (1 << 4);  // Habilitar clock UART1
-    
+    REG_SET(RCC_AHB1ENR, 1 << 0);  // Habilitar clock GPIOA
+    REG_SET(RCC_APB2ENR, 1 << 4);  // Habilitar clock UART1
+    REG_SET(RCC_AHB1ENR, 1 << 22); // Habilitar clock DMA2
+
     // 2. Configurar pines PA11 (TX) y PA12 (RX)
     // PA11 y PA12 como función alternativa
-    GPIOA_MODER &= ~((3 << 22) | (3 << 24));  // Limpiar bits
-    GPIOA_MODER |= (2 << 22) | (2 << 24);     // Función alternativa
-    
+    REG_CLEAR(GPIOA_MODER, (3 << 22) | (3 << 24));  // Limpiar bits
+    REG_SET(GPIOA_MODER, (2 << 22) | (2 << 24));    // Función alternativa
+
     // Configurar función alternativa AF7 para UART1
-    GPIOA_AFRH &= ~((0xF << 12) | (0xF << 16));  // Limpiar AF11 y AF12
-    GPIOA_AFRH |= (GPIO_AF7 << 12) | (GPIO_AF7 << 16);  // AF7 para PA11 y PA12
-    
+    REG_CLEAR(GPIOA_AFRH, (0xF << 12) | (0xF << 16));  // Limpiar AF11 y AF12
+    REG_SET(GPIOA_AFRH, (GPIO_AF7 << 12) | (GPIO_AF7 << 16));  // AF7 para PA11 y PA12
+
     // 3. Configurar UART1
-    UART1_CR1 = 0;  // Deshabilitar UART durante configuración
-    
-    // Configurar baudrate 115200
-    // Asumiendo clock de 216 MHz: BRR = 216000000 / 115200 ≈ 1875
-    UART1_BRR = 1875;
-    
-    // Configurar formato: 8 bits, sin paridad, 1 bit de stop (por defecto)
-    UART1_CR2 = 0;
-    UART1_CR3 = 0;
-    
-    // Habilitar transmisor, receptor y UART
-    UART1_CR1 = UART_CR1_UE | UART_CR1_RE | UART_CR1_TE;
-    
+    uart_configure();
+
+    uart_hardware_reset_stats();
     return true;
 }
 
-bool uart_hardware_send_byte(uint8_t byte) {
-    // Esperar que el registro de transmisión esté vacío
+// Reinicia el periférico y el DMA: descarta lo pendiente y los flags de
+// error. Tras un overrun el receptor no vuelve a pedir DMA hasta limpiar
+// ORE, así que sin esto la recepción queda bloqueada en silencio. Los
+// bytes sin leer del anillo se pierden: se cuentan en rx_overflows, como
+// una vuelta del anillo, y la línea en curso se da por dañada.
+bool uart_hardware_recover(void) {
+    if (rx_ring_head() != rx_ring_tail || rx_held) stats.rx_overflows++;
+    REG_CLEAR(UART1_CR1, UART_CR1_UE);
+    REG_CLEAR(DMA2_S5CR, DMA_SxCR_EN);
+    (void)REG_READ(UART1_RDR);
+    REG_WRITE(UART1_ICR, UART_ICR_ERRORS);
+    uart_configure();
+
+    consecutive_errors = 0;
+    stats.recoveries++;
+    return (REG_READ(UART1_ISR) & UART_ISR_ERRORS) == 0;
+}
+
+// Lee los flags de error de ISR, los contabiliza y los limpia en ICR.
+// Devuelve los flags que estaban activos.
+static uint32_t uart_handle_errors(void) {
+    uint32_t isr = REG_READ(UART1_ISR);
+    uint32_t errors = isr & UART_ISR_ERRORS;
+    if (!errors) return 0;
+
+    if (errors & UART_ISR_ORE) stats.overrun_errors++;
+    if (errors & UART_ISR_FE)  stats.framing_errors++;
+    if (errors & UART_ISR_NF)  stats.noise_errors++;
+    if (errors & UART_ISR_PE)  stats.parity_errors++;
+
+    // El byte erróneo sigue en RDR (DDRE): leerlo antes de limpiar el flag,
+    // o el DMA lo copiaría al reanudarse
+    if (isr & UART_ISR_RXNE) {
+        uint8_t data = (uint8_t)(REG_READ(UART1_RDR) & 0xFF);
+        if (!(errors & (UART_ISR_FE | UART_ISR_PE)) && !rx_held) {
+            rx_held = true;
+            rx_held_byte = data;
+            rx_held_pos = rx_ring_head();
+        }
+    }
+
+    REG_WRITE(UART1_ICR, errors);
+
+    if (++consecutive_errors >= UART_RECOVERY_THRESHOLD) {
+        uart_hardware_recover();
+    }
+
+    return errors;
+}
+
+// Tras un timeout de TXE/TC basta reiniciar el transmisor: el receptor y
+// el DMA siguen con lo que ya hay en el anillo
+static void uart_reset_tx(void) {
+    REG_CLEAR(UART1_CR1, UART_CR1_TE);
+    REG_WRITE(UART1_ICR, UART_ICR_TCCF);
+    REG_SET(UART1_CR1, UART_CR1_TE);
+    stats.recoveries++;
+}
+
+static bool uart_wait_flag(uint32_t flag) {
     uint32_t timeout = 100000;
-    while (!(UART1_ISR & UART_ISR_TXE) && timeout--) {
-        // Esperar
+    while (!(REG_READ(UART1_ISR) & flag)) {
+        if (timeout-- == 0) return false;
+    }
+    return true;
+}
+
+bool uart_hardware_send_byte(uint8_t byte) {
+    for (int attempt = 0; attempt <= UART_TX_RETRIES; attempt++) {
+        if (attempt > 0) {
+            stats.retries++;
+            uart_reset_tx();
+        }
+
+        // Esperar que el registro de transmisión esté vacío
+        if (!uart_wait_flag(UART_ISR_TXE)) {
+            stats.tx_timeouts++;
+            continue;
+        }
+
+        // Enviar byte
+        REG_WRITE(UART1_TDR, byte);
+
+        // Esperar que la transmisión se complete
+        if (!uart_wait_flag(UART_ISR_TC)) {
+            stats.tx_timeouts++;
+            continue;
+        }
+
+        stats.tx_bytes++;
+        if (tap_hook) tap_hook(byte, true);
+        return true;
     }
-    
-    if (timeout == 0) return false;  // Timeout
-    
-    // Enviar byte
-    UART1_TDR = byte;
-    
-    // Esperar que la transmisión se complete
-    timeout = 100000;
-    while (!(UART1_ISR & UART_ISR_TC) && timeout--) {
-        // Esperar
+
+    return false;
+}
+
+// Si el DMA dio la vuelta al anillo sobre bytes sin leer, lo pendiente ya
+// no es fiable: se descarta entero y se cuenta. NDTR sólo da la posición;
+// las vueltas se ven en HTIF5/TCIF5, que el DMA levanta al pasar por la
+// mitad y por el final. Una pasada que no explica el avance desde el último
+// sondeo es una vuelta entera. (Dos vueltas sin sondear, 180 ms a 115200
+// baudios, pueden pasar por una sola.)
+static void rx_ring_check_overflow(uint32_t head) {
+    uint32_t flags = REG_READ(DMA2_HISR) & (DMA_HISR_HTIF5 | DMA_HISR_TCIF5);
+    if (flags) REG_WRITE(DMA2_HIFCR, flags);
+
+    const uint32_t half = UART_RX_RING_SIZE / 2;
+    uint32_t last = rx_ring_last_head;
+    uint32_t moved = (head + UART_RX_RING_SIZE - last) % UART_RX_RING_SIZE;
+    bool crossed_end = head < last;
+    bool crossed_half = last < half ? (head >= half || crossed_end) : (crossed_end && head >= half);
+    if (((flags & DMA_HISR_TCIF5) && !crossed_end) || ((flags & DMA_HISR_HTIF5) && !crossed_half)) {
+        moved += UART_RX_RING_SIZE;
+    }
+    rx_ring_last_head = head;
+
+    uint32_t pending = (last + UART_RX_RING_SIZE - rx_ring_tail) % UART_RX_RING_SIZE;
+    if (pending + moved >= UART_RX_RING_SIZE) {
+        stats.rx_overflows++;
+        rx_ring_tail = head;
+        rx_held = false;
     }
-    
-    return timeout > 0;
 }
 
-bool uart_hardware_receive_byte(uint8_t* byte, uint32_t timeout_ms) {
+bool uart_hardware_poll_byte(uint8_t* byte) {
     if (!byte) return false;
-    
-    // Convertir timeout a ciclos aproximados
-    uint32_t timeout_cycles = timeout_ms * 1000;  // Aproximación
-    
-    // Esperar datos disponibles
-    while (!(UART1_ISR & UART_ISR_RXNE) && timeout_cycles--) {
-        // Pequeña pausa para no saturar el bus
-        for (volatile int i = 0; i < 100; i++);
+
+    uint32_t errors = uart_handle_errors();
+    uint32_t head = rx_ring_head();
+    rx_ring_check_overflow(head);
+
+    if (rx_held && rx_ring_tail == rx_held_pos) {
+        rx_held = false;
+        *byte = rx_held_byte;
+    } else if (head == rx_ring_tail) {
+        return false;
+    } else {
+        rx_ring_invalidate(rx_ring_tail);
+        *byte = rx_ring[rx_ring_tail];
+        rx_ring_tail = (rx_ring_tail + 1) % UART_RX_RING_SIZE;
     }
-    
-    if (timeout_cycles == 0) return false;  // Timeout
-    
-    // Leer byte recibido
-    *byte = (uint8_t)(UART1_RDR & 0xFF);
-    
+
+    if (!errors) consecutive_errors = 0;
+    stats.rx_bytes++;
+    if (tap_hook) tap_hook(*byte, false);
     return true;
 }
 
+bool uart_hardware_receive_byte(uint8_t* byte, uint32_t timeout_ms) {
+    if (!byte) return false;
+
+    if (wait_clock) {
+        // Entre sondeos el núcleo duerme; el DMA sigue llenando el anillo
+        uint64_t start = wait_clock();
+        while (true) {
+            if (uart_hardware_poll_byte(byte)) return true;
+            if (wait_clock() - start >= timeout_ms) break;
+            wait_idle();
+        }
+    } else {
+        // Sin reloj: vueltas de sondeo aproximadas
+        uint32_t timeout_cycles = timeout_ms * 1000;
+
+        while (true) {
+            if (uart_hardware_poll_byte(byte)) return true;
+
+            if (timeout_cycles-- == 0) break;
+
+            // Pequeña pausa para no saturar el bus
+            for (volatile int i = 0; i < 100; i++);
+        }
+    }
+
+    stats.rx_timeouts++;
+    return false;  // Timeout
+}
+
 bool uart_hardware_send_string(const char* str) {
     if (!str) return false;
-    
+
     while (*str) {
         if (!uart_hardware_send_byte(*str)) {
             return false;
         }
         str++;
     }
-    
+
     return true;
 }
 
 bool uart_hardware_receive_string(char* buffer, int max_len, uint32_t timeout_ms) {
     if (!buffer || max_len <= 0) return false;
-    
+
     int index = 0;
     uint8_t byte;
-    uint32_t start_time = 0;  // En implementación real, usar timer del sistema
-    
+    // Una vuelta del anillo durante la línea la deja incompleta
+    uint32_t overflows = stats.rx_overflows;
+
+    // El primer byte puede tardar todo el timeout (el Pi está consultando la
+    // nube); una vez empezada la línea, el resto debe llegar seguido.
+    uint32_t wait_ms = timeout_ms;
+
     // Leer hasta encontrar '\n' o timeout
     while (index < max_len - 1) {
-        if (uart_hardware_receive_byte(&byte, 100)) {  // 100ms por byte
-            if (byte == '\n') {
-                buffer[index] = '\0';
-                return true;
-            }
-            buffer[index++] = byte;
-        } else {
-            // Timeout en byte individual, verificar timeout total
-            // En implementación real, verificar tiempo transcurrido
+        if (!uart_hardware_receive_byte(&byte, wait_ms)) {
             break;
         }
+        if (index == 0 && line_start_hook) line_start_hook();
+        if (byte == '\n') {
+            buffer[index] = '\0';
+            return stats.rx_overflows == overflows;
+        }
+        buffer[index++] = byte;
+        wait_ms = UART_INTERBYTE_TIMEOUT_MS;
     }
-    
+
     buffer[index] = '\0';
-    return index > 0;
+    return index > 0 && stats.rx_overflows == overflows;
 }
 
 // Función de prueba de loopback
 bool uart_hardware_test_loopback(void) {
     const char test_msg[] = "TEST";
     char received[10];
-    
+
     // Enviar mensaje de prueba
     if (!uart_hardware_send_string(test_msg)) {
         return false;
     }
-    
+
     // Intentar recibir (solo funciona si TX está conectado a RX)
     if (uart_hardware_receive_string(received, sizeof(received), 1000)) {
         return (strcmp(received, test_msg) == 0);
     }
-    
+
     return false;
-} 
\ No newline at end of file
+}
+
+void uart_hardware_set_line_start_hook(UartLineHook hook) {
+    line_start_hook = hook;
+}
+
+void uart_hardware_set_wait(UartClock clock, UartIdleHook idle) {
+    wait_clock = idle ? clock : NULL;
+    wait_idle = idle;
+}
+
+void uart_hardware_set_tap(UartTapHook tap) {
+    tap_hook = tap;
+}
+
+void uart_hardware_get_stats(UartStats* out) {
+    if (out) *out = stats;
+}
+
+void uart_hardware_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+    consecutive_errors = 0;
+}
+
+uint32_t uart_hardware_error_count(const UartStats* s) {
+    return s->overrun_errors + s->framing_errors + s->noise_errors +
+           s->parity_errors + s->tx_timeouts + s->rx_overflows;
+}
\ No newline at end of file
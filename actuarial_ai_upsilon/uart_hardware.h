@@ -0,0 +1,57 @@
+// Interfaz del driver UART de bajo nivel (uart_hardware.c)
+
+#ifndef UART_HARDWARE_H
+#define UART_HARDWARE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Contadores de salud del enlace. Se acumulan desde uart_hardware_init()
+// o desde el último uart_hardware_reset_stats().
+typedef struct {
+    uint32_t tx_bytes;        // Bytes escritos en TDR
+    uint32_t rx_bytes;        // Bytes válidos leídos de RDR
+    uint32_t overrun_errors;  // ORE: se perdió al menos un byte
+    uint32_t framing_errors;  // FE: bit de stop incorrecto, byte descartado
+    uint32_t noise_errors;    // NF: ruido detectado, byte aceptado
+    uint32_t parity_errors;   // PE: paridad incorrecta, byte descartado
+    uint32_t tx_timeouts;     // TXE/TC no llegó a tiempo
+    uint32_t rx_overflows;    // Bytes sin leer perdidos: vuelta del anillo o reinicio del receptor
+    uint32_t rx_timeouts;     // No llegó ningún byte dentro del timeout
+    uint32_t retries;         // Reintentos de envío
+    uint32_t recoveries;      // Reinicios del periférico (o sólo del transmisor) tras errores
+} UartStats;
+
+bool uart_hardware_init(void);
+bool uart_hardware_send_byte(uint8_t byte);
+bool uart_hardware_receive_byte(uint8_t* byte, uint32_t timeout_ms);
+bool uart_hardware_poll_byte(uint8_t* byte);  // No bloqueante
+bool uart_hardware_send_string(const char* str);
+bool uart_hardware_receive_string(char* buffer, int max_len, uint32_t timeout_ms);
+bool uart_hardware_test_loopback(void);
+
+// Se llama al llegar el primer byte de cada línea en
+// uart_hardware_receive_string (separa la espera de la recepción)
+typedef void (*UartLineHook)(void);
+void uart_hardware_set_line_start_hook(UartLineHook hook);
+
+// Espera de uart_hardware_receive_byte(). Sin instalar, sondea en un bucle
+// activo y el timeout son vueltas aproximadas. Con un reloj en ms
+// (extapp_millis) y una espera (power_wait), el timeout se mide con el
+// reloj y entre sondeos el núcleo duerme.
+typedef uint64_t (*UartClock)(void);
+typedef void (*UartIdleHook)(void);
+void uart_hardware_set_wait(UartClock clock, UartIdleHook idle);
+
+// Se llama con cada byte enviado (tx) y con cada byte recibido que se
+// entrega al llamador, p. ej. para grabar la sesión (uart_session.c)
+typedef void (*UartTapHook)(uint8_t byte, bool tx);
+void uart_hardware_set_tap(UartTapHook tap);
+
+// Diagnóstico del enlace
+void uart_hardware_get_stats(UartStats* stats);
+void uart_hardware_reset_stats(void);
+uint32_t uart_hardware_error_count(const UartStats* stats);
+bool uart_hardware_recover(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,147 @@
+// Sesiones del UART en un buffer en RAM y volcado al almacenamiento
+
+#include <extapp_api.h>
+#include <string.h>
+#include "uart_session.h"
+#include "uart_hardware.h"
+#include "profiler.h"
+
+#ifdef UART_HW_EMULATED
+extern uint64_t extapp_shim_now_ns(void);
+#endif
+
+// Cabecera y eventos contiguos: se escriben de una vez
+static struct {
+    UartSessionHeader header;
+    uint8_t data[UART_SESSION_CAPACITY];
+} session;
+
+static uint32_t length;
+static uint32_t events;
+static bool recording;
+static bool truncated;
+static uint32_t carry_us;       // Resto por debajo de un paso
+
+#ifdef UART_HW_EMULATED
+static uint64_t last_ns;
+#else
+static ProfMark last;
+#endif
+
+// Microsegundos desde el evento anterior
+static uint32_t elapsed_us(void) {
+#ifdef UART_HW_EMULATED
+    // Reloj virtual: la misma ejecución del benchmark da el mismo fichero
+    uint64_t now = extapp_shim_now_ns();
+    uint64_t us = (now - last_ns) / 1000;
+    last_ns += us * 1000;
+    return us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+#else
+    ProfMark now = profiler_begin();
+    uint32_t us = profiler_elapsed_us(last, now);
+    last = now;
+    return us;
+#endif
+}
+
+static void reset_clock(void) {
+#ifdef UART_HW_EMULATED
+    last_ns = extapp_shim_now_ns();
+#else
+    last = profiler_begin();
+#endif
+    carry_us = 0;
+}
+
+static void record_byte(uint8_t byte, bool tx) {
+    if (length + UART_SESSION_EVENT_MAX > UART_SESSION_CAPACITY) {
+        truncated = true;
+        uart_session_stop();
+        return;
+    }
+
+    uint64_t us = (uint64_t)elapsed_us() + carry_us;
+    uint64_t ticks = us / UART_SESSION_TICK_US;
+    carry_us = (uint32_t)(us % UART_SESSION_TICK_US);
+    if (ticks > 0x7FFFFFFF) ticks = 0x7FFFFFFF;
+
+    uint32_t value = ((uint32_t)ticks << 1) | (tx ? 1u : 0u);
+    while (value >= 0x80) {
+        session.data[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    session.data[length++] = (uint8_t)value;
+    session.data[length++] = byte;
+    events++;
+}
+
+void uart_session_start(void) {
+    length = 0;
+    events = 0;
+    truncated = false;
+    reset_clock();
+    recording = true;
+    uart_hardware_set_tap(record_byte);
+}
+
+void uart_session_stop(void) {
+    recording = false;
+    uart_hardware_set_tap(NULL);
+}
+
+bool uart_session_recording(void) {
+    return recording;
+}
+
+bool uart_session_truncated(void) {
+    return truncated;
+}
+
+uint32_t uart_session_events(void) {
+    return events;
+}
+
+uint32_t uart_session_length(void) {
+    return length;
+}
+
+bool uart_session_save(void) {
+    session.header.magic = UART_SESSION_MAGIC;
+    session.header.version = UART_SESSION_VERSION;
+    session.header.tick_us = UART_SESSION_TICK_US;
+    session.header.flags = truncated ? UART_SESSION_TRUNCATED : 0;
+    session.header.reserved = 0;
+    session.header.events = events;
+    session.header.length = length;
+    size_t bytes = sizeof(session.header) + length;
+    return extapp_fileWrite(UART_SESSION_FILE_NAME, (const char*)&session, bytes, EXTAPP_RAM_FILE_SYSTEM);
+}
+
+bool uart_session_open(UartSessionReader* reader, const uint8_t* file, size_t len,
+                       UartSessionHeader* header) {
+    if (!file || len < sizeof(*header)) return false;
+    memcpy(header, file, sizeof(*header));
+    if (header->magic != UART_SESSION_MAGIC || header->version != UART_SESSION_VERSION) return false;
+    if (header->tick_us == 0 || header->length > len - sizeof(*header)) return false;
+    reader->data = file + sizeof(*header);
+    reader->length = header->length;
+    reader->pos = 0;
+    return true;
+}
+
+bool uart_session_next(UartSessionReader* reader, UartSessionEvent* event) {
+    uint32_t value = 0;
+    size_t pos = reader->pos;
+    for (int shift = 0; ; shift += 7) {
+        if (pos >= reader->length || shift > 28) return false;
+        uint8_t b = reader->data[pos++];
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+    }
+    if (pos >= reader->length) return false;
+    event->ticks = value >> 1;
+    event->tx = value & 1;
+    event->byte = reader->data[pos++];
+    reader->pos = pos;
+    return true;
+}
@@ -0,0 +1,80 @@
+// Grabación de sesiones del UART (uart_session.c)
+//
+// Mientras se graba, cada byte que el driver envía o entrega al llamador
+// (uart_hardware_set_tap) queda en un buffer fijo en RAM con su dirección y
+// el tiempo transcurrido desde el byte anterior, en pasos de
+// UART_SESSION_TICK_US. Al llenarse el buffer la grabación se detiene y la
+// cabecera lo indica; no se pisa lo ya grabado.
+//
+// uart_session_save() guarda la sesión en el almacenamiento de la
+// calculadora (UART_SESSION_FILE_NAME). host/session_replay.c la reproduce
+// contra el driver, el análisis de la respuesta y el dibujo en el host, con
+// la misma cadencia de bytes en cada ejecución.
+//
+// En el dispositivo el tiempo sale de las marcas del perfilador (contador
+// de ciclos, o extapp_millis() en esperas largas); en el host
+// (UART_HW_EMULATED), del reloj virtual del shim.
+//
+// Formato (little-endian):
+//   UartSessionHeader              20 bytes
+//   eventos                        `length` bytes; cada uno es un varint con
+//                                  (pasos << 1) | tx, 7 bits por byte y el
+//                                  menos significativo primero, seguido del
+//                                  byte transferido
+
+#ifndef UART_SESSION_H
+#define UART_SESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define UART_SESSION_CAPACITY   4096
+#define UART_SESSION_FILE_NAME  "actuarial.uart"
+#define UART_SESSION_MAGIC      0x53535541u     // "AUSS"
+#define UART_SESSION_VERSION    1
+#define UART_SESSION_TICK_US    10
+#define UART_SESSION_EVENT_MAX  6               // Varint de 32 bits + byte
+
+#define UART_SESSION_TRUNCATED  (1u << 0)       // Se llenó el buffer
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t tick_us;
+    uint16_t flags;
+    uint16_t reserved;
+    uint32_t events;
+    uint32_t length;        // Bytes de eventos tras la cabecera
+} UartSessionHeader;
+
+typedef struct {
+    uint32_t ticks;         // Desde el evento anterior (o el inicio)
+    uint8_t byte;
+    bool tx;
+} UartSessionEvent;
+
+typedef struct {
+    const uint8_t* data;
+    size_t length;
+    size_t pos;
+} UartSessionReader;
+
+// Vacía el buffer y empieza a grabar; el primer evento cuenta desde aquí
+void uart_session_start(void);
+void uart_session_stop(void);
+bool uart_session_recording(void);
+bool uart_session_truncated(void);
+uint32_t uart_session_events(void);
+uint32_t uart_session_length(void);      // Bytes usados del buffer
+
+// Guarda lo grabado hasta ahora; sigue grabando si lo estaba
+bool uart_session_save(void);
+
+// Lectura de un fichero guardado. false si la cabecera no es válida.
+bool uart_session_open(UartSessionReader* reader, const uint8_t* file, size_t len,
+                       UartSessionHeader* header);
+// false al final o si el último evento está cortado
+bool uart_session_next(UartSessionReader* reader, UartSessionEvent* event);
+
+#endif
@@ -0,0 +1,397 @@
+// Transporte fiable con ACK/NACK y ventana deslizante sobre el UART
+
+#include <string.h>
+#include "uart_transport.h"
+
+#define FRAME_FLAG      0x7E
+#define FRAME_ESC       0x7D
+#define FRAME_XOR       0x20
+
+#define TYPE_DATA       0x01
+#define TYPE_ACK        0x02
+#define TYPE_NACK       0x03
+#define TYPE_MASK       0x0F
+#define FLAG_START      0x40   // Primera trama de un mensaje
+#define FLAG_END        0x80   // Última trama de un mensaje
+
+#define FRAME_HEADER    3      // tipo, seq, len
+#define FRAME_OVERHEAD  (FRAME_HEADER + 2)
+
+static uint16_t crc16_ccitt(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint32_t now_ms(const Transport* t) {
+    return t->link->millis(t->link->ctx);
+}
+
+// Distancia (módulo 256) de `seq` respecto a `base`
+static uint8_t seq_offset(uint8_t seq, uint8_t base) {
+    return (uint8_t)(seq - base);
+}
+
+static void put_escaped(Transport* t, uint8_t byte) {
+    if (byte == FRAME_FLAG || byte == FRAME_ESC) {
+        t->link->send_byte(FRAME_ESC, t->link->ctx);
+        byte ^= FRAME_XOR;
+    }
+    t->link->send_byte(byte, t->link->ctx);
+}
+
+static void emit_frame(Transport* t, uint8_t type, uint8_t seq, const uint8_t* payload, uint8_t len) {
+    uint8_t header[FRAME_HEADER] = { type, seq, len };
+    uint8_t body[TRANSPORT_MAX_PAYLOAD + FRAME_HEADER];
+
+    memcpy(body, header, FRAME_HEADER);
+    if (len) memcpy(body + FRAME_HEADER, payload, len);
+    uint16_t crc = crc16_ccitt(body, FRAME_HEADER + len);
+
+    t->link->send_byte(FRAME_FLAG, t->link->ctx);
+    for (size_t i = 0; i < (size_t)FRAME_HEADER + len; i++) {
+        put_escaped(t, body[i]);
+    }
+    put_escaped(t, (uint8_t)(crc >> 8));
+    put_escaped(t, (uint8_t)(crc & 0xFF));
+    t->link->send_byte(FRAME_FLAG, t->link->ctx);
+
+    t->stats.frames_sent++;
+}
+
+static void send_ack(Transport* t, uint8_t seq) {
+    emit_frame(t, TYPE_ACK, seq, NULL, 0);
+    t->stats.acks_sent++;
+}
+
+static void send_nack(Transport* t, uint8_t seq) {
+    emit_frame(t, TYPE_NACK, seq, NULL, 0);
+    t->stats.nacks_sent++;
+}
+
+static void transmit_slot(Transport* t, TransportSlot* slot) {
+    emit_frame(t, slot->type, slot->seq, slot->data, slot->len);
+    slot->sent_at = now_ms(t);
+    slot->tries++;
+}
+
+void transport_init(Transport* t, const TransportLink* link) {
+    memset(t, 0, sizeof(*t));
+    t->link = link;
+    // Secuencia inicial variable: si el otro extremo conserva estado de una
+    // sesión anterior, no confundirá nuestras tramas con duplicados.
+    t->tx_base = t->tx_next = (uint8_t)(now_ms(t) * 37u);
+    t->tx_queued_all = true;
+}
+
+void transport_set_rx_buffer(Transport* t, uint8_t* buffer, size_t capacity) {
+    t->rx_msg = buffer;
+    t->rx_cap = capacity;
+    t->rx_len = 0;
+    t->rx_active = false;
+    t->rx_complete = false;
+    t->rx_truncated = false;
+}
+
+bool transport_send(Transport* t, const uint8_t* data, size_t len) {
+    if (!transport_send_done(t) && !t->tx_failed) return false;
+
+    t->tx_msg = data;
+    t->tx_len = len;
+    t->tx_offset = 0;
+    t->tx_queued_all = false;
+    t->tx_failed = false;
+    t->tx_base = t->tx_next;
+    memset(t->tx_slots, 0, sizeof(t->tx_slots));
+    return true;
+}
+
+// Llena la ventana con las siguientes tramas del mensaje
+static void fill_window(Transport* t) {
+    while (!t->tx_queued_all && seq_offset(t->tx_next, t->tx_base) < TRANSPORT_WINDOW) {
+        TransportSlot* slot = &t->tx_slots[t->tx_next % TRANSPORT_WINDOW];
+        size_t remaining = t->tx_len - t->tx_offset;
+        uint8_t chunk = remaining > TRANSPORT_MAX_PAYLOAD ? TRANSPORT_MAX_PAYLOAD : (uint8_t)remaining;
+
+        slot->type = TYPE_DATA;
+        if (t->tx_offset == 0) slot->type |= FLAG_START;
+        if (t->tx_offset + chunk == t->tx_len) {
+            slot->type |= FLAG_END;
+            t->tx_queued_all = true;
+        }
+        memcpy(slot->data, t->tx_msg + t->tx_offset, chunk);
+        slot->len = chunk;
+        slot->seq = t->tx_next;
+        slot->tries = 0;
+        slot->in_use = true;
+        slot->acked = false;
+
+        t->tx_offset += chunk;
+        t->tx_next++;
+        transmit_slot(t, slot);
+    }
+}
+
+// Da por entregado el mensaje en curso y libera la ventana
+static void release_tx(Transport* t) {
+    t->tx_queued_all = true;
+    t->tx_base = t->tx_next;
+    for (int i = 0; i < TRANSPORT_WINDOW; i++) {
+        t->tx_slots[i].in_use = false;
+    }
+}
+
+static TransportSlot* tx_slot_for(Transport* t, uint8_t seq) {
+    if (seq_offset(seq, t->tx_base) >= seq_offset(t->tx_next, t->tx_base)) return NULL;
+    TransportSlot* slot = &t->tx_slots[seq % TRANSPORT_WINDOW];
+    return (slot->in_use && slot->seq == seq) ? slot : NULL;
+}
+
+static void handle_ack(Transport* t, uint8_t seq) {
+    TransportSlot* slot = tx_slot_for(t, seq);
+    if (!slot) return;
+    slot->acked = true;
+
+    // Deslizar la ventana sobre las tramas ya confirmadas
+    while (t->tx_base != t->tx_next) {
+        TransportSlot* base = &t->tx_slots[t->tx_base % TRANSPORT_WINDOW];
+        if (!base->in_use || !base->acked) break;
+        base->in_use = false;
+        t->tx_base++;
+    }
+}
+
+static void handle_nack(Transport* t, uint8_t seq) {
+    TransportSlot* slot = tx_slot_for(t, seq);
+    // Evitar tormentas de NACK: sólo una retransmisión por cuarto de RTO
+    if (slot && !slot->acked && now_ms(t) - slot->sent_at >= TRANSPORT_RTO_MS / 4) {
+        t->stats.retransmissions++;
+        transmit_slot(t, slot);
+    }
+}
+
+// Entrega al mensaje las tramas consecutivas disponibles
+static void drain_rx(Transport* t) {
+    while (true) {
+        TransportSlot* slot = &t->rx_slots[t->rx_expected % TRANSPORT_WINDOW];
+        if (!slot->in_use || slot->seq != t->rx_expected) break;
+
+        if (slot->type & FLAG_START) {
+            t->rx_len = 0;
+            t->rx_truncated = false;
+            // El protocolo es petición/respuesta: el otro extremo sólo empieza
+            // un mensaje nuevo cuando recibió entero el nuestro, así que sus
+            // ACK pendientes ya no importan.
+            if (t->tx_queued_all) release_tx(t);
+        }
+        size_t room = t->rx_cap > t->rx_len ? t->rx_cap - t->rx_len : 0;
+        size_t copy = slot->len < room ? slot->len : room;
+        if (copy) memcpy(t->rx_msg + t->rx_len, slot->data, copy);
+        if (copy < slot->len) t->rx_truncated = true;
+        t->rx_len += copy;
+        t->stats.payload_delivered += slot->len;
+
+        t->rx_active = !(slot->type & FLAG_END);
+        if (slot->type & FLAG_END) t->rx_complete = true;
+
+        slot->in_use = false;
+        t->rx_expected++;
+        t->nack_sent = false;
+    }
+}
+
+static void handle_data(Transport* t, uint8_t type, uint8_t seq, const uint8_t* payload, uint8_t len) {
+    uint8_t offset = seq_offset(seq, t->rx_expected);
+    uint8_t behind = seq_offset(t->rx_expected, seq);
+
+    // Trama ya entregada (se perdió nuestro ACK): confirmar de nuevo
+    if (offset >= TRANSPORT_WINDOW && behind > 0 && behind <= TRANSPORT_WINDOW) {
+        t->stats.duplicates++;
+        send_ack(t, seq);
+        return;
+    }
+
+    // Inicio de mensaje fuera de ventana: el emisor empezó una sesión nueva
+    if (offset >= TRANSPORT_WINDOW && (type & FLAG_START) && !t->rx_active) {
+        memset(t->rx_slots, 0, sizeof(t->rx_slots));
+        t->rx_expected = seq;
+        offset = 0;
+    }
+
+    if (offset >= TRANSPORT_WINDOW) return;
+
+    TransportSlot* slot = &t->rx_slots[seq % TRANSPORT_WINDOW];
+    if (slot->in_use && slot->seq == seq) {
+        t->stats.duplicates++;
+    } else {
+        memcpy(slot->data, payload, len);
+        slot->len = len;
+        slot->type = type;
+        slot->seq = seq;
+        slot->in_use = true;
+    }
+    send_ack(t, seq);
+
+    // Hueco delante: pedir la trama que falta sin esperar al timeout
+    if (offset > 0 && !t->nack_sent) {
+        send_nack(t, t->rx_expected);
+        t->nack_sent = true;
+    }
+
+    drain_rx(t);
+}
+
+static void handle_frame(Transport* t) {
+    if (t->frame_overflow || t->frame_len < FRAME_OVERHEAD) {
+        if (t->frame_len > 0) t->stats.crc_errors++;
+        return;
+    }
+
+    uint8_t len = t->frame[2];
+    if ((size_t)len + FRAME_OVERHEAD != t->frame_len || len > TRANSPORT_MAX_PAYLOAD) {
+        t->stats.crc_errors++;
+        goto corrupted;
+    }
+
+    uint16_t crc = (uint16_t)((t->frame[t->frame_len - 2] << 8) | t->frame[t->frame_len - 1]);
+    if (crc != crc16_ccitt(t->frame, t->frame_len - 2)) {
+        t->stats.crc_errors++;
+        goto corrupted;
+    }
+
+    switch (t->frame[0] & TYPE_MASK) {
+        case TYPE_DATA:
+            handle_data(t, t->frame[0], t->frame[1], t->frame + FRAME_HEADER, len);
+            break;
+        case TYPE_ACK:
+            handle_ack(t, t->frame[1]);
+            break;
+        case TYPE_NACK:
+            handle_nack(t, t->frame[1]);
+            break;
+    }
+    return;
+
+corrupted:
+    // Una trama dañada a mitad de mensaje casi siempre es la esperada
+    if (t->rx_active && !t->nack_sent) {
+        send_nack(t, t->rx_expected);
+        t->nack_sent = true;
+    }
+}
+
+static void receive_byte(Transport* t, uint8_t byte) {
+    if (byte == FRAME_FLAG) {
+        handle_frame(t);
+        t->frame_len = 0;
+        t->frame_escape = false;
+        t->frame_overflow = false;
+        return;
+    }
+
+    if (byte == FRAME_ESC) {
+        t->frame_escape = true;
+        return;
+    }
+
+    if (t->frame_escape) {
+        byte ^= FRAME_XOR;
+        t->frame_escape = false;
+    }
+
+    if (t->frame_len < sizeof(t->frame)) {
+        t->frame[t->frame_len++] = byte;
+    } else {
+        t->frame_overflow = true;
+    }
+}
+
+static void check_timers(Transport* t) {
+    uint32_t now = now_ms(t);
+    for (int i = 0; i < TRANSPORT_WINDOW; i++) {
+        TransportSlot* slot = &t->tx_slots[i];
+        if (!slot->in_use || slot->acked || now - slot->sent_at < TRANSPORT_RTO_MS) continue;
+
+        if (slot->tries >= TRANSPORT_MAX_TRIES) {
+            t->tx_failed = true;
+            return;
+        }
+        t->stats.retransmissions++;
+        transmit_slot(t, slot);
+    }
+}
+
+void transport_poll(Transport* t) {
+    uint8_t byte;
+    while (t->link->poll_byte(&byte, t->link->ctx)) {
+        receive_byte(t, byte);
+    }
+
+    if (t->tx_failed) return;
+    fill_window(t);
+    check_timers(t);
+}
+
+bool transport_send_done(const Transport* t) {
+    return t->tx_queued_all && t->tx_base == t->tx_next;
+}
+
+bool transport_failed(const Transport* t) {
+    return t->tx_failed;
+}
+
+bool transport_rx_complete(const Transport* t) {
+    return t->rx_complete;
+}
+
+size_t transport_rx_length(const Transport* t) {
+    return t->rx_len;
+}
+
+bool transport_rx_truncated(const Transport* t) {
+    return t->rx_truncated;
+}
+
+// Espera a que el receptor tenga un mensaje completo
+static bool wait_message(Transport* t, size_t* response_len, uint32_t start, uint32_t timeout_ms) {
+    while (now_ms(t) - start < timeout_ms) {
+        transport_poll(t);
+        if (t->tx_failed) return false;
+
+        // La respuesta implica que la petición llegó aunque falten ACKs
+        if (t->rx_complete) {
+            release_tx(t);
+            if (response_len) *response_len = t->rx_len;
+            return !t->rx_truncated;
+        }
+        if (t->link->idle) t->link->idle(t->link->ctx);
+    }
+
+    return false;
+}
+
+bool transport_exchange(Transport* t, const uint8_t* request, size_t request_len,
+                        uint8_t* response, size_t response_cap, size_t* response_len,
+                        uint32_t timeout_ms) {
+    transport_set_rx_buffer(t, response, response_cap);
+
+    // Un mensaje corto anterior (el latido) puede estar aún sin confirmar
+    uint32_t start = now_ms(t);
+    while (!transport_send(t, request, request_len)) {
+        if (now_ms(t) - start >= timeout_ms) return false;
+        transport_poll(t);
+        if (t->link->idle) t->link->idle(t->link->ctx);
+    }
+
+    return wait_message(t, response_len, start, timeout_ms);
+}
+
+bool transport_receive(Transport* t, uint8_t* buffer, size_t capacity, size_t* len, uint32_t timeout_ms) {
+    transport_set_rx_buffer(t, buffer, capacity);
+    return wait_message(t, len, now_ms(t), timeout_ms);
+}
@@ -0,0 +1,113 @@
+// Transporte fiable sobre el UART (uart_transport.c)
+//
+// Cada mensaje se parte en tramas de hasta TRANSPORT_MAX_PAYLOAD bytes con
+// número de secuencia y CRC16. El receptor confirma cada trama (ACK) y pide
+// la que falta con NACK; el emisor mantiene hasta TRANSPORT_WINDOW tramas en
+// vuelo y retransmite sólo las que no se confirmaron (repetición selectiva).
+//
+// Formato en el cable (delimitado y con escape al estilo HDLC):
+//   0x7E | tipo | seq | len | payload[len] | crc16 (BE) | 0x7E
+// 0x7E y 0x7D dentro de la trama se envían como 0x7D, byte ^ 0x20.
+
+#ifndef UART_TRANSPORT_H
+#define UART_TRANSPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TRANSPORT_WINDOW        4
+#define TRANSPORT_MAX_PAYLOAD   64
+#define TRANSPORT_RTO_MS        50    // ~2 ventanas de 64 B a 115200 baudios
+#define TRANSPORT_MAX_TRIES     16    // Envíos por trama antes de abortar
+
+// Acceso al enlace físico. poll_byte no debe bloquear.
+typedef struct {
+    bool (*send_byte)(uint8_t byte, void* ctx);
+    bool (*poll_byte)(uint8_t* byte, void* ctx);
+    uint32_t (*millis)(void* ctx);
+    void* ctx;
+    void (*idle)(void* ctx);    // Opcional: espera entre sondeos de transport_exchange (WFI)
+} TransportLink;
+
+typedef struct {
+    uint32_t frames_sent;
+    uint32_t retransmissions;
+    uint32_t acks_sent;
+    uint32_t nacks_sent;
+    uint32_t crc_errors;
+    uint32_t duplicates;
+    uint32_t payload_delivered;
+} TransportStats;
+
+typedef struct {
+    uint8_t data[TRANSPORT_MAX_PAYLOAD];
+    uint8_t len;
+    uint8_t type;
+    uint8_t seq;
+    uint8_t tries;
+    bool in_use;
+    bool acked;
+    uint32_t sent_at;
+} TransportSlot;
+
+typedef struct {
+    const TransportLink* link;
+
+    // Emisor
+    const uint8_t* tx_msg;
+    size_t tx_len;
+    size_t tx_offset;
+    bool tx_queued_all;
+    bool tx_failed;
+    uint8_t tx_base;              // Secuencia más antigua sin confirmar
+    uint8_t tx_next;              // Siguiente secuencia libre
+    TransportSlot tx_slots[TRANSPORT_WINDOW];
+
+    // Receptor
+    uint8_t* rx_msg;
+    size_t rx_cap;
+    size_t rx_len;
+    bool rx_active;
+    bool rx_complete;
+    bool rx_truncated;
+    bool nack_sent;
+    uint8_t rx_expected;
+    TransportSlot rx_slots[TRANSPORT_WINDOW];
+
+    // Decodificador de tramas
+    uint8_t frame[TRANSPORT_MAX_PAYLOAD + 5];
+    size_t frame_len;
+    bool frame_escape;
+    bool frame_overflow;
+
+    TransportStats stats;
+} Transport;
+
+void transport_init(Transport* t, const TransportLink* link);
+
+// Buffer donde se reensambla el próximo mensaje recibido
+void transport_set_rx_buffer(Transport* t, uint8_t* buffer, size_t capacity);
+
+// Encola un mensaje; `data` debe seguir válido hasta transport_send_done()
+bool transport_send(Transport* t, const uint8_t* data, size_t len);
+
+// Procesa bytes entrantes, temporizadores y ventana de envío
+void transport_poll(Transport* t);
+
+bool transport_send_done(const Transport* t);
+bool transport_failed(const Transport* t);
+bool transport_rx_complete(const Transport* t);
+size_t transport_rx_length(const Transport* t);
+bool transport_rx_truncated(const Transport* t);   // El mensaje no cabía en el buffer
+
+// Envía `request` y espera el mensaje de respuesta completo (bloqueante).
+// Si el mensaje anterior aún no está confirmado, espera a que lo esté.
+bool transport_exchange(Transport* t, const uint8_t* request, size_t request_len,
+                        uint8_t* response, size_t response_cap, size_t* response_len,
+                        uint32_t timeout_ms);
+
+// Espera el siguiente mensaje completo sin enviar nada (bloqueante)
+bool transport_receive(Transport* t, uint8_t* buffer, size_t capacity, size_t* len, uint32_t timeout_ms);
+
+#endif
@@ -0,0 +1,585 @@
+// Benchmark de la app completa en el host: ejecuta extapp_main() contra el
+// shim de extapp_api con un guion de teclado y muestra, por fase, el tiempo
+// de dibujo modelado por frame, píxeles enviados y llamadas de texto.
+//
+// Con BENCH_COMPLETE_APP se simula además al Raspberry Pi sobre el UART
+// emulado (responde PONG a los latidos y SOLUTION: a cada problema).
+// La app se ejecuta una vez por configuración (dibujo directo, caché de
+// textos, compositor por bandas) para comparar el tiempo de dibujo y las
+// transacciones con el LCD por frame ("call/f"); "clears" cuenta los
+// borrados de pantalla completa, que se ven como un frame en blanco;
+// "stack" y "ram" son el máximo de pila y de arena ocupadas en cada fase.
+// Sale con código 1 si la app no termina, si el arranque no cumple su
+// presupuesto, si la memoria supera su techo o si alguna configuración
+// cambia lo que se ve en pantalla.
+//
+// La traza binaria que la app guarda al salir se copia a
+// HOST_BUILD_DIR/<configuración>.trace para host/trace_decode.c, y la sesión
+// del UART grabada (uart_session.c) a HOST_BUILD_DIR/<configuración>.uart
+// para host/session_replay.c. El tráfico no depende del dibujo: las sesiones de
+// todas las configuraciones deben ser idénticas.
+//
+// La tabla "power" separa por fase el tiempo activo estimado del núcleo
+// (dibujo modelado y extapp_msleep, que en el firmware es un bucle activo)
+// del tiempo dormido en WFI (power.c). En las fases "slow-pi" y
+// "spec-cancel" el Pi tarda PI_SLOW_MS en contestar, como una consulta
+// larga a la nube. En "pong-ahead" retiene el PONG de un latido y lo manda
+// justo delante de la respuesta de la petición siguiente.
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "extapp_api.h"
+#include "extapp_shim.h"
+#include "startup.h"
+#include "text_cache.h"
+#include "compositor.h"
+#include "arena.h"
+#include "mem_monitor.h"
+#include "profiler.h"
+#include "trace.h"
+#ifdef BENCH_COMPLETE_APP
+#include "uart_emu.h"
+#include "calc_params.h"
+#include "response_cache.h"
+#include "request_queue.h"
+#include "speculate.h"
+#include "link_monitor.h"
+#include "uart_session.h"
+#endif
+
+void extapp_main(void);
+
+// Techos de memoria. La pila es la marca de agua pintada de mem_monitor, que
+// ve todas las llamadas y no sólo las que llegan al shim; medida en el host
+// (x86-64) es orientativa: sirve para detectar buffers grandes que vuelvan
+// a la pila, no como valor exacto del STM32.
+#define BENCH_STACK_CEILING  3840    // Máximo actual ~3.5 KB, por debajo de MEM_STACK_PAINT_BYTES
+#define BENCH_ARENA_CEILING  1536    // Respuesta (1 KB) + mensaje al Pi (64 B en la app completa)
+#define PI_SLOW_MS           5000
+#define PONG_AHEAD_FRAMES    12      // Espera hasta que sale el latido; la petición va detrás
+
+// Directorio de los binarios del host; el Makefile pasa el suyo
+#ifndef HOST_BUILD_DIR
+#define HOST_BUILD_DIR       "target/host"
+#endif
+
+#define K_UP    SCANCODE_Up
+#define K_DOWN  SCANCODE_Down
+#define K_OK    SCANCODE_OK
+#define K_BACK  SCANCODE_Back
+#define K_RIGHT SCANCODE_Right
+#define K_TOOLBOX SCANCODE_Toolbox
+#define K_SHIFT SCANCODE_Shift
+
+static const ShimKeyStep script[] = {
+    { "startup",   0,      2  },
+    { "menu-idle", 0,      40 },
+    { "menu-nav",  K_DOWN, 4  }, { "menu-nav", K_DOWN, 4 }, { "menu-nav", K_DOWN, 4 },
+    { "menu-nav",  K_UP,   4  }, { "menu-nav", K_UP,   4 }, { "menu-nav", K_UP,   4 },
+#ifdef BENCH_COMPLETE_APP
+    { "edit",      K_OK,   4  }, { "edit", K_RIGHT, 4 }, { "edit", K_DOWN, 4 }, { "edit", K_RIGHT, 4 },
+#endif
+    { "request",   K_OK,   4  },
+    { "result",    0,      40 },
+#ifdef BENCH_COMPLETE_APP
+    // Superposición del perfilador encendida y apagada: la pantalla final
+    // es la del resultado, igual en todas las configuraciones
+    { "overlay",   K_TOOLBOX, 10 }, { "overlay", K_TOOLBOX, 10 },
+    // Campos de la respuesta y su texto completo, y vuelta a los campos
+    { "result",    K_RIGHT, 10 }, { "result", K_RIGHT, 10 },
+#endif
+    { "result",    K_OK,   4  },
+#ifdef BENCH_COMPLETE_APP
+    // Mismos parámetros otra vez: sale de la caché de respuestas
+    { "cached",    K_OK,   4  }, { "cached", K_OK, 20 },
+    { "result",    K_OK,   4  },
+    { "menu-nav",  K_DOWN, 4  }, { "menu-nav", K_DOWN, 4 }, { "menu-nav", K_DOWN, 4 },
+    { "menu-nav",  K_DOWN, 4  }, { "menu-nav", K_DOWN, 4 },
+    { "test",      K_OK,   60 },
+    { "result",    K_OK,   4  },
+    { "menu-nav",  K_DOWN, 4  },
+    { "diag",      K_OK,   40 },
+    { "diag",      K_RIGHT, 20 },
+    { "diag",      K_BACK, 4  },
+    { "menu-nav",  K_UP,   4  }, { "menu-nav", K_UP, 4 }, { "menu-nav", K_UP, 4 },
+    { "menu-nav",  K_UP,   4  }, { "menu-nav", K_UP, 4 }, { "menu-nav", K_UP, 4 },
+    // El Pi deja de responder hasta que el latido da el enlace por caído; la
+    // petición (otra edad) va a la cola y sale en una tanda al volver el Pi.
+    // Después se abre desde el historial.
+    { "offline",   0,      240 },
+    { "queued",    K_OK,   4  }, { "queued", K_RIGHT, 4 }, { "queued", K_OK, 20 },
+    { "queued",    K_OK,   4  },
+    { "flush",     0,      100 },
+    { "menu-nav",  K_DOWN, 4  }, { "menu-nav", K_DOWN, 4 }, { "menu-nav", K_DOWN, 4 },
+    { "menu-nav",  K_DOWN, 4  }, { "menu-nav", K_DOWN, 4 }, { "menu-nav", K_DOWN, 4 },
+    { "menu-nav",  K_DOWN, 4  },
+    { "history",   K_OK,   20 }, { "history", K_OK, 20 }, { "history", K_OK, 4 },
+    { "menu-nav",  K_UP,   4  }, { "menu-nav", K_UP, 4 }, { "menu-nav", K_UP, 4 },
+    { "menu-nav",  K_UP,   4  }, { "menu-nav", K_UP, 4 }, { "menu-nav", K_UP, 4 },
+    { "menu-nav",  K_UP,   4  },
+    // Shift activa la especulación: al pararse en una fila su cálculo sale
+    // antes de OK. La siguiente fila también se pide y no se usa.
+    { "prefetch",  K_SHIFT, 4 },
+    { "prefetch",  K_DOWN, 30 }, { "prefetch", K_DOWN, 30 }, { "prefetch", K_UP, 30 },
+    { "prefetch",  K_OK,   4  }, { "prefetch", K_OK, 20 }, { "prefetch", K_OK, 4 },
+    { "prefetch",  K_UP,   4  }, { "prefetch", K_SHIFT, 4 },
+    // Otra edad: la respuesta tarda PI_SLOW_MS y la espera debe ser inactiva
+    { "slow-pi",   K_OK,   4  }, { "slow-pi", K_RIGHT, 4 }, { "slow-pi", K_RIGHT, 4 },
+    { "slow-pi",   K_OK,   20 }, { "slow-pi", K_OK, 4 },
+    // Con el Pi lento, la especulativa del editor se cancela al cambiar la
+    // edad y OK envía la real detrás sin esperarla
+    { "spec-cancel", K_SHIFT, 4 }, { "spec-cancel", K_OK, 4 }, { "spec-cancel", K_RIGHT, 30 },
+    { "spec-cancel", K_RIGHT, 4 }, { "spec-cancel", K_OK, 20 }, { "spec-cancel", K_OK, 4 },
+    { "spec-cancel", K_SHIFT, 4 },
+    // El PONG de un latido llega justo delante de la respuesta: la petición
+    // lo consume y el latido no puede contar como perdido
+    { "pong-ahead", K_OK,   4  }, { "pong-ahead", K_RIGHT, 4 }, { "pong-ahead", 0, PONG_AHEAD_FRAMES },
+    { "pong-ahead", K_OK,   40 }, { "pong-ahead", K_OK, 4 },
+    // Tabla de primas edad x plazo: se calcula al entrar y se desplaza
+    { "menu-nav",  K_DOWN, 4  }, { "menu-nav", K_DOWN, 4 }, { "menu-nav", K_DOWN, 4 },
+    { "menu-nav",  K_DOWN, 4  }, { "menu-nav", K_DOWN, 4 }, { "menu-nav", K_DOWN, 4 },
+    { "menu-nav",  K_DOWN, 4  }, { "menu-nav", K_DOWN, 4 },
+    { "schedule",  K_OK,   20 }, { "schedule", K_DOWN, 4 }, { "schedule", K_DOWN, 4 },
+    { "schedule",  K_RIGHT, 4 }, { "schedule", 0, 20 }, { "schedule", K_BACK, 4 },
+#endif
+    { "exit",      K_BACK, 1  },
+};
+
+#ifdef BENCH_COMPLETE_APP
+static char pi_line[600];
+static size_t pi_len;
+
+// Registros distintos que llegaron al Pi (su propia caché por parámetros)
+#define PI_SEEN_MAX 16
+static uint8_t pi_seen[PI_SEEN_MAX][CALC_RECORD_SIZE];
+static uint32_t pi_requests;
+static uint32_t pi_distinct;
+
+// PONG retenido en la fase "pong-ahead": sale delante de la siguiente
+// respuesta o, si no llega petición, a mitad del timeout del latido
+static bool pi_pong_held;
+static uint64_t pi_pong_due_ns;
+static uint32_t pi_pong_ahead;
+static bool pi_pong_missed;
+
+// Respuestas retenidas en las fases lentas hasta su hora, en orden
+#define PI_DELAYED_MAX 2
+static char pi_delayed[PI_DELAYED_MAX][400];
+static uint64_t pi_delayed_due_ns[PI_DELAYED_MAX];
+static uint32_t pi_delayed_count;
+
+static void pi_note_record(const CalcParams* params) {
+    uint8_t record[CALC_RECORD_SIZE];
+    calc_params_encode(params, record);
+    pi_requests++;
+    for (uint32_t i = 0; i < pi_distinct; i++) {
+        if (memcmp(pi_seen[i], record, CALC_RECORD_SIZE) == 0) return;
+    }
+    if (pi_distinct < PI_SEEN_MAX) memcpy(pi_seen[pi_distinct++], record, CALC_RECORD_SIZE);
+}
+
+// Respuesta determinista con los parámetros decodificados: comprueba el
+// registro de ida y vuelta
+static void pi_answer(const CalcParams* params) {
+    char reply[400];
+    size_t len = (size_t)snprintf(reply, sizeof(reply), "SOLUTION:%s:",
+                                  calc_product_name((CalcProduct)params->product));
+    for (int f = 0; f < CALC_FIELD_COUNT; f++) {
+        if (!calc_field_used((CalcProduct)params->product, (CalcField)f)) continue;
+        char value[24];
+        calc_field_format(params, (CalcField)f, value, sizeof(value));
+        len += (size_t)snprintf(reply + len, sizeof(reply) - len, " %s %s,",
+                                calc_field_label((CalcProduct)params->product, (CalcField)f), value);
+    }
+    snprintf(reply + len - 1, sizeof(reply) - len + 1, ". Monthly premium $42.17.\n");
+    const char* phase = extapp_shim_current_phase();
+    if ((strcmp(phase, "slow-pi") == 0 || strcmp(phase, "spec-cancel") == 0) &&
+        pi_delayed_count < PI_DELAYED_MAX) {
+        memcpy(pi_delayed[pi_delayed_count], reply, sizeof(reply));
+        pi_delayed_due_ns[pi_delayed_count++] = extapp_shim_now_ns() + (uint64_t)PI_SLOW_MS * 1000000;
+        return;
+    }
+    uart_emu_push_rx_string(reply);
+}
+
+// La app sólo ve pasar el tiempo mientras espera: ahí llega lo retenido
+static void pi_idle(void) {
+    if (pi_pong_held && extapp_shim_now_ns() >= pi_pong_due_ns) {
+        uart_emu_push_rx_string("PONG\n");
+        pi_pong_held = false;
+    }
+    if (strcmp(extapp_shim_current_phase(), "pong-ahead") == 0 && link_monitor_state() != LINK_UP) {
+        pi_pong_missed = true;
+    }
+    while (pi_delayed_count && extapp_shim_now_ns() >= pi_delayed_due_ns[0]) {
+        uart_emu_push_rx_string(pi_delayed[0]);
+        memmove(pi_delayed[0], pi_delayed[1], (pi_delayed_count - 1) * sizeof(pi_delayed[0]));
+        memmove(pi_delayed_due_ns, pi_delayed_due_ns + 1, (pi_delayed_count - 1) * sizeof(pi_delayed_due_ns[0]));
+        pi_delayed_count--;
+    }
+}
+
+// Fases del guion en las que el Pi no contesta a nada
+static bool pi_offline(void) {
+    const char* phase = extapp_shim_current_phase();
+    return strcmp(phase, "offline") == 0 || strcmp(phase, "queued") == 0;
+}
+
+static void pi_responder(uint8_t byte, void* ctx) {
+    if (byte != '\n') {
+        if (pi_len < sizeof(pi_line) - 1) pi_line[pi_len++] = (char)byte;
+        return;
+    }
+    pi_line[pi_len] = '\0';
+    pi_len = 0;
+    if (pi_offline()) return;
+
+    bool pong_ahead = strcmp(extapp_shim_current_phase(), "pong-ahead") == 0;
+    if (strcmp(pi_line, "PING") == 0) {
+        if (pong_ahead) {
+            pi_pong_held = true;
+            pi_pong_due_ns = extapp_shim_now_ns() + (uint64_t)LINK_PING_TIMEOUT_MS * 500000;
+        } else {
+            uart_emu_push_rx_string("PONG\n");
+        }
+    } else {
+        CalcParams params;
+        if (pi_pong_held) {
+            uart_emu_push_rx_string("PONG\n");
+            pi_pong_held = false;
+            pi_pong_ahead++;
+        }
+        if (calc_params_from_message(pi_line, strlen(pi_line), &params)) {
+            pi_note_record(&params);
+            pi_answer(&params);
+        }
+    }
+}
+#endif
+
+// Configuraciones comparadas. Cada una corre en un proceso hijo porque
+// extapp_main() deja su estado en variables estáticas.
+typedef struct {
+    const char* name;
+    size_t text_cache_budget;
+    bool compositor;
+} BenchConfig;
+
+static const BenchConfig configs[] = {
+    { "direct",     0,                 false },
+    { "text-cache", TEXT_CACHE_BUDGET, false },
+    { "compositor", TEXT_CACHE_BUDGET, true  },
+};
+
+typedef struct {
+    ShimPhaseStats phases[SHIM_MAX_PHASES];
+    size_t phase_count;
+    ShimPhaseStats total;
+    TextCacheStats cache;
+    CompositorStats compositor;
+    MemStateStats mem[MEM_MONITOR_STATES];
+    uint32_t stack_high_water;
+    uint32_t stack_painted;
+    bool stack_saturated;
+    ProfStageStats profile[PROF_STAGE_COUNT];
+#ifdef BENCH_COMPLETE_APP
+    ResponseCacheStats responses;
+    QueueStats queue;
+    uint32_t queue_pending;
+    SpeculateStats speculation;
+    uint32_t pi_requests;
+    uint32_t pi_distinct;
+    uint32_t pong_ahead;
+    bool pong_missed;
+    uint32_t session_bytes;
+    uint32_t session_hash;
+    bool session_truncated;
+#endif
+    uint32_t trace_bytes;
+    bool exited;
+} BenchRun;
+
+// Copia un fichero que dejó la app a HOST_BUILD_DIR/<configuración>.<ext>;
+// devuelve los bytes copiados (0 si la app no lo escribió)
+static uint32_t copy_file(const char* name, const BenchConfig* config, const char* ext) {
+    size_t len;
+    const char* content = extapp_fileRead(name, &len, EXTAPP_RAM_FILE_SYSTEM);
+    if (!content) return 0;
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s.%s", HOST_BUILD_DIR, config->name, ext);
+    FILE* f = fopen(path, "wb");
+    uint32_t copied = f && fwrite(content, 1, len, f) == len ? (uint32_t)len : 0;
+    if (f) fclose(f);
+    return copied;
+}
+
+static void run_app(const BenchConfig* config, BenchRun* run) {
+    extapp_shim_reset();
+    extapp_shim_set_script(script, sizeof(script) / sizeof(script[0]));
+    text_cache_set_budget(config->text_cache_budget);
+    compositor_set_enabled(config->compositor);
+    extapp_shim_set_ram_probe(mem_monitor_frame_arena);
+#ifdef BENCH_COMPLETE_APP
+    uart_emu_reset();
+    uart_emu_set_tx_hook(pi_responder, NULL);
+    extapp_shim_set_idle_hook(pi_idle);
+    pi_requests = 0;
+    pi_distinct = 0;
+    pi_delayed_count = 0;
+    pi_pong_held = false;
+    pi_pong_ahead = 0;
+    pi_pong_missed = false;
+#endif
+
+    memset(run, 0, sizeof(*run));
+    run->exited = extapp_shim_run(extapp_main);
+    run->phase_count = extapp_shim_phase_count();
+    for (size_t i = 0; i < run->phase_count; i++) {
+        run->phases[i] = *extapp_shim_phase(i);
+    }
+    extapp_shim_total(&run->total);
+    text_cache_get_stats(&run->cache);
+    compositor_get_stats(&run->compositor);
+    for (int i = 0; i < MEM_MONITOR_STATES; i++) {
+        run->mem[i] = *mem_monitor_state((uint8_t)i);
+    }
+    run->stack_high_water = (uint32_t)mem_monitor_stack_high_water();
+    run->stack_painted = (uint32_t)mem_monitor_stack_painted();
+    run->stack_saturated = mem_monitor_stack_saturated();
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        run->profile[i] = *profiler_stage((ProfStage)i);
+    }
+#ifdef BENCH_COMPLETE_APP
+    response_cache_get_stats(&run->responses);
+    request_queue_get_stats(&run->queue);
+    run->queue_pending = request_queue_pending();
+    speculate_get_stats(&run->speculation);
+    run->pi_requests = pi_requests;
+    run->pi_distinct = pi_distinct;
+    run->pong_ahead = pi_pong_ahead;
+    run->pong_missed = pi_pong_missed;
+#endif
+
+    // La traza sólo existe si la app la volcó (la variante UART no lo hace)
+    run->trace_bytes = copy_file(TRACE_FILE_NAME, config, "trace");
+#ifdef BENCH_COMPLETE_APP
+    run->session_bytes = copy_file(UART_SESSION_FILE_NAME, config, "uart");
+    run->session_truncated = uart_session_truncated();
+    size_t len;
+    const uint8_t* session = (const uint8_t*)extapp_fileRead(UART_SESSION_FILE_NAME, &len, EXTAPP_RAM_FILE_SYSTEM);
+    run->session_hash = 2166136261u;
+    for (size_t i = 0; session && i < len; i++) run->session_hash = (run->session_hash ^ session[i]) * 16777619u;
+#endif
+}
+
+static bool run_in_child(const BenchConfig* config, BenchRun* run) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        close(fds[0]);
+        run_app(config, run);
+        ssize_t written = write(fds[1], run, sizeof(*run));
+        _exit(written == (ssize_t)sizeof(*run) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    size_t got = 0;
+    while (got < sizeof(*run)) {
+        ssize_t n = read(fds[0], (char*)run + got, sizeof(*run) - got);
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    return got == sizeof(*run) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void print_phase(const ShimPhaseStats* p) {
+    double avg_us = p->drawn_frames ? (double)p->work_ns / p->drawn_frames / 1000.0 : 0.0;
+    double calls = p->drawn_frames ? (double)(p->push_calls + p->text_calls) / p->drawn_frames : 0.0;
+    printf("%-10s %6lu %6lu %9.1f %9.1f %9llu %6lu %6lu %6.1f %6lu %6lu %6lu  %08lx\n",
+           p->name, (unsigned long)p->frames, (unsigned long)p->drawn_frames,
+           avg_us, p->max_work_ns / 1000.0, (unsigned long long)p->pixels,
+           (unsigned long)p->push_calls, (unsigned long)p->text_calls, calls,
+           (unsigned long)p->full_clears, (unsigned long)p->stack_peak,
+           (unsigned long)p->ram_peak, (unsigned long)p->checksum);
+}
+
+// Activo: dibujo modelado + esperas en bucle activo. Inactivo: WFI.
+static void print_power(const ShimPhaseStats* p) {
+    double active_ms = (p->work_ns + p->sleep_ns) / 1e6;
+    double idle_ms = p->idle_ns / 1e6;
+    double wall_ms = active_ms + idle_ms;
+    printf("%-10s %10.1f %10.1f %10.1f %6.1f%%\n", p->name, wall_ms, active_ms, idle_ms,
+           wall_ms > 0 ? idle_ms / wall_ms * 100.0 : 0.0);
+}
+
+static bool report(const BenchConfig* config, const BenchRun* run) {
+    printf("\n[%s]\n", config->name);
+    printf("%-10s %6s %6s %9s %9s %9s %6s %6s %6s %6s %6s %6s  %s\n",
+           "phase", "frames", "drawn", "avg_us", "max_us", "pixels", "pushes", "texts", "call/f",
+           "clears", "stack", "ram", "screen");
+    for (size_t i = 0; i < run->phase_count; i++) {
+        print_phase(&run->phases[i]);
+    }
+    print_phase(&run->total);
+
+    printf("%-10s %10s %10s %10s %7s\n", "power", "wall_ms", "active_ms", "idle_ms", "idle");
+    for (size_t i = 0; i < run->phase_count; i++) {
+        print_power(&run->phases[i]);
+    }
+    print_power(&run->total);
+
+    // Primer frame + inicialización diferida, con el coste de dibujo modelado
+    double startup_ms = run->phases[0].work_ns / 1e6;
+    printf("startup: %.1f ms until ready (budget %d ms)\n", startup_ms, STARTUP_BUDGET_MS);
+    printf("text cache: %lu hits, %lu misses, %lu rejected, %lu sprites, %lu bytes\n",
+           (unsigned long)run->cache.hits, (unsigned long)run->cache.misses,
+           (unsigned long)run->cache.rejected, (unsigned long)run->cache.entries,
+           (unsigned long)run->cache.bytes_used);
+    if (config->compositor) {
+        printf("compositor: %lu bands pushed, %lu skipped, %lu overlay texts, %lu preserved, %lu dropped\n",
+               (unsigned long)run->compositor.bands_pushed, (unsigned long)run->compositor.bands_skipped,
+               (unsigned long)run->compositor.overlay_texts, (unsigned long)run->compositor.preserved_texts,
+               (unsigned long)run->compositor.dropped_items);
+    }
+
+#ifdef BENCH_COMPLETE_APP
+    printf("requests: %lu sent to the Pi (%lu distinct records), %lu answered from the response cache\n",
+           (unsigned long)run->pi_requests, (unsigned long)run->pi_distinct,
+           (unsigned long)run->responses.hits);
+    printf("queue: %lu queued offline, %lu batches, %lu sent, %lu answered, %lu still pending\n",
+           (unsigned long)run->queue.queued, (unsigned long)run->queue.batches, (unsigned long)run->queue.sent,
+           (unsigned long)run->queue.answered, (unsigned long)run->queue_pending);
+    const SpeculateStats* spec = &run->speculation;
+    printf("prefetch: %lu started, %lu hits (%.0f%%, %lu still in flight at OK), %lu cancelled, %lu unused, "
+           "%lu wasted bytes\n", (unsigned long)spec->started, (unsigned long)spec->hits,
+           spec->started ? 100.0 * spec->hits / spec->started : 0.0, (unsigned long)spec->promoted,
+           (unsigned long)spec->cancelled, (unsigned long)spec->unused, (unsigned long)spec->wasted_bytes);
+#endif
+
+    // Tiempo real de la CPU del host (CLOCK_MONOTONIC), no el modelo del shim
+    printf("profile (host us): ");
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        const ProfStageStats* s = &run->profile[i];
+        if (!s->count) continue;
+        printf("%s %lux%lu/%lu ", profiler_stage_name((ProfStage)i), (unsigned long)s->count,
+               (unsigned long)s->last_us, (unsigned long)s->worst_us);
+    }
+    printf("\n");
+    if (run->trace_bytes) {
+        printf("trace: %lu bytes in %s/%s.trace\n", (unsigned long)run->trace_bytes, HOST_BUILD_DIR,
+               config->name);
+    }
+#ifdef BENCH_COMPLETE_APP
+    printf("session: %lu bytes in %s/%s.uart%s\n", (unsigned long)run->session_bytes, HOST_BUILD_DIR,
+           config->name, run->session_truncated ? " (truncated)" : "");
+#endif
+
+    bool pass = true;
+#ifdef BENCH_COMPLETE_APP
+    if (run->queue.queued == 0 || run->queue.answered != run->queue.queued || run->queue_pending) {
+        printf("FAIL: offline requests were not flushed when the link came back\n");
+        pass = false;
+    }
+    if (run->speculation.hits == 0) {
+        printf("FAIL: the prefetched request was not used when OK was pressed\n");
+        pass = false;
+    }
+    if (run->speculation.cancelled == 0) {
+        printf("FAIL: the cancelled prefetch was not discarded behind the real request\n");
+        pass = false;
+    }
+    if (run->pong_ahead == 0) {
+        printf("FAIL: no heartbeat PONG arrived ahead of a response\n");
+        pass = false;
+    }
+    if (run->pong_missed) {
+        printf("FAIL: a PONG read by the request still counted as a missed heartbeat\n");
+        pass = false;
+    }
+    for (size_t i = 0; i < run->phase_count; i++) {
+        const ShimPhaseStats* p = &run->phases[i];
+        if (strcmp(p->name, "slow-pi") == 0 && p->idle_ns < (uint64_t)PI_SLOW_MS * 1000000) {
+            printf("FAIL: the core stayed busy while waiting for the slow Pi\n");
+            pass = false;
+        }
+    }
+    if (!run->session_bytes || run->session_truncated) {
+        printf("FAIL: the UART session was not recorded in full\n");
+        pass = false;
+    }
+#endif
+    if (!run->exited) {
+        printf("FAIL: app did not exit after the script\n");
+        pass = false;
+    }
+    if (startup_ms > STARTUP_BUDGET_MS) {
+        printf("FAIL: first frame over the startup budget\n");
+        pass = false;
+    }
+    printf("memory: stack %lu bytes (ceiling %d), arena %lu bytes (ceiling %d of %d)\n",
+           (unsigned long)run->stack_high_water, BENCH_STACK_CEILING,
+           (unsigned long)run->total.ram_peak, BENCH_ARENA_CEILING, ARENA_SIZE);
+    if (run->stack_high_water > BENCH_STACK_CEILING || run->total.ram_peak > BENCH_ARENA_CEILING) {
+        printf("FAIL: memory over its ceiling\n");
+        pass = false;
+    }
+
+    // Pila pintada bajo extapp_main por AppState; la del shim sólo se mide
+    // en las llamadas a la API
+    printf("painted stack: %lu bytes high water (shim samples %lu)\n", (unsigned long)run->stack_high_water,
+           (unsigned long)run->total.stack_peak);
+    for (int i = 0; i < MEM_MONITOR_STATES; i++) {
+        const MemStateStats* m = &run->mem[i];
+        if (!m->frames) continue;
+        printf("  state %d: %5lu frames, stack %5lu, arena %5lu\n", i, (unsigned long)m->frames,
+               (unsigned long)m->stack_peak, (unsigned long)m->arena_peak);
+    }
+    if (run->stack_saturated) {
+        printf("FAIL: stack went past the painted area (%lu bytes)\n", (unsigned long)run->stack_painted);
+        pass = false;
+    }
+    return pass;
+}
+
+int main(void) {
+    static BenchRun runs[sizeof(configs) / sizeof(configs[0])];
+    const size_t count = sizeof(configs) / sizeof(configs[0]);
+    bool pass = true;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!run_in_child(&configs[i], &runs[i])) {
+            printf("FAIL: %s run crashed\n", configs[i].name);
+            return 1;
+        }
+        pass = report(&configs[i], &runs[i]) && pass;
+    }
+
+    // Todas las configuraciones deben dejar exactamente la misma pantalla
+    printf("\n%-12s %12s %8s\n", "config", "draw_ms", "vs base");
+    for (size_t i = 0; i < count; i++) {
+        double ms = runs[i].total.work_ns / 1e6;
+        double base = runs[0].total.work_ns / 1e6;
+        printf("%-12s %12.2f %7.1f%%\n", configs[i].name, ms, base > 0 ? (ms - base) / base * 100.0 : 0.0);
+        for (size_t p = 0; p < runs[i].phase_count && i > 0; p++) {
+            if (p < runs[0].phase_count && runs[i].phases[p].checksum != runs[0].phases[p].checksum) {
+                printf("FAIL: %s leaves a different %s screen\n", configs[i].name, runs[i].phases[p].name);
+                pass = false;
+            }
+        }
+#ifdef BENCH_COMPLETE_APP
+        if (i > 0 && runs[i].session_hash != runs[0].session_hash) {
+            printf("FAIL: %s records different UART traffic\n", configs[i].name);
+            pass = false;
+        }
+#endif
+    }
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+// Piezas comunes de los benchmarks del host (host/bench_util.h)
+//
+// Reloj monotónico en ns, un sumidero volatile para que el compilador no
+// elimine lo medido y la comparación relativa de resultados. Vale desde C
+// y desde C++. Un bench con otra tolerancia, otro número de iteraciones u
+// otro tiempo mínimo define la suya antes de incluir este fichero.
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifndef ITERATIONS
+#define ITERATIONS      20000
+#endif
+#ifndef TOLERANCE
+#define TOLERANCE       1e-12   // Relativa, absoluta por debajo de 1
+#endif
+#ifndef MIN_SECONDS
+#define MIN_SECONDS     0.1     // Tiempo mínimo medido por variante
+#endif
+
+static volatile double sink __attribute__((unused));
+
+static inline double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static inline bool same_within(double a, double b, double tolerance) {
+    return fabs(a - b) <= tolerance * fmax(1.0, fabs(b));
+}
+
+static inline bool same(double a, double b) {
+    return same_within(a, b, TOLERANCE);
+}
+
+#endif
@@ -0,0 +1,203 @@
+// Benchmark de la curva de tipos (engine/yield_curve.h): coste de construir
+// la curva (interpolación + tabla densa) y de cada consulta de descuento con
+// la tabla frente a evaluar la interpolación directamente.
+//
+// Sale con código 1 si la curva no reproduce sus nodos, si los bonos par no
+// valen 1 tras el bootstrap, si la cúbica monótona se sale del rango de los
+// nodos, si una curva plana no da lo mismo que el tipo plano en las
+// plantillas y en el modelo, o si la renta y el seguro continuos con una
+// curva con pendiente no coinciden con una integración fina de referencia.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "engine/model.h"
+#include "bench_util.h"
+
+using namespace actuarial;
+
+#define BUILDS      2000
+#define LOOKUPS     1000000
+#define HORIZON     60.0
+#define AGE         35
+#define YEARS       30
+#define RATE        0.05
+#define LOOKUP_TOLERANCE        1e-7    // Parábola mensual frente a la interpolación
+#define CONTINUOUS_TOLERANCE    2e-6    // Forward medio del mes en la corrección
+
+// Curva de mercado con pendiente positiva y una con joroba
+static const double kTenors[] = { 1, 2, 3, 5, 7, 10, 15, 20, 30 };
+static const double kSpots[] = { 0.030, 0.033, 0.035, 0.038, 0.040, 0.042, 0.044, 0.045, 0.046 };
+static const double kPars[] = { 0.030, 0.0329, 0.0348, 0.0376, 0.0395, 0.0414, 0.0431, 0.0439, 0.0446 };
+static const double kHumpSpots[] = { 0.030, 0.038, 0.041, 0.043, 0.042, 0.039, 0.037, 0.036, 0.036 };
+static const int kNodes = sizeof(kTenors) / sizeof(kTenors[0]);
+
+static YieldCurve curve;
+static YieldCurve flat;
+static double lookup_t[LOOKUPS];
+static double surv[kMaxAge * 12 + 1];
+static double disc[kMaxAge * 12 + 1];
+static double disc_flat[kMaxAge * 12 + 1];
+static ValuationModel<Monthly, Due> model;
+static ValuationModel<Monthly, Due> model_flat;
+
+static bool build(YieldCurve& c, bool par, const double* rates, CurveInterpolation interp) {
+    return par ? c.build_from_par(kTenors, rates, kNodes, interp)
+               : c.build_from_spot(kTenors, rates, kNodes, interp);
+}
+
+static bool bench_build(const char* name, bool par, const double* rates, CurveInterpolation interp) {
+    double start = now_ns();
+    for (int i = 0; i < BUILDS; i++) build(curve, par, rates, interp);
+    double build_us = (now_ns() - start) / BUILDS / 1000.0;
+
+    // Consultas en puntos aleatorios: tabla frente a interpolación directa
+    start = now_ns();
+    double acc = 0.0;
+    for (int i = 0; i < LOOKUPS; i++) acc += curve.discount(lookup_t[i]);
+    double table_ns = (now_ns() - start) / LOOKUPS;
+    sink = acc;
+    start = now_ns();
+    acc = 0.0;
+    for (int i = 0; i < LOOKUPS; i++) acc += curve.discount_direct(lookup_t[i]);
+    double direct_ns = (now_ns() - start) / LOOKUPS;
+    sink = acc;
+
+    double worst = 0.0;
+    for (int i = 0; i < LOOKUPS; i += 97) {
+        const double t = lookup_t[i];
+        worst = std::fmax(worst, std::fabs(curve.discount(t) / curve.discount_direct(t) - 1.0));
+    }
+
+    printf("%-22s %9.1f %9.1f %9.1f %7.2fx %10.2e %7.3f%% %7.3f%%\n", name, build_us, table_ns, direct_ns,
+           direct_ns / table_ns, worst, curve.spot(10.0) * 100, curve.spot(25.0) * 100);
+
+    bool ok = worst < LOOKUP_TOLERANCE;
+    if (!ok) printf("FAIL: %s table lookup drifts from the interpolation (%.2e)\n", name, worst);
+
+    // Nodos: el spot o el bono par cotizado se reproducen exactamente
+    for (int i = 0; i < kNodes; i++) {
+        const double n = kTenors[i];
+        double value;
+        if (par) {
+            double annuity = 0.0;
+            for (int j = 1; j <= (int)n; j++) annuity += curve.discount(j);
+            value = rates[i] * annuity + curve.discount(n);
+        } else {
+            value = curve.discount(n) * std::pow(1.0 + rates[i], n);
+        }
+        if (!same(value, 1.0)) {
+            printf("FAIL: %s does not reprice the %g-year node (%.15f)\n", name, n, value);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Entre dos nodos la cúbica monótona no sale del rango de sus tipos
+static bool check_no_overshoot() {
+    curve.build_from_spot(kTenors, kHumpSpots, kNodes, CURVE_MONOTONE_CUBIC);
+    for (int i = 0; i + 1 < kNodes; i++) {
+        const double lo = std::fmin(kHumpSpots[i], kHumpSpots[i + 1]) - TOLERANCE;
+        const double hi = std::fmax(kHumpSpots[i], kHumpSpots[i + 1]) + TOLERANCE;
+        for (double t = kTenors[i]; t <= kTenors[i + 1]; t += 1.0 / 12) {
+            // La tabla está en la rejilla mensual: spot exacto de la interpolación
+            const double s = std::exp(-std::log(curve.discount_direct(t)) / t) - 1.0;
+            if (s < lo || s > hi) {
+                printf("FAIL: monotone cubic overshoots at %.3f years (%.5f%%)\n", t, s * 100);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Curva plana: mismas cifras que el tipo plano en plantillas y modelo
+static bool check_flat() {
+    const double tenor = 1.0, spot = RATE;
+    flat.build_from_spot(&tenor, &spot, 1, CURVE_LINEAR);
+    bool ok = true;
+
+    fill_survival<Monthly>(kStandardUltimate, AGE, YEARS, surv);
+    fill_discount<Monthly>(flat, YEARS, disc);
+    fill_discount<Monthly>(RATE, YEARS, disc_flat);
+    Basis bc = { surv, disc, YEARS, AGE, std::log(1.0 + RATE), &kStandardUltimate, 0 };
+    Basis bf = { surv, disc_flat, YEARS, AGE, std::log(1.0 + RATE), &kStandardUltimate, 0 };
+    double pc = term_premium<Monthly, Due>(bc), pf = term_premium<Monthly, Due>(bf);
+    ok = same(pc, pf) && same(term_reserve<Monthly, Due>(bc, pc, 10), term_reserve<Monthly, Due>(bf, pf, 10));
+
+    // Continuous por la vía del forward por paso frente a la identidad con delta
+    Basis bcf = bc;
+    bcf.forward = flat.forwards();
+    ok = ok && same(annuity<Continuous, Due>(bcf), annuity<Continuous, Due>(bf)) &&
+         same(term_insurance<Continuous>(bcf), term_insurance<Continuous>(bf)) &&
+         same(term_insurance<Continuous>(bcf, 10), term_insurance<Continuous>(bf, 10));
+
+    model.set_curve(&flat);
+    model_flat.set_rate(RATE);
+    const ModelResults& mc = model.results();
+    const ModelResults& mf = model_flat.results();
+    ok = ok && same(mc.premium, mf.premium) && same(mc.reserve[10], mf.reserve[10]);
+
+    if (!ok) printf("FAIL: a flat curve does not match the flat-rate valuation\n");
+    return ok;
+}
+
+// Referencia de la renta y el seguro continuos: punto medio en una rejilla
+// 100 veces más fina, supervivencia exacta y descuento de la curva
+static bool check_continuous() {
+    curve.build_from_spot(kTenors, kSpots, kNodes, CURVE_MONOTONE_CUBIC);
+    fill_survival<Continuous>(kStandardUltimate, AGE, YEARS, surv);
+    fill_discount<Continuous>(curve, YEARS, disc);
+    Basis b = { surv, disc, YEARS, AGE, 0.0, &kStandardUltimate, curve.forwards() };
+    const double a = annuity<Continuous, Due>(b);
+    const double ins = term_insurance<Continuous>(b);
+
+    const int fine = YEARS * 1200;
+    const double h = 1.0 / 1200;
+    double ref_a = 0.0, ref_ins = 0.0;
+    for (int k = 0; k < fine; k++) {
+        const double t = (k + 0.5) * h;
+        const double p = kStandardUltimate.survival(AGE, t);
+        ref_a += h * p * curve.discount(t);
+        ref_ins += h * p * kStandardUltimate.force(AGE + t) * curve.discount(t);
+    }
+
+    printf("continuous, age %d, %d years on the curve: annuity %.6f (ref %.6f, %.1e), A1 %.7f (ref %.7f, %.1e)\n",
+           AGE, YEARS, a, ref_a, std::fabs(a / ref_a - 1.0), ins, ref_ins, std::fabs(ins / ref_ins - 1.0));
+    bool ok = same_within(a, ref_a, CONTINUOUS_TOLERANCE) && same_within(ins, ref_ins, CONTINUOUS_TOLERANCE);
+    if (!ok) printf("FAIL: continuous valuation on the curve misses the fine-grid reference\n");
+    return ok;
+}
+
+int main() {
+    bool pass = true;
+
+    srand(12345);
+    for (int i = 0; i < LOOKUPS; i++) lookup_t[i] = HORIZON * rand() / RAND_MAX;
+
+    printf("%d builds, %d lookups over %.0f years\n", BUILDS, LOOKUPS, HORIZON);
+    printf("%-22s %9s %9s %9s %8s %10s %8s %8s\n", "curve", "build_us", "table_ns", "direct_ns",
+           "speedup", "max_rel", "spot10", "spot25");
+    pass = bench_build("spot linear", false, kSpots, CURVE_LINEAR) && pass;
+    pass = bench_build("spot monotone cubic", false, kSpots, CURVE_MONOTONE_CUBIC) && pass;
+    pass = bench_build("par linear", true, kPars, CURVE_LINEAR) && pass;
+    pass = bench_build("par monotone cubic", true, kPars, CURVE_MONOTONE_CUBIC) && pass;
+
+    pass = check_no_overshoot() && pass;
+    pass = check_flat() && pass;
+    pass = check_continuous() && pass;
+
+    // Misma póliza a tipo plano y con la curva de mercado
+    model.set_age(AGE);
+    model.set_years(YEARS);
+    model.set_sum_assured(100000.0);
+    model.set_curve(&curve);
+    const double premium_curve = model.results().premium;
+    model.set_curve(0);
+    model.set_rate(RATE);
+    const double premium_flat = model.results().premium;
+    printf("monthly premium, age %d, %d-year term, sum assured 100000: %.2f on the curve, %.2f at %.0f%% flat\n",
+           AGE, YEARS, premium_curve, premium_flat, RATE * 100);
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+// extapp_api.h para el host (Linux)
+//
+// Misma interfaz que la API de apps externas de Upsilon, implementada en
+// host/extapp_shim.c sobre un framebuffer RGB565 en memoria, un teclado
+// guionizado y un reloj virtual. Sólo declara lo que usan las apps.
+
+#ifndef EXTAPP_API_H
+#define EXTAPP_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LCD_WIDTH  320
+#define LCD_HEIGHT 240
+
+#define SCANCODE_Left       ((uint64_t)1 << 0)
+#define SCANCODE_Up         ((uint64_t)1 << 1)
+#define SCANCODE_Down       ((uint64_t)1 << 2)
+#define SCANCODE_Right      ((uint64_t)1 << 3)
+#define SCANCODE_OK         ((uint64_t)1 << 4)
+#define SCANCODE_Back       ((uint64_t)1 << 5)
+#define SCANCODE_Home       ((uint64_t)1 << 6)
+#define SCANCODE_OnOff      ((uint64_t)1 << 8)
+#define SCANCODE_Shift      ((uint64_t)1 << 12)
+#define SCANCODE_Alpha      ((uint64_t)1 << 13)
+#define SCANCODE_Toolbox    ((uint64_t)1 << 16)
+#define SCANCODE_Backspace  ((uint64_t)1 << 17)
+#define SCANCODE_Zero       ((uint64_t)1 << 48)
+#define SCANCODE_Dot        ((uint64_t)1 << 49)
+#define SCANCODE_EXE        ((uint64_t)1 << 52)
+
+#define EXTAPP_RAM_FILE_SYSTEM 0
+
+void extapp_pushRect(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t* pixels);
+void extapp_pushRectUniform(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color);
+void extapp_pullRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* pixels);
+int16_t extapp_drawTextLarge(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg, bool fake);
+int16_t extapp_drawTextSmall(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg, bool fake);
+uint64_t extapp_millis(void);
+void extapp_msleep(uint32_t ms);
+uint64_t extapp_scanKeyboard(void);
+
+const char* extapp_fileRead(const char* filename, size_t* len, int storage);
+bool extapp_fileWrite(const char* filename, const char* content, size_t len, int storage);
+bool extapp_fileExists(const char* filename, int storage);
+bool extapp_fileErase(const char* filename, int storage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
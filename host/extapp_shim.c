@@ -0,0 +1,395 @@
+// Implementación de extapp_api sobre un framebuffer en memoria (host)
+
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include "extapp_api.h"
+#include "extapp_shim.h"
+
+#define SHIM_MAX_FILES      16
+
+typedef struct {
+    char name[64];
+    char* content;
+    size_t len;
+    bool used;
+} ShimFile;
+
+static uint16_t framebuffer[LCD_WIDTH * LCD_HEIGHT];
+static uint64_t now_ns;
+
+static const ShimKeyStep* script;
+static size_t script_count;
+static size_t script_step;
+static uint32_t step_frame;
+static uint32_t idle_frames;
+static jmp_buf exit_jump;
+static bool running;
+static uintptr_t stack_base;
+static size_t (*ram_probe)(void);
+static void (*idle_hook)(void);
+
+static ShimPhaseStats phases[SHIM_MAX_PHASES];
+static size_t phase_count;
+static ShimPhaseStats* current_phase;
+static ShimPhaseStats frame;      // Acumulado del frame en curso
+
+static ShimFile files[SHIM_MAX_FILES];
+
+static ShimPhaseStats* phase_for(const char* name) {
+    for (size_t i = 0; i < phase_count; i++) {
+        if (strcmp(phases[i].name, name) == 0) return &phases[i];
+    }
+    if (phase_count == SHIM_MAX_PHASES) return &phases[SHIM_MAX_PHASES - 1];
+    phases[phase_count].name = name;
+    return &phases[phase_count++];
+}
+
+// FNV-1a de la pantalla: permite comprobar que una optimización de dibujo
+// deja exactamente los mismos píxeles
+static uint32_t framebuffer_checksum(void) {
+    const uint8_t* bytes = (const uint8_t*)framebuffer;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(framebuffer); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void close_frame(void) {
+    ShimPhaseStats* p = current_phase;
+    if (!p) return;
+
+    p->frames++;
+    if (frame.pixels || frame.text_calls) p->drawn_frames++;
+    p->work_ns += frame.work_ns;
+    if (frame.work_ns > p->max_work_ns) p->max_work_ns = frame.work_ns;
+    p->sleep_ns += frame.sleep_ns;
+    p->idle_ns += frame.idle_ns;
+    p->pixels += frame.pixels;
+    p->push_calls += frame.push_calls;
+    p->text_calls += frame.text_calls;
+    p->glyphs += frame.glyphs;
+    p->full_clears += frame.full_clears;
+    if (ram_probe) {
+        size_t ram = ram_probe();
+        if (ram > frame.ram_peak) frame.ram_peak = (uint32_t)ram;
+    }
+    if (frame.ram_peak > p->ram_peak) p->ram_peak = frame.ram_peak;
+    if (frame.stack_peak > p->stack_peak) p->stack_peak = frame.stack_peak;
+    p->checksum = framebuffer_checksum();
+    memset(&frame, 0, sizeof(frame));
+}
+
+// Profundidad de pila de la app en cada llamada a la API (crece hacia abajo)
+static __attribute__((noinline)) void sample_stack(void) {
+    volatile char marker;
+    uintptr_t here = (uintptr_t)&marker;
+    if (!running || here > stack_base) return;
+    if (stack_base - here > frame.stack_peak) frame.stack_peak = (uint32_t)(stack_base - here);
+}
+
+// El coste de dibujo no adelanta el reloj de la app: así su comportamiento
+// (redibujos, latidos, timeouts) es el mismo en todas las configuraciones
+static void charge(uint64_t ns) {
+    frame.work_ns += ns;
+    sample_stack();
+}
+
+// Recorta el rectángulo a la pantalla; false si queda vacío
+static bool clip(int* x, int* y, int* w, int* h, int* skip_x, int* skip_y) {
+    *skip_x = *x < 0 ? -*x : 0;
+    *skip_y = *y < 0 ? -*y : 0;
+    *x += *skip_x;
+    *y += *skip_y;
+    *w -= *skip_x;
+    *h -= *skip_y;
+    if (*x + *w > LCD_WIDTH) *w = LCD_WIDTH - *x;
+    if (*y + *h > LCD_HEIGHT) *h = LCD_HEIGHT - *y;
+    return *w > 0 && *h > 0;
+}
+
+void extapp_pushRect(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t* pixels) {
+    int cx = x, cy = y, cw = w, ch = h, sx, sy;
+
+    frame.push_calls++;
+    charge(SHIM_NS_PER_CALL);
+    if (!pixels || !clip(&cx, &cy, &cw, &ch, &sx, &sy)) return;
+
+    for (int row = 0; row < ch; row++) {
+        memcpy(&framebuffer[(cy + row) * LCD_WIDTH + cx],
+               &pixels[(sy + row) * w + sx], (size_t)cw * sizeof(uint16_t));
+    }
+    frame.pixels += (uint64_t)cw * ch;
+    charge((uint64_t)cw * ch * SHIM_NS_PER_PIXEL);
+}
+
+void extapp_pushRectUniform(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    int cx = x, cy = y, cw = w, ch = h, sx, sy;
+
+    frame.push_calls++;
+    charge(SHIM_NS_PER_CALL);
+    if (!clip(&cx, &cy, &cw, &ch, &sx, &sy)) return;
+    if (cw == LCD_WIDTH && ch == LCD_HEIGHT) frame.full_clears++;
+
+    for (int row = 0; row < ch; row++) {
+        uint16_t* dst = &framebuffer[(cy + row) * LCD_WIDTH + cx];
+        for (int col = 0; col < cw; col++) dst[col] = color;
+    }
+    frame.pixels += (uint64_t)cw * ch;
+    charge((uint64_t)cw * ch * SHIM_NS_PER_PIXEL);
+}
+
+void extapp_pullRect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* pixels) {
+    int cx = x, cy = y, cw = w, ch = h, sx, sy;
+
+    charge(SHIM_NS_PER_CALL);
+    if (!pixels || !clip(&cx, &cy, &cw, &ch, &sx, &sy)) return;
+
+    for (int row = 0; row < ch; row++) {
+        memcpy(&pixels[(sy + row) * w + sx],
+               &framebuffer[(cy + row) * LCD_WIDTH + cx], (size_t)cw * sizeof(uint16_t));
+    }
+    charge((uint64_t)cw * ch * SHIM_NS_PER_PIXEL);
+}
+
+static uint16_t blend(uint16_t fg, uint16_t bg, int alpha) {
+    // alpha en 0..3
+    int r = (((fg >> 11) & 0x1F) * alpha + ((bg >> 11) & 0x1F) * (3 - alpha)) / 3;
+    int g = (((fg >> 5) & 0x3F) * alpha + ((bg >> 5) & 0x3F) * (3 - alpha)) / 3;
+    int b = ((fg & 0x1F) * alpha + (bg & 0x1F) * (3 - alpha)) / 3;
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// Glifo sintético: no reproduce la fuente real, sólo su tamaño y su coste
+static void draw_glyph(char c, int x, int y, int w, int h, uint16_t fg, uint16_t bg) {
+    for (int gy = 0; gy < h; gy++) {
+        int py = y + gy;
+        for (int gx = 0; gx < w; gx++) {
+            int px = x + gx;
+            int alpha = 0;
+            if (c != ' ' && gx > 0 && gx < w - 1 && gy > 1 && gy < h - 2) {
+                alpha = ((unsigned char)c * 31 + gx * 7 + gy * 13 + (c >> 2)) & 3;
+            }
+            if (px >= 0 && px < LCD_WIDTH && py >= 0 && py < LCD_HEIGHT) {
+                framebuffer[py * LCD_WIDTH + px] = blend(fg, bg, alpha);
+            }
+        }
+    }
+}
+
+static int16_t draw_text(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg,
+                         bool fake, int w, int h) {
+    size_t len = text ? strlen(text) : 0;
+    if (fake) return (int16_t)(x + (int)len * w);
+
+    frame.text_calls++;
+    charge(SHIM_NS_PER_CALL);
+    for (size_t i = 0; i < len; i++) {
+        draw_glyph(text[i], x + (int)i * w, y, w, h, fg, bg);
+    }
+    frame.glyphs += (uint32_t)len;
+    frame.pixels += (uint64_t)len * w * h;
+    charge((uint64_t)len * SHIM_NS_PER_GLYPH);
+    charge((uint64_t)len * w * h * (SHIM_NS_PER_PIXEL + SHIM_NS_PER_GLYPH_PIXEL));
+    return (int16_t)(x + (int)len * w);
+}
+
+int16_t extapp_drawTextLarge(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg, bool fake) {
+    return draw_text(text, x, y, fg, bg, fake, SHIM_LARGE_GLYPH_W, SHIM_LARGE_GLYPH_H);
+}
+
+int16_t extapp_drawTextSmall(const char* text, int16_t x, int16_t y, uint16_t fg, uint16_t bg, bool fake) {
+    return draw_text(text, x, y, fg, bg, fake, SHIM_SMALL_GLYPH_W, SHIM_SMALL_GLYPH_H);
+}
+
+uint64_t extapp_millis(void) {
+    sample_stack();
+    return now_ns / 1000000;
+}
+
+void extapp_msleep(uint32_t ms) {
+    sample_stack();
+    now_ns += (uint64_t)ms * 1000000;
+    frame.sleep_ns += (uint64_t)ms * 1000000;
+}
+
+void extapp_shim_idle(uint32_t ms) {
+    sample_stack();
+    now_ns += (uint64_t)ms * 1000000;
+    frame.idle_ns += (uint64_t)ms * 1000000;
+    if (idle_hook) idle_hook();
+}
+
+void extapp_shim_set_idle_hook(void (*hook)(void)) {
+    idle_hook = hook;
+}
+
+uint64_t extapp_scanKeyboard(void) {
+    if (!running) return 0;
+    sample_stack();
+    close_frame();
+
+    if (script_step < script_count) {
+        const ShimKeyStep* step = &script[script_step];
+        uint64_t keys = step_frame == 0 ? step->keys : 0;
+        current_phase = phase_for(step->phase);
+        if (++step_frame >= step->frames) {
+            script_step++;
+            step_frame = 0;
+        }
+        return keys;
+    }
+
+    // Guion agotado: la app debería haber salido ya
+    current_phase = phase_for("exit");
+    if (++idle_frames > SHIM_IDLE_FRAMES) longjmp(exit_jump, 1);
+    return 0;
+}
+
+const char* extapp_shim_current_phase(void) {
+    return current_phase ? current_phase->name : "";
+}
+
+// Sistema de archivos en RAM
+
+static ShimFile* find_file(const char* name) {
+    for (int i = 0; i < SHIM_MAX_FILES; i++) {
+        if (files[i].used && strcmp(files[i].name, name) == 0) return &files[i];
+    }
+    return NULL;
+}
+
+const char* extapp_fileRead(const char* filename, size_t* len, int storage) {
+    ShimFile* f = find_file(filename);
+    if (!f) return NULL;
+    if (len) *len = f->len;
+    return f->content;
+}
+
+bool extapp_fileWrite(const char* filename, const char* content, size_t len, int storage) {
+    ShimFile* f = find_file(filename);
+    if (!f) {
+        for (int i = 0; i < SHIM_MAX_FILES && !f; i++) {
+            if (!files[i].used) f = &files[i];
+        }
+        if (!f || strlen(filename) >= sizeof(f->name)) return false;
+        strcpy(f->name, filename);
+        f->content = NULL;
+        f->used = true;
+    }
+
+    char* copy = malloc(len ? len : 1);
+    if (!copy) return false;
+    memcpy(copy, content, len);
+    free(f->content);
+    f->content = copy;
+    f->len = len;
+    return true;
+}
+
+bool extapp_fileExists(const char* filename, int storage) {
+    return find_file(filename) != NULL;
+}
+
+bool extapp_fileErase(const char* filename, int storage) {
+    ShimFile* f = find_file(filename);
+    if (!f) return false;
+    free(f->content);
+    memset(f, 0, sizeof(*f));
+    return true;
+}
+
+// Control desde el benchmark
+
+void extapp_shim_reset(void) {
+    memset(framebuffer, 0, sizeof(framebuffer));
+    now_ns = 0;
+    script = NULL;
+    script_count = 0;
+    script_step = 0;
+    step_frame = 0;
+    idle_frames = 0;
+    memset(phases, 0, sizeof(phases));
+    phase_count = 0;
+    current_phase = NULL;
+    ram_probe = NULL;
+    idle_hook = NULL;
+    memset(&frame, 0, sizeof(frame));
+    for (int i = 0; i < SHIM_MAX_FILES; i++) {
+        free(files[i].content);
+        memset(&files[i], 0, sizeof(files[i]));
+    }
+}
+
+void extapp_shim_set_script(const ShimKeyStep* steps, size_t count) {
+    script = steps;
+    script_count = count;
+    script_step = 0;
+    step_frame = 0;
+}
+
+bool extapp_shim_run(void (*app_main)(void)) {
+    bool exited = true;
+
+    // Lo que la app hace antes de su primer escaneo cuenta para la primera fase
+    current_phase = phase_for(script_count ? script[0].phase : "startup");
+    idle_frames = 0;
+    volatile char marker;
+    stack_base = (uintptr_t)&marker;
+    running = true;
+    if (setjmp(exit_jump) == 0) {
+        app_main();
+    } else {
+        exited = false;
+    }
+    close_frame();
+    running = false;
+    return exited;
+}
+
+void extapp_shim_set_ram_probe(size_t (*probe)(void)) {
+    ram_probe = probe;
+}
+
+void extapp_shim_advance_ns(uint64_t ns) {
+    now_ns += ns;
+}
+
+uint64_t extapp_shim_now_ns(void) {
+    return now_ns;
+}
+
+size_t extapp_shim_phase_count(void) {
+    return phase_count;
+}
+
+const ShimPhaseStats* extapp_shim_phase(size_t index) {
+    return index < phase_count ? &phases[index] : NULL;
+}
+
+void extapp_shim_total(ShimPhaseStats* total) {
+    memset(total, 0, sizeof(*total));
+    total->name = "total";
+    for (size_t i = 0; i < phase_count; i++) {
+        const ShimPhaseStats* p = &phases[i];
+        total->frames += p->frames;
+        total->drawn_frames += p->drawn_frames;
+        total->work_ns += p->work_ns;
+        if (p->max_work_ns > total->max_work_ns) total->max_work_ns = p->max_work_ns;
+        total->sleep_ns += p->sleep_ns;
+        total->idle_ns += p->idle_ns;
+        total->pixels += p->pixels;
+        total->push_calls += p->push_calls;
+        total->text_calls += p->text_calls;
+        total->glyphs += p->glyphs;
+        total->full_clears += p->full_clears;
+        if (p->stack_peak > total->stack_peak) total->stack_peak = p->stack_peak;
+        if (p->ram_peak > total->ram_peak) total->ram_peak = p->ram_peak;
+        total->checksum = p->checksum;
+    }
+}
+
+const uint16_t* extapp_shim_framebuffer(void) {
+    return framebuffer;
+}
@@ -0,0 +1,89 @@
+// Control del shim de extapp_api en el host (extapp_shim.c)
+//
+// El tiempo es virtual: extapp_msleep() adelanta el reloj de la app y cada
+// operación de dibujo suma un coste estimado del STM32F730 + LCD al frame,
+// sin mover ese reloj, para que la app haga exactamente lo mismo con
+// cualquier estrategia de dibujo. Los números sirven para comparar versiones
+// de la app entre sí, no como tiempo absoluto del equipo.
+//
+// Un "frame" es todo lo que hace la app entre dos llamadas consecutivas a
+// extapp_scanKeyboard(). Cada frame se atribuye a la fase del guion de
+// teclado que estaba activa cuando empezó.
+
+#ifndef EXTAPP_SHIM_H
+#define EXTAPP_SHIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Modelo de coste (ns)
+#define SHIM_NS_PER_CALL         2000   // Llamada al firmware (SVC) y preparación de la ventana del LCD
+#define SHIM_NS_PER_PIXEL        60     // Escritura de un píxel por el bus del LCD
+#define SHIM_NS_PER_GLYPH        1500   // Descompresión del glifo y ventana propia en el LCD
+#define SHIM_NS_PER_GLYPH_PIXEL  40     // Mezcla del glifo antialiasado en software
+
+#define SHIM_SMALL_GLYPH_W  7
+#define SHIM_SMALL_GLYPH_H  14
+#define SHIM_LARGE_GLYPH_W  10
+#define SHIM_LARGE_GLYPH_H  18
+
+#define SHIM_MAX_PHASES     20
+#define SHIM_IDLE_FRAMES    500    // Frames sin teclas tras el guion antes de abortar la app
+
+// Paso del guion: `keys` se pulsa en el primer frame y luego se suelta
+// durante el resto de `frames`.
+typedef struct {
+    const char* phase;
+    uint64_t keys;
+    uint32_t frames;
+} ShimKeyStep;
+
+typedef struct {
+    const char* name;
+    uint32_t frames;
+    uint32_t drawn_frames;      // Frames que tocaron el LCD
+    uint64_t work_ns;           // Tiempo de dibujo modelado (sin msleep)
+    uint64_t max_work_ns;
+    uint64_t sleep_ns;          // extapp_msleep: el firmware espera en un bucle activo
+    uint64_t idle_ns;           // Núcleo dormido (WFI) en extapp_shim_idle()
+    uint64_t pixels;            // Píxeles enviados al LCD
+    uint32_t push_calls;        // pushRect + pushRectUniform
+    uint32_t text_calls;        // drawTextLarge + drawTextSmall (no fake)
+    uint32_t glyphs;
+    uint32_t full_clears;       // pushRectUniform de pantalla completa
+    uint32_t stack_peak;        // Pila de la app (bytes) en las llamadas a la API
+    uint32_t ram_peak;          // Máximo de la sonda de RAM (p. ej. la arena)
+    uint32_t checksum;          // Hash de la pantalla al final de la fase
+} ShimPhaseStats;
+
+void extapp_shim_reset(void);
+void extapp_shim_set_script(const ShimKeyStep* steps, size_t count);
+
+// Ejecuta la app; false si no salió por sí misma antes de SHIM_IDLE_FRAMES
+bool extapp_shim_run(void (*app_main)(void));
+
+// Sonda de RAM dinámica de la app; se consulta al cerrar cada frame y
+// debe devolver el máximo alcanzado desde la consulta anterior
+void extapp_shim_set_ram_probe(size_t (*probe)(void));
+
+// Adelanta el reloj de la app, p. ej. la latencia del Pi en una petición
+void extapp_shim_advance_ns(uint64_t ns);
+uint64_t extapp_shim_now_ns(void);
+
+// Espera con el núcleo dormido (power.c en el host): adelanta el reloj como
+// extapp_msleep() pero cuenta como tiempo inactivo. El gancho se llama tras
+// cada espera, p. ej. para que un Pi simulado lento entregue su respuesta.
+void extapp_shim_idle(uint32_t ms);
+void extapp_shim_set_idle_hook(void (*hook)(void));
+
+// Fase del guion que está corriendo (p. ej. para simular un Pi caído)
+const char* extapp_shim_current_phase(void);
+
+size_t extapp_shim_phase_count(void);
+const ShimPhaseStats* extapp_shim_phase(size_t index);
+void extapp_shim_total(ShimPhaseStats* total);
+
+const uint16_t* extapp_shim_framebuffer(void);
+
+#endif
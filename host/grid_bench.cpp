@@ -0,0 +1,93 @@
+// Precisión y coste de las rejillas de valuation.h
+//
+// fill_discount y fill_survival rellenan los vectores como cadenas de
+// productos, así que el error relativo crece con k. Aquí se comparan con la
+// forma cerrada en long double (expl, powl) para varias edades, tipos y
+// frecuencias hasta kMaxAge, y se mide el coste por punto. Sale con código
+// 1 si alguna rejilla se aleja de la forma cerrada más de la cota que
+// documenta valuation.h.
+
+#include <cmath>
+#include <cstdio>
+#include "engine/valuation.h"
+#include "bench_util.h"
+
+using namespace actuarial;
+
+#define GRID_BOUND      1e-11   // Error relativo máximo de una rejilla
+
+static double surv[kMaxAge * 12 + 1];
+static double disc[kMaxAge * 12 + 1];
+
+struct Drift {
+    double discount;
+    double survival;
+};
+
+// Error relativo máximo frente a la forma cerrada en long double
+template <class Freq>
+static Drift drift(int age, double rate) {
+    const int steps = Freq::kSteps, years = kMaxAge - age;
+    fill_discount<Freq>(rate, years, disc);
+    fill_survival<Freq>(kStandardUltimate, age, years, surv);
+    const MakehamLaw& law = kStandardUltimate;
+    const long double ln_c = logl((long double)law.c), delta = logl(1.0L + rate);
+    const long double g = (long double)law.B * powl((long double)law.c, age) / ln_c;
+    Drift d = { 0.0, 0.0 };
+    for (int k = 0; k <= years * steps; k++) {
+        const long double t = (long double)k / steps;
+        const long double v = expl(-delta * t);
+        const long double s = expl(-(long double)law.A * t - g * (expl(ln_c * t) - 1.0L));
+        d.discount = std::fmax(d.discount, (double)fabsl(disc[k] / v - 1.0L));
+        // Donde la supervivencia ya es despreciable el error relativo no importa
+        if (s > 1e-12L) d.survival = std::fmax(d.survival, (double)fabsl(surv[k] / s - 1.0L));
+    }
+    return d;
+}
+
+template <class Freq>
+static bool check(const char* name, int age, double rate) {
+    const Drift d = drift<Freq>(age, rate);
+    printf("%-10s %4d %6.2f%% %14.2e %14.2e\n", name, age, rate * 100, d.discount, d.survival);
+    if (d.discount > GRID_BOUND || d.survival > GRID_BOUND) {
+        printf("FAIL: %s grid at age %d, %.2f%% drifts from the closed form\n", name, age, rate * 100);
+        return false;
+    }
+    return true;
+}
+
+// ns por punto de `fill`, repitiendo hasta MIN_SECONDS
+template <class Fill>
+static double ns_per_point(Fill fill, int points) {
+    long calls = 0;
+    const double start = now_ns();
+    double elapsed;
+    do {
+        fill();
+        calls++;
+        elapsed = now_ns() - start;
+    } while (elapsed < MIN_SECONDS * 1e9);
+    return elapsed / calls / points;
+}
+
+struct Discount { void operator()() const { fill_discount<Monthly>(0.05, kMaxAge, disc); sink = disc[kMaxAge * 12]; } };
+struct Survival { void operator()() const { fill_survival<Monthly>(kStandardUltimate, 0, kMaxAge, surv); sink = surv[kMaxAge * 12]; } };
+
+int main() {
+    bool pass = true;
+
+    printf("%-10s %4s %7s %14s %14s\n", "grid", "age", "rate", "discount_rel", "survival_rel");
+    const int ages[] = { 0, 35, 65 };
+    const double rates[] = { -0.01, 0.035, 0.25 };
+    for (int age : ages) {
+        for (double rate : rates) {
+            pass = check<Annual>("annual", age, rate) && pass;
+            pass = check<Monthly>("monthly", age, rate) && pass;
+        }
+    }
+
+    const int points = kMaxAge * 12 + 1;
+    printf("monthly, %d points: discount %.2f ns/point, survival %.2f ns/point\n", points,
+           ns_per_point(Discount(), points), ns_per_point(Survival(), points));
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+// Enlace serie con pérdidas para medir el transporte en el host
+
+#include <string.h>
+#include "lossy_link.h"
+
+static bool fifo_push(LossyFifo* f, uint8_t byte) {
+    size_t next = (f->tail + 1) % LOSSY_FIFO_SIZE;
+    if (next == f->head) return false;
+    f->data[f->tail] = byte;
+    f->tail = next;
+    return true;
+}
+
+static bool fifo_pop(LossyFifo* f, uint8_t* byte) {
+    if (f->head == f->tail) return false;
+    *byte = f->data[f->head];
+    f->head = (f->head + 1) % LOSSY_FIFO_SIZE;
+    return true;
+}
+
+// xorshift32: determinista para que las corridas sean comparables
+static uint32_t next_random(LossyLink* link) {
+    uint32_t x = link->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return link->rng = x;
+}
+
+static bool endpoint_send(uint8_t byte, void* ctx) {
+    return fifo_push(&((LossyEndpoint*)ctx)->tx, byte);
+}
+
+static bool endpoint_poll(uint8_t* byte, void* ctx) {
+    return fifo_pop(&((LossyEndpoint*)ctx)->rx, byte);
+}
+
+static uint32_t endpoint_millis(void* ctx) {
+    return lossy_link_millis(((LossyEndpoint*)ctx)->link);
+}
+
+static void endpoint_init(LossyLink* link, LossyEndpoint* ep) {
+    memset(ep, 0, sizeof(*ep));
+    ep->link = link;
+    ep->transport.send_byte = endpoint_send;
+    ep->transport.poll_byte = endpoint_poll;
+    ep->transport.millis = endpoint_millis;
+    ep->transport.ctx = ep;
+}
+
+void lossy_link_init(LossyLink* link, uint32_t baudrate, double error_rate, uint32_t seed) {
+    memset(link, 0, sizeof(*link));
+    endpoint_init(link, &link->a);
+    endpoint_init(link, &link->b);
+    link->error_rate = error_rate;
+    link->byte_time_us = 10000000u / baudrate;  // 8N1: 10 bits por byte
+    link->rng = seed ? seed : 0x2545F491u;
+}
+
+static void carry(LossyLink* link, LossyEndpoint* from, LossyEndpoint* to) {
+    uint8_t byte;
+    if (!fifo_pop(&from->tx, &byte)) return;
+
+    link->bytes_carried++;
+    double roll = (double)next_random(link) / 4294967296.0;
+    if (roll < link->error_rate) {
+        byte ^= (uint8_t)(1u << (next_random(link) % 8));
+        link->bytes_corrupted++;
+    }
+    fifo_push(&to->rx, byte);
+}
+
+void lossy_link_step(LossyLink* link) {
+    link->now_us += link->byte_time_us;
+    carry(link, &link->a, &link->b);
+    carry(link, &link->b, &link->a);
+}
+
+uint32_t lossy_link_millis(const LossyLink* link) {
+    return (uint32_t)(link->now_us / 1000);
+}
@@ -0,0 +1,46 @@
+// Enlace serie emulado con reloj virtual y corrupción de bytes.
+// Cada dirección transporta un byte por tiempo de byte (10 bits a la
+// velocidad configurada) y corrompe cada byte con probabilidad error_rate.
+
+#ifndef LOSSY_LINK_H
+#define LOSSY_LINK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "uart_transport.h"
+
+#define LOSSY_FIFO_SIZE 16384
+
+typedef struct {
+    uint8_t data[LOSSY_FIFO_SIZE];
+    size_t head, tail;
+} LossyFifo;
+
+typedef struct LossyLink LossyLink;
+
+typedef struct {
+    LossyLink* link;
+    LossyFifo tx;      // Pendiente de salir por el cable
+    LossyFifo rx;      // Ya recibido, listo para poll_byte
+    TransportLink transport;
+} LossyEndpoint;
+
+struct LossyLink {
+    LossyEndpoint a, b;
+    double error_rate;
+    uint32_t byte_time_us;
+    uint64_t now_us;
+    uint32_t rng;
+    uint64_t bytes_carried;
+    uint64_t bytes_corrupted;
+};
+
+void lossy_link_init(LossyLink* link, uint32_t baudrate, double error_rate, uint32_t seed);
+
+// Avanza un tiempo de byte y mueve un byte en cada dirección
+void lossy_link_step(LossyLink* link);
+
+uint32_t lossy_link_millis(const LossyLink* link);
+
+#endif
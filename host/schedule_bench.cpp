@@ -0,0 +1,144 @@
+// Benchmark de la tabla de primas por edad y plazo
+// (engine/premium_schedule.h): celdas por segundo de la pasada única sobre
+// vectores compartidos frente a calcular cada celda por separado con
+// fill_survival + fill_discount + term_premium.
+//
+// Sale con código 1 si alguna celda no coincide con su cálculo por
+// separado, o si la tabla de la app (premium_table.cpp, float por 1000) se
+// aparta de la referencia. Con -c [puntos básicos] sólo escribe la tabla de
+// la app en CSV por la salida estándar (`make schedule-csv`).
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "engine/premium_schedule.h"
+#include "premium_table.h"
+
+using namespace actuarial;
+
+#define RATE            0.05
+#define RATE_BP         500
+#define MIN_SECONDS     0.2     // Tiempo mínimo medido por variante
+#define TOLERANCE       1e-10   // Cociente de supervivencias frente a producto desde la edad
+#define APP_TOLERANCE   1e-6    // float de la app
+
+#include "bench_util.h"
+
+static const ScheduleGrid kGrid = { PREMIUM_TABLE_MIN_AGE, PREMIUM_TABLE_MAX_AGE,
+                                    PREMIUM_TABLE_MIN_TERM, PREMIUM_TABLE_MAX_TERM };
+
+static double work[(kMaxAge + 1) * 12 * 2];
+static double surv[PREMIUM_TABLE_MAX_TERM * 12 + 1];
+static double disc[PREMIUM_TABLE_MAX_TERM * 12 + 1];
+static double schedule[PREMIUM_TABLE_CELLS];
+static double reference[PREMIUM_TABLE_CELLS];
+static float app_table[PREMIUM_TABLE_CELLS];
+
+template <class Freq, class Timing>
+static void per_cell(double rate, double* out) {
+    for (int a = 0; a < kGrid.ages(); a++) {
+        for (int t = 0; t < kGrid.terms(); t++) {
+            const int age = kGrid.min_age + a, years = kGrid.min_term + t;
+            fill_survival<Freq>(kStandardUltimate, age, years, surv);
+            fill_discount<Freq>(rate, years, disc);
+            Basis b = { surv, disc, years, (double)age, std::log(1.0 + rate), &kStandardUltimate, 0 };
+            out[a * kGrid.terms() + t] = term_premium<Freq, Timing>(b);
+        }
+    }
+}
+
+// Tablas por segundo de `fill`, repitiendo hasta MIN_SECONDS
+template <class Fill>
+static double tables_per_second(Fill fill) {
+    int tables = 0;
+    const double start = now_ns();
+    double elapsed;
+    do {
+        fill();
+        tables++;
+        elapsed = now_ns() - start;
+    } while (elapsed < MIN_SECONDS * 1e9);
+    return tables / (elapsed / 1e9);
+}
+
+template <class Freq, class Timing>
+struct ScheduleFill {
+    void operator()() const {
+        premium_schedule<Freq, Timing>(kStandardUltimate, RATE, kGrid, work, schedule);
+        sink = schedule[kGrid.cells() - 1];
+    }
+};
+
+template <class Freq, class Timing>
+struct PerCellFill {
+    void operator()() const {
+        per_cell<Freq, Timing>(RATE, reference);
+        sink = reference[kGrid.cells() - 1];
+    }
+};
+
+template <class Freq, class Timing>
+static bool bench(const char* name) {
+    const double schedule_rate = tables_per_second(ScheduleFill<Freq, Timing>());
+    const double cell_rate = tables_per_second(PerCellFill<Freq, Timing>());
+
+    double worst = 0.0;
+    for (int i = 0; i < kGrid.cells(); i++) {
+        worst = std::fmax(worst, std::fabs(schedule[i] / reference[i] - 1.0));
+    }
+    printf("%-18s %12.0f %12.0f %8.1fx %10.2e\n", name, schedule_rate * kGrid.cells(),
+           cell_rate * kGrid.cells(), schedule_rate / cell_rate, worst);
+    if (worst > TOLERANCE) {
+        printf("FAIL: %s schedule differs from the per-cell premium (%.2e)\n", name, worst);
+        return false;
+    }
+    return true;
+}
+
+// La tabla que dibuja la app: float por 1000, anual y prepagable
+static bool check_app_table() {
+    premium_table_fill(RATE_BP, app_table);
+    per_cell<Annual, Due>(RATE, reference);
+    double worst = 0.0;
+    for (int i = 0; i < PREMIUM_TABLE_CELLS; i++) {
+        worst = std::fmax(worst, std::fabs(app_table[i] / (reference[i] * 1000.0) - 1.0));
+    }
+    const int cell = (35 - PREMIUM_TABLE_MIN_AGE) * PREMIUM_TABLE_TERMS + (20 - PREMIUM_TABLE_MIN_TERM);
+    printf("app table at %.2f%%: age 35, 20-year term %.4f per 1000 (max_rel %.2e)\n", RATE * 100,
+           app_table[cell], worst);
+    if (worst > APP_TOLERANCE) {
+        printf("FAIL: premium_table_fill differs from the per-cell premium (%.2e)\n", worst);
+        return false;
+    }
+    return true;
+}
+
+static void write_csv(int rate_bp) {
+    premium_table_fill((uint16_t)rate_bp, app_table);
+    printf("age");
+    for (int t = PREMIUM_TABLE_MIN_TERM; t <= PREMIUM_TABLE_MAX_TERM; t++) printf(",%d", t);
+    printf("\n");
+    for (int a = 0; a < PREMIUM_TABLE_AGES; a++) {
+        printf("%d", PREMIUM_TABLE_MIN_AGE + a);
+        for (int t = 0; t < PREMIUM_TABLE_TERMS; t++) printf(",%.4f", app_table[a * PREMIUM_TABLE_TERMS + t]);
+        printf("\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && argv[1][0] == '-' && argv[1][1] == 'c') {
+        write_csv(argc > 2 ? atoi(argv[2]) : RATE_BP);
+        return 0;
+    }
+
+    bool pass = true;
+    printf("ages %d-%d x terms %d-%d (%d cells), SUSM at %.0f%%\n", kGrid.min_age, kGrid.max_age,
+           kGrid.min_term, kGrid.max_term, kGrid.cells(), RATE * 100);
+    printf("%-18s %12s %12s %9s %10s\n", "basis", "sched_c/s", "cell_c/s", "speedup", "max_rel");
+    pass = bench<Annual, Due>("annual due") && pass;
+    pass = bench<Annual, Immediate>("annual immediate") && pass;
+    pass = bench<Quarterly, Due>("quarterly due") && pass;
+    pass = bench<Monthly, Due>("monthly due") && pass;
+    pass = check_app_table() && pass;
+    return pass ? 0 : 1;
+}
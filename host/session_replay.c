@@ -0,0 +1,387 @@
+// Reproducción de una sesión del UART grabada (uart_session.c) contra el
+// cliente en el host: driver (uart_hardware.c sobre el UART emulado),
+// análisis de la respuesta (text_layout.c, solution_fields.c) y dibujo de
+// la pantalla de resultado (compositor.c sobre el shim de extapp_api).
+//
+// Cada byte recibido se entrega al UART emulado en el mismo instante del
+// reloj virtual en que el driver lo entregó al grabar, y cada línea enviada
+// sale cuando el reloj llega a su primer byte. Así la misma sesión da el
+// mismo tráfico en cada ejecución y un cambio en el driver, el análisis o el
+// dibujo se mide contra exactamente las mismas entradas. Sólo el protocolo
+// de líneas: con ACTUARIAL_RELIABLE_LINK las tramas no se separan por '\n'.
+//
+// La sesión se reproduce REPLAY_RUNS veces; de cada etapa se muestra el
+// mejor tiempo de CPU del host por línea. Sale con código 1 si el driver
+// envía algo distinto de lo grabado, si lo recibido no coincide byte a byte
+// con la grabación, o si dos ejecuciones difieren en pantallas o instantes
+// del reloj virtual. Con -v imprime además la línea de tiempo.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "extapp_api.h"
+#include "extapp_shim.h"
+#include "uart_emu.h"
+#include "uart_hardware.h"
+#include "uart_session.h"
+#include "text_cache.h"
+#include "compositor.h"
+#include "text_layout.h"
+#include "solution_fields.h"
+#include "bench_util.h"
+
+#define REPLAY_RUNS         5
+#define REPLAY_MAX_EVENTS   (UART_SESSION_CAPACITY / 2)
+#define REPLAY_MAX_LINES    512
+#define REPLAY_LINE_MAX     1024
+#define REPLAY_TIMEOUT_MS   30000
+#define REPLAY_SHOW_CHARS   56
+
+// Sesión por defecto: la que deja `make bench` en el directorio del host
+#ifndef HOST_BUILD_DIR
+#define HOST_BUILD_DIR      "target/host"
+#endif
+
+#define WHITE 0xFFFF
+#define BLACK 0x0000
+#define BLUE  0x001F
+#define GREEN 0x07E0
+
+// Evento con su instante absoluto desde el inicio de la grabación
+typedef struct {
+    uint64_t at_us;
+    uint8_t byte;
+    bool tx;
+} ReplayEvent;
+
+// Línea completa en una dirección: bytes de `events` en [first, last]
+typedef struct {
+    uint32_t first;
+    uint32_t last;
+    uint32_t length;        // Sin el '\n'
+    bool tx;
+} ReplayLine;
+
+typedef struct {
+    uint32_t lines;
+    uint64_t ns;
+} StageCost;
+
+typedef struct {
+    StageCost receive;      // uart_hardware_receive_string con sus vueltas de espera
+    StageCost parse;        // text_strip_solution + solution_parse
+    StageCost render;       // Pantalla de resultado, compositor_end incluido
+    uint64_t draw_ns;       // Coste de dibujo modelado por el shim
+    uint64_t end_us;        // Reloj virtual al acabar
+    uint32_t hash;          // Líneas recibidas, pantallas e instantes
+    uint32_t tx_mismatches;
+    uint32_t rx_mismatches;
+    uint32_t fields;
+    uint32_t solution_bytes;    // Bytes de las respuestas analizadas
+} ReplayRun;
+
+static ReplayEvent events[REPLAY_MAX_EVENTS];
+static uint32_t event_count;
+static ReplayLine lines[REPLAY_MAX_LINES];
+static uint32_t line_count;
+static uint32_t tick_us;
+static bool verbose;
+
+static ReplayRun* run;
+static uint32_t feed_next;      // Siguiente evento a entregar al UART emulado
+static char rx_line[REPLAY_LINE_MAX + 1];
+
+static uint64_t virtual_us(void) {
+    return extapp_shim_now_ns() / 1000;
+}
+
+static void mix(uint32_t* hash, const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) *hash = (*hash ^ bytes[i]) * 16777619u;
+}
+
+static bool load_session(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        printf("FAIL: cannot open %s (run `make bench` first)\n", path);
+        return false;
+    }
+    static uint8_t file[sizeof(UartSessionHeader) + UART_SESSION_CAPACITY];
+    size_t len = fread(file, 1, sizeof(file), f);
+    fclose(f);
+
+    UartSessionReader reader;
+    UartSessionHeader header;
+    if (!uart_session_open(&reader, file, len, &header)) {
+        printf("FAIL: %s is not a UART session (version %d)\n", path, UART_SESSION_VERSION);
+        return false;
+    }
+    tick_us = header.tick_us;
+
+    UartSessionEvent e;
+    uint64_t at_us = 0;
+    while (event_count < REPLAY_MAX_EVENTS && uart_session_next(&reader, &e)) {
+        at_us += (uint64_t)e.ticks * tick_us;
+        events[event_count].at_us = at_us;
+        events[event_count].byte = e.byte;
+        events[event_count].tx = e.tx;
+        event_count++;
+    }
+    if (event_count != header.events) {
+        printf("FAIL: %s has %lu events, header says %lu\n", path, (unsigned long)event_count,
+               (unsigned long)header.events);
+        return false;
+    }
+    printf("session %s: %lu events in %lu bytes, %.1f ms%s\n", path, (unsigned long)event_count,
+           (unsigned long)len, event_count ? events[event_count - 1].at_us / 1000.0 : 0.0,
+           header.flags & UART_SESSION_TRUNCATED ? " (truncated)" : "");
+    return true;
+}
+
+// Agrupa los eventos en líneas por dirección, ordenadas por su primer byte.
+// Una línea recibida puede quedar partida por un envío: sigue siendo una.
+static bool split_lines(void) {
+    int32_t open[2] = { -1, -1 };      // Línea en curso: recibida, enviada
+    for (uint32_t i = 0; i < event_count; i++) {
+        int dir = events[i].tx;
+        if (open[dir] < 0) {
+            if (line_count == REPLAY_MAX_LINES) return false;
+            open[dir] = (int32_t)line_count;
+            lines[line_count].first = i;
+            lines[line_count].length = 0;
+            lines[line_count].tx = dir;
+            line_count++;
+        }
+        ReplayLine* line = &lines[open[dir]];
+        line->last = i;
+        if (events[i].byte == '\n') {
+            open[dir] = -1;
+        } else {
+            line->length++;
+        }
+    }
+    return true;
+}
+
+// Entrega al UART emulado los bytes recibidos cuyo instante ya pasó
+static void feed_due(void) {
+    uint64_t now = virtual_us();
+    while (feed_next < event_count && events[feed_next].at_us <= now) {
+        if (!events[feed_next].tx) uart_emu_push_rx(&events[feed_next].byte, 1);
+        feed_next++;
+    }
+}
+
+// Espera del driver: el reloj salta al siguiente byte recibido (o 1 ms)
+static void replay_idle(void) {
+    uint64_t now = virtual_us();
+    uint64_t target = now + 1000;
+    for (uint32_t i = feed_next; i < event_count; i++) {
+        if (events[i].tx) continue;
+        if (events[i].at_us < target) target = events[i].at_us > now ? events[i].at_us : now + 1;
+        break;
+    }
+    extapp_shim_advance_ns((target - now) * 1000);
+    feed_due();
+}
+
+static void advance_to(uint64_t at_us) {
+    uint64_t now = virtual_us();
+    if (at_us > now) extapp_shim_advance_ns((at_us - now) * 1000);
+    feed_due();
+}
+
+static void show(const ReplayLine* line, const char* text, size_t len) {
+    if (!verbose) return;
+    printf("%10.3f ms  %s %4lu  %.*s%s\n", events[line->first].at_us / 1000.0, line->tx ? "tx" : "rx",
+           (unsigned long)line->length, (int)(len < REPLAY_SHOW_CHARS ? len : REPLAY_SHOW_CHARS), text,
+           len > REPLAY_SHOW_CHARS ? "..." : "");
+}
+
+static void send_line(const ReplayLine* line) {
+    char text[REPLAY_LINE_MAX + 2];
+    size_t len = 0;
+    for (uint32_t i = line->first; i <= line->last && len < sizeof(text) - 1; i++) {
+        if (events[i].tx) text[len++] = (char)events[i].byte;
+    }
+    text[len] = '\0';
+    advance_to(events[line->first].at_us);
+    show(line, text, line->length);
+
+    // El driver debe escribir en TDR exactamente lo grabado
+    uint8_t sent[REPLAY_LINE_MAX + 2];
+    bool ok = uart_hardware_send_string(text);
+    size_t got = uart_emu_take_tx(sent, sizeof(sent));
+    if (!ok || got != len || memcmp(sent, text, len) != 0) run->tx_mismatches++;
+}
+
+// Pantalla de resultado de la app: campos, o el texto en líneas si no hay
+static void render(StrView response, const SolutionFields* fields) {
+    compositor_begin(WHITE);
+    compositor_static_small("AI Response:", 10, 60, GREEN, WHITE);
+    if (fields->count) {
+        for (int i = 0; i < fields->count; i++) {
+            char value[SOLUTION_FORMAT_MAX];
+            size_t len = solution_format(&fields->fields[i], response, value, sizeof(value));
+            StrView label = solution_span(response, fields->fields[i].label);
+            int y = 80 + i * 14;
+            compositor_view_small(sv_take(label, 41 - len), 10, y, BLACK, WHITE);
+            compositor_text_small(value, 310 - (int)len * 7, y, BLACK, WHITE);
+        }
+    } else {
+        StrView rest = response;
+        for (int y = 80; !sv_empty(rest) && y < 190; y += 14) {
+            compositor_view_small(text_wrap_next(&rest, 38), 10, y, BLACK, WHITE);
+        }
+    }
+    compositor_static_small("Press any key to continue", 10, 220, BLUE, WHITE);
+    compositor_end();
+}
+
+static void receive_line(const ReplayLine* line) {
+    double start = now_ns();
+    bool received = uart_hardware_receive_string(rx_line, sizeof(rx_line), REPLAY_TIMEOUT_MS);
+    double received_ns = now_ns();
+    size_t len = strlen(rx_line);
+    show(line, rx_line, len);
+
+    // Lo recibido debe ser la línea grabada, byte a byte
+    size_t k = 0;
+    bool match = received && len == line->length;
+    for (uint32_t i = line->first; match && i <= line->last; i++) {
+        if (events[i].tx || events[i].byte == '\n') continue;
+        match = rx_line[k++] == (char)events[i].byte;
+    }
+    if (!match) run->rx_mismatches++;
+    run->receive.lines++;
+    run->receive.ns += (uint64_t)(received_ns - start);
+
+    uint64_t at = virtual_us();
+    mix(&run->hash, rx_line, len);
+    mix(&run->hash, &at, sizeof(at));
+
+    // Lo que la app hace con una respuesta: quitar el prefijo, los campos
+    // y la pantalla de resultado. PONG y demás no se dibujan.
+    StrView response = sv_make(rx_line, len);
+    if (!text_strip_solution(&response)) return;
+    SolutionFields fields;
+    double parse_start = now_ns();
+    solution_parse(response, &fields);
+    double parsed_ns = now_ns();
+    render(response, &fields);
+    double rendered_ns = now_ns();
+
+    run->parse.lines++;
+    run->parse.ns += (uint64_t)(parsed_ns - parse_start);
+    run->render.lines++;
+    run->render.ns += (uint64_t)(rendered_ns - parsed_ns);
+    run->fields += fields.count;
+    run->solution_bytes += (uint32_t)len;
+
+    // Cierra el frame del shim: coste modelado y suma de la pantalla
+    extapp_scanKeyboard();
+    const uint16_t* fb = extapp_shim_framebuffer();
+    mix(&run->hash, fb, LCD_WIDTH * LCD_HEIGHT * sizeof(uint16_t));
+}
+
+static void replay_client(void) {
+    for (uint32_t i = 0; i < line_count; i++) {
+        if (lines[i].tx) send_line(&lines[i]);
+        else receive_line(&lines[i]);
+    }
+    run->end_us = virtual_us();
+}
+
+static const ShimKeyStep script[] = {
+    { "replay", 0, REPLAY_MAX_LINES + 1 },
+};
+
+static void replay_once(ReplayRun* out) {
+    memset(out, 0, sizeof(*out));
+    out->hash = 2166136261u;
+    run = out;
+    feed_next = 0;
+
+    // Mismo punto de partida en cada ejecución: LCD, cachés y periférico
+    extapp_shim_reset();
+    extapp_shim_set_script(script, sizeof(script) / sizeof(script[0]));
+    text_cache_set_budget(TEXT_CACHE_BUDGET);
+    compositor_invalidate();
+    uart_emu_reset();
+    uart_hardware_init();
+    uart_hardware_set_wait(extapp_millis, replay_idle);
+
+    extapp_shim_run(replay_client);
+    ShimPhaseStats total;
+    extapp_shim_total(&total);
+    out->draw_ns = total.work_ns;
+}
+
+static void print_stage(const char* name, const StageCost* best, uint32_t bytes) {
+    double per_line = best->lines ? (double)best->ns / best->lines : 0.0;
+    printf("%-10s %6lu %8lu %12.0f %12.1f\n", name, (unsigned long)best->lines, (unsigned long)bytes, per_line,
+           bytes ? (double)best->ns / bytes : 0.0);
+}
+
+static void keep_best(StageCost* best, const StageCost* cost) {
+    if (!best->lines || cost->ns < best->ns) *best = *cost;
+}
+
+int main(int argc, char** argv) {
+    const char* path = HOST_BUILD_DIR "/compositor.uart";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) verbose = true;
+        else path = argv[i];
+    }
+    if (!load_session(path)) return 1;
+    if (!split_lines()) {
+        printf("FAIL: more than %d lines in the session\n", REPLAY_MAX_LINES);
+        return 1;
+    }
+
+    uint32_t rx_bytes = 0, tx_lines = 0;
+    for (uint32_t i = 0; i < line_count; i++) {
+        if (lines[i].tx) tx_lines++;
+        else rx_bytes += lines[i].length;
+    }
+
+    bool pass = true;
+    static ReplayRun runs[REPLAY_RUNS];
+    StageCost receive = { 0, 0 }, parse = { 0, 0 }, render_cost = { 0, 0 };
+    for (int r = 0; r < REPLAY_RUNS; r++) {
+        replay_once(&runs[r]);
+        verbose = false;        // La línea de tiempo sólo una vez
+        keep_best(&receive, &runs[r].receive);
+        keep_best(&parse, &runs[r].parse);
+        keep_best(&render_cost, &runs[r].render);
+    }
+
+    const ReplayRun* first = &runs[0];
+    printf("%lu lines sent, %lu received (%lu fields), replayed in %.1f ms of virtual time\n",
+           (unsigned long)tx_lines, (unsigned long)first->receive.lines, (unsigned long)first->fields,
+           first->end_us / 1000.0);
+    printf("%-10s %6s %8s %12s %12s   (best of %d, host ns)\n", "stage", "lines", "bytes", "ns/line",
+           "ns/byte", REPLAY_RUNS);
+    print_stage("receive", &receive, rx_bytes);
+    print_stage("parse", &parse, first->solution_bytes);
+    print_stage("render", &render_cost, first->solution_bytes);
+    printf("modeled draw: %.1f us per response (%.2f ms total)\n",
+           first->render.lines ? first->draw_ns / 1000.0 / first->render.lines : 0.0, first->draw_ns / 1e6);
+
+    if (first->tx_mismatches) {
+        printf("FAIL: %lu lines were sent differently from the recording\n", (unsigned long)first->tx_mismatches);
+        pass = false;
+    }
+    if (first->rx_mismatches) {
+        printf("FAIL: %lu received lines differ from the recording\n", (unsigned long)first->rx_mismatches);
+        pass = false;
+    }
+    for (int r = 1; r < REPLAY_RUNS; r++) {
+        if (runs[r].hash != first->hash || runs[r].end_us != first->end_us ||
+            runs[r].draw_ns != first->draw_ns) {
+            printf("FAIL: replay %d is not identical to the first one\n", r + 1);
+            pass = false;
+        }
+    }
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+// Benchmark del buscador de raíces (engine/solver.h): evaluaciones, pasos
+// de cada tipo y tiempo por resolución.
+//
+// Cada caso se resuelve con Newton y la salvaguarda de Brent, sólo con
+// Brent (la misma función sin derivada) y por bisección. Los casos de
+// valoración (rendimiento de una renta, tipo de equilibrio, prima de
+// tarifa) se construyen a partir de un tipo o una prima conocidos, que el
+// solver debe recuperar; los demás son funciones en las que Newton solo
+// diverge o cicla. Sale con código 1 si algún método no converge dentro
+// del límite de evaluaciones, si los métodos no coinciden, si la raíz no
+// cumple la ecuación con las plantillas de valuation.h o si la derivada
+// analítica no coincide con la numérica.
+
+#include <cmath>
+#include <cstdio>
+#include "engine/solver.h"
+
+using namespace actuarial;
+
+#define TOLERANCE       1e-9        // Entre métodos y frente al valor conocido
+#define SLOPE_TOLERANCE 1e-6        // Derivada analítica frente a diferencias centradas
+
+#include "bench_util.h"
+
+typedef Monthly Freq;
+typedef Due Timing;
+
+static double surv_annuity[kMaxAge * Freq::kSteps + 1];
+static double surv_term[kMaxAge * Freq::kSteps + 1];
+static double disc[kMaxAge * Freq::kSteps + 1];
+
+// La misma función sin derivada: solve() no puede dar pasos de Newton
+template <class Fn>
+struct NoSlope {
+    const Fn& fn;
+    explicit NoSlope(const Fn& f) : fn(f) {}
+    double operator()(double x, double* slope) const {
+        const double y = fn(x, slope);
+        *slope = 0.0;
+        return y;
+    }
+};
+
+// Referencia: bisección hasta la misma anchura
+template <class Fn>
+static SolveResult bisect(const Fn& fn, double lo, double hi) {
+    SolveResult r = { lo, 0.0, 2, 0, 0, 0, kSolveConverged };
+    double slope;
+    double flo = fn(lo, &slope);
+    fn(hi, &slope);
+    while (hi - lo > kSolveDefaults.x_tol + 2.0 * DBL_EPSILON * std::fabs(lo)) {
+        const double mid = 0.5 * (lo + hi);
+        const double fmid = fn(mid, &slope);
+        r.evals++;
+        r.bisection_steps++;
+        if ((fmid > 0.0) == (flo > 0.0)) {
+            lo = mid;
+            flo = fmid;
+        } else {
+            hi = mid;
+        }
+    }
+    r.x = 0.5 * (lo + hi);
+    r.f = fn(r.x, &slope);
+    return r;
+}
+
+template <class Fn>
+struct TimedSolve {
+    const Fn& fn;
+    double lo, hi;
+    bool bisection;
+    SolveResult operator()() const { return bisection ? bisect(fn, lo, hi) : solve(fn, lo, hi); }
+};
+
+// ns por resolución, repitiendo hasta MIN_SECONDS
+template <class Run>
+static double ns_per_solve(const Run& run, SolveResult* result) {
+    long calls = 0;
+    const double start = now_ns();
+    double elapsed;
+    do {
+        *result = run();
+        sink = result->x;
+        calls++;
+        elapsed = now_ns() - start;
+    } while (elapsed < MIN_SECONDS * 1e9);
+    return elapsed / calls;
+}
+
+static void print_result(const char* name, const char* method, const SolveResult& r, double ns) {
+    printf("%-16s %-13s %6d %6d %6d %6d %10.0f %20.12f\n", name, method, r.evals, r.newton_steps,
+           r.interpolation_steps, r.bisection_steps, ns, r.x);
+}
+
+// Resuelve con los tres métodos; `expected` es NAN si no se conoce la raíz
+template <class Fn>
+static bool run_case(const char* name, const Fn& fn, double lo, double hi, double expected, double* root) {
+    const NoSlope<Fn> plain(fn);
+    SolveResult newton, brent, bisection;
+    const TimedSolve<Fn> run_newton = { fn, lo, hi, false };
+    const TimedSolve<NoSlope<Fn> > run_brent = { plain, lo, hi, false };
+    const TimedSolve<Fn> run_bisection = { fn, lo, hi, true };
+    print_result(name, "newton+brent", newton, ns_per_solve(run_newton, &newton));
+    print_result("", "brent", brent, ns_per_solve(run_brent, &brent));
+    print_result("", "bisection", bisection, ns_per_solve(run_bisection, &bisection));
+    *root = newton.x;
+
+    bool ok = true;
+    if (newton.status != kSolveConverged || brent.status != kSolveConverged) {
+        printf("FAIL: %s did not converge within %d evaluations\n", name, kSolveDefaults.max_evals);
+        ok = false;
+    }
+    if (!same(newton.x, bisection.x) || !same(brent.x, bisection.x)) {
+        printf("FAIL: %s methods disagree (%.15g, %.15g, %.15g)\n", name, newton.x, brent.x, bisection.x);
+        ok = false;
+    }
+    if (expected == expected && !same(newton.x, expected)) {
+        printf("FAIL: %s root %.15g, expected %.15g\n", name, newton.x, expected);
+        ok = false;
+    }
+    return ok;
+}
+
+// Derivada analítica frente a diferencias centradas en x
+template <class Fn>
+static bool check_slope(const char* name, const Fn& fn, double x, double h) {
+    double slope, ignored;
+    fn(x, &slope);
+    const double numeric = (fn(x + h, &ignored) - fn(x - h, &ignored)) / (2.0 * h);
+    if (std::fabs(slope - numeric) > SLOPE_TOLERANCE * std::fabs(numeric)) {
+        printf("FAIL: %s analytic slope %.10g, numeric %.10g\n", name, slope, numeric);
+        return false;
+    }
+    return true;
+}
+
+// Funciones en las que Newton sin salvaguarda no converge
+struct Arctan {
+    double operator()(double x, double* slope) const {
+        *slope = 1.0 / (1.0 + (x - 1.5) * (x - 1.5));
+        return std::atan(x - 1.5);
+    }
+};
+
+// Newton desde 0 cicla entre 0 y 1
+struct NewtonCycle {
+    double operator()(double x, double* slope) const {
+        *slope = 3.0 * x * x - 2.0;
+        return x * x * x - 2.0 * x + 2.0;
+    }
+};
+
+struct NoRoot {
+    double operator()(double x, double* slope) const {
+        *slope = 2.0 * x;
+        return x * x + 1.0;
+    }
+};
+
+int main() {
+    bool pass = true;
+    double root;
+
+    printf("%-16s %-13s %6s %6s %6s %6s %10s %20s\n", "case", "method", "evals", "newton", "interp", "bisect",
+           "ns", "root");
+
+    // Renta vitalicia (hasta kMaxAge) a los 65 de 12000 al año, precio al 4%
+    const int annuity_age = 65, annuity_years = kMaxAge - annuity_age;
+    fill_survival<Freq>(kStandardUltimate, annuity_age, annuity_years, surv_annuity);
+    const AnnuityYield<Freq, Timing> yield = { surv_annuity, annuity_years, 12000.0, 0.0, disc };
+    AnnuityYield<Freq, Timing> priced = yield;
+    priced.price = yield(0.04, &root);
+    printf("annuity at 65, 12000/year, price %.2f\n", priced.price);
+    pass = run_case("annuity yield", priced, -0.05, 0.5, 0.04, &root) && pass;
+    pass = check_slope("annuity yield", priced, 0.03, 1e-6) && pass;
+    {
+        // Con la raíz, la renta de valuation.h cuesta el precio
+        fill_discount<Freq>(root, annuity_years, disc);
+        const Basis b = { surv_annuity, disc, annuity_years, (double)annuity_age, std::log(1.0 + root),
+                          &kStandardUltimate, 0 };
+        if (!same(12000.0 * annuity<Freq, Timing>(b) / priced.price, 1.0)) {
+            printf("FAIL: annuity yield does not reproduce the price\n");
+            pass = false;
+        }
+    }
+
+    // Temporal a 20 años a los 35: prima neta al 3.5% de 100000
+    const int term_age = 35, term_years = 20;
+    fill_survival<Freq>(kStandardUltimate, term_age, term_years, surv_term);
+    fill_discount<Freq>(0.035, term_years, disc);
+    const Basis at_35 = { surv_term, disc, term_years, (double)term_age, std::log(1.035), &kStandardUltimate, 0 };
+    const double premium = 100000.0 * term_premium<Freq, Timing>(at_35);
+    const BreakEvenRate<Freq, Timing> break_even = { surv_term, term_years, premium, 100000.0, disc };
+    printf("20-year term at 35, 100000, premium %.4f/year\n", premium);
+    pass = run_case("break-even rate", break_even, 0.0, 0.25, 0.035, &root) && pass;
+    pass = check_slope("break-even rate", break_even, 0.05, 1e-6) && pass;
+    {
+        fill_discount<Freq>(root, term_years, disc);
+        const Basis b = { surv_term, disc, term_years, (double)term_age, std::log(1.0 + root), &kStandardUltimate, 0 };
+        if (!same(100000.0 * term_premium<Freq, Timing>(b) / premium, 1.0)) {
+            printf("FAIL: break-even rate does not reproduce the premium\n");
+            pass = false;
+        }
+    }
+
+    // Prima de tarifa del mismo seguro al 5% con gastos
+    fill_discount<Freq>(0.05, term_years, disc);
+    const Basis at_5 = { surv_term, disc, term_years, (double)term_age, std::log(1.05), &kStandardUltimate, 0 };
+    const Expenses expenses = { 0.5, 0.05, 150.0, 25.0, 200.0 };
+    const GrossPremium<Freq, Timing> gross(at_5, 100000.0, expenses);
+    // Lineal: la raíz es -f(0) / f'
+    double slope;
+    const double expected_gross = -gross(0.0, &slope) / slope;
+    printf("same term at 5%%, expenses 50%% + 5%% of premium, 150 + 25/year, 200 per claim\n");
+    pass = run_case("gross premium", gross, 0.0, 10000.0, expected_gross, &root) && pass;
+
+    pass = run_case("atan(x - 1.5)", Arctan(), -10.0, 30.0, 1.5, &root) && pass;
+    pass = run_case("x^3 - 2x + 2", NewtonCycle(), -3.0, 0.0, NAN, &root) && pass;
+    if (std::fabs(NewtonCycle()(root, &slope)) > 1e-10) {
+        printf("FAIL: x^3 - 2x + 2 root %.15g is not a root\n", root);
+        pass = false;
+    }
+
+    const SolveResult none = solve(NoRoot(), -1.0, 1.0);
+    printf("x^2 + 1 on [-1, 1]: %s after %d evaluations\n", none.status == kSolveNoBracket ? "no bracket" : "?",
+           none.evals);
+    if (none.status != kSolveNoBracket) {
+        printf("FAIL: x^2 + 1 should report no bracket\n");
+        pass = false;
+    }
+
+    // Límite de evaluaciones
+    SolveLimits tight = kSolveDefaults;
+    tight.max_evals = 5;
+    const SolveResult capped = solve(NoSlope<Arctan>(Arctan()), -10.0, 30.0, tight);
+    if (capped.status != kSolveMaxEvals || capped.evals != tight.max_evals) {
+        printf("FAIL: evaluation limit not honoured (%d evaluations)\n", capped.evals);
+        pass = false;
+    }
+    return pass ? 0 : 1;
+}
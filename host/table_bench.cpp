@@ -0,0 +1,325 @@
+// Benchmark de las tablas de decrementos (engine/decrement_table.h):
+// ocupación del formato compacto frente a tablas 2-D en double sin
+// compartir columnas, y latencia de cada consulta frente a la tabla 2-D y
+// a calcular la ley de Makeham en cada consulta.
+//
+// El bloque se construye en memoria y se escribe en un fichero que se
+// vuelve a leer con mmap. Sale con código 1 si alguna consulta no devuelve
+// el valor de origen, si la vista mapeada no coincide con la de memoria o
+// si attach() acepta un bloque corrupto.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "engine/decrement_table.h"
+#include "engine/valuation.h"
+#include "bench_util.h"
+
+using namespace actuarial;
+
+#define MIN_AGE     20
+#define AGES        (kMaxAge - MIN_AGE + 1)
+#define LOOKUPS     1000000
+#define RATE        0.05
+
+// El blob se escribe y se mapea en el directorio del host que pasa el Makefile
+#ifndef HOST_BUILD_DIR
+#define HOST_BUILD_DIR "target/host"
+#endif
+#define BLOB_PATH   HOST_BUILD_DIR "/decrement_tables.bin"
+
+// Columnas de origen, desde MIN_AGE hasta kMaxAge
+static double ultimate[AGES];
+static double select_death[2][AGES];
+static double lapse[4][AGES];
+static double disability[AGES];
+
+// Cada tabla como se guardaría sin el formato: double[edad][duración]
+struct NaiveDecrement {
+    int select_years;
+    double q[AGES][kMaxSelectYears + 1];
+};
+
+struct Source {
+    const char* name;
+    int decrement_count;
+    DecrementKind kinds[3];
+    int select_years[3];
+    const double* columns[3][5];
+};
+
+static Source sources[4];
+static const int kSources = 4;
+static NaiveDecrement naive[4][3];
+
+static TableSetBuilder builder(MIN_AGE, kMaxAge);
+static uint8_t blob[16384] __attribute__((aligned(4)));
+static uint8_t corrupt[16384] __attribute__((aligned(4)));
+static TableSet tables;
+static TableSet mapped;
+static double surv[kMaxAge + 1];
+static double disc[kMaxAge + 1];
+
+// Mortalidad del Standard Ultimate Survival Model y, en los dos años
+// select, la del Standard Select (0.9^(2-s) sobre la última); caída por
+// duración y una invalidez creciente con la edad
+static void make_sources() {
+    for (int a = 0; a < AGES; a++) {
+        const int x = MIN_AGE + a;
+        ultimate[a] = x == kMaxAge ? 1.0 : 1.0 - kStandardUltimate.survival(x, 1.0);
+        select_death[0][a] = 0.81 * ultimate[a];
+        select_death[1][a] = 0.9 * ultimate[a];
+        lapse[0][a] = 0.12;
+        lapse[1][a] = 0.08;
+        lapse[2][a] = 0.06;
+        lapse[3][a] = 0.04;
+        disability[a] = std::fmin(0.05, 0.0004 * std::pow(1.07, x - MIN_AGE));
+    }
+
+    Source& select = sources[0];
+    select.name = "select mortality";
+    select.decrement_count = 1;
+    select.kinds[0] = DECREMENT_DEATH;
+    select.select_years[0] = 2;
+    select.columns[0][0] = select_death[0];
+    select.columns[0][1] = select_death[1];
+    select.columns[0][2] = ultimate;
+
+    Source& ult = sources[1];
+    ult.name = "ultimate mortality";
+    ult.decrement_count = 1;
+    ult.kinds[0] = DECREMENT_DEATH;
+    ult.select_years[0] = 0;
+    ult.columns[0][0] = ultimate;
+
+    // Fallecimiento + caída + invalidez, y la misma sin invalidez
+    Source& mdt = sources[2];
+    mdt.name = "death/lapse/disab.";
+    mdt.decrement_count = 3;
+    mdt.kinds[0] = DECREMENT_DEATH;
+    mdt.select_years[0] = 2;
+    mdt.columns[0][0] = select_death[0];
+    mdt.columns[0][1] = select_death[1];
+    mdt.columns[0][2] = ultimate;
+    mdt.kinds[1] = DECREMENT_LAPSE;
+    mdt.select_years[1] = 3;
+    for (int s = 0; s < 4; s++) mdt.columns[1][s] = lapse[s];
+    mdt.kinds[2] = DECREMENT_DISABILITY;
+    mdt.select_years[2] = 0;
+    mdt.columns[2][0] = disability;
+
+    Source& mdt2 = sources[3];
+    mdt2.name = "death/lapse";
+    mdt2.decrement_count = 2;
+    mdt2.kinds[0] = DECREMENT_DEATH;
+    mdt2.select_years[0] = 0;
+    mdt2.columns[0][0] = ultimate;
+    mdt2.kinds[1] = DECREMENT_LAPSE;
+    mdt2.select_years[1] = 3;
+    for (int s = 0; s < 4; s++) mdt2.columns[1][s] = lapse[s];
+
+    for (int t = 0; t < kSources; t++) {
+        for (int d = 0; d < sources[t].decrement_count; d++) {
+            NaiveDecrement& n = naive[t][d];
+            n.select_years = sources[t].select_years[d];
+            for (int a = 0; a < AGES; a++) {
+                for (int s = 0; s <= n.select_years; s++) n.q[a][s] = sources[t].columns[d][s][a];
+            }
+        }
+    }
+}
+
+static double naive_q(int table, int decrement, int issue_age, int duration) {
+    const NaiveDecrement& n = naive[table][decrement];
+    const int select = duration < n.select_years;
+    int age = select ? issue_age : issue_age + duration;
+    if (age > kMaxAge) age = kMaxAge;
+    return n.q[age - MIN_AGE][select ? duration : n.select_years];
+}
+
+// Todas las consultas posibles contra el valor de origen en float
+static bool check_values(const TableSet& set, const char* what) {
+    for (int t = 0; t < kSources; t++) {
+        for (int d = 0; d < sources[t].decrement_count; d++) {
+            for (int x = MIN_AGE; x <= kMaxAge; x++) {
+                for (int k = 0; x + k <= kMaxAge + 1; k++) {
+                    if (set.q(t, d, x, k) != (float)naive_q(t, d, x, k)) {
+                        printf("FAIL: %s table %d decrement %d q[%d]+%d = %g, expected %g\n",
+                               what, t, d, x, k, set.q(t, d, x, k), naive_q(t, d, x, k));
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// El bloque escrito en disco y mapeado de nuevo, sin copiarlo
+static bool check_mapped(size_t size) {
+    FILE* f = fopen(BLOB_PATH, "wb");
+    if (!f || fwrite(blob, 1, size, f) != size) {
+        printf("FAIL: cannot write %s\n", BLOB_PATH);
+        if (f) fclose(f);
+        return false;
+    }
+    fclose(f);
+
+    int fd = open(BLOB_PATH, O_RDONLY);
+    void* map = fd >= 0 ? mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    if (fd >= 0) close(fd);
+    if (map == MAP_FAILED) {
+        printf("FAIL: cannot map %s\n", BLOB_PATH);
+        return false;
+    }
+    bool ok = mapped.attach(map, size) && check_values(mapped, "mapped");
+    if (!ok) printf("FAIL: the memory-mapped table set does not match\n");
+    munmap(map, size);
+    return ok;
+}
+
+// attach() rechaza cabeceras y secciones corruptas
+static bool check_corrupt(size_t size) {
+    TableSet probe;
+    bool ok = true;
+
+    memcpy(corrupt, blob, size);
+    corrupt[0] = 'X';
+    ok = !probe.attach(corrupt, size) && ok;
+
+    ok = !probe.attach(blob, size - 4) && ok;
+    ok = !probe.attach(blob + 1, size - 1) && ok;
+
+    // Último índice de columna fuera de rango
+    memcpy(corrupt, blob, size);
+    TableFileHeader h;
+    memcpy(&h, corrupt, sizeof(h));
+    const size_t slots = sizeof(TableFileHeader) + h.table_count * sizeof(TableEntry) +
+                         h.decrement_count * sizeof(DecrementEntry);
+    uint16_t bad = h.column_count;
+    memcpy(corrupt + slots + (h.slot_count - 1) * sizeof(uint16_t), &bad, sizeof(bad));
+    ok = !probe.attach(corrupt, size) && ok;
+
+    if (!ok) printf("FAIL: attach accepted a corrupt table set\n");
+    return ok;
+}
+
+struct Query {
+    uint8_t table;
+    uint8_t decrement;
+    uint8_t issue_age;
+    uint8_t duration;
+};
+
+static Query queries[LOOKUPS];
+
+static void bench_lookups() {
+    srand(12345);
+    for (int i = 0; i < LOOKUPS; i++) {
+        Query& q = queries[i];
+        q.table = rand() % kSources;
+        q.decrement = rand() % sources[q.table].decrement_count;
+        q.issue_age = MIN_AGE + rand() % (65 - MIN_AGE + 1);
+        q.duration = rand() % 40;
+    }
+
+    double start = now_ns();
+    double acc = 0.0;
+    for (int i = 0; i < LOOKUPS; i++) {
+        const Query& q = queries[i];
+        acc += tables.q(q.table, q.decrement, q.issue_age, q.duration);
+    }
+    double compact_ns = (now_ns() - start) / LOOKUPS;
+    sink = acc;
+
+    start = now_ns();
+    acc = 0.0;
+    for (int i = 0; i < LOOKUPS; i++) {
+        const Query& q = queries[i];
+        acc += naive_q(q.table, q.decrement, q.issue_age, q.duration);
+    }
+    double naive_ns = (now_ns() - start) / LOOKUPS;
+    sink = acc;
+
+    // Sólo la mortalidad última: lo que hoy calcula el motor con la ley
+    start = now_ns();
+    acc = 0.0;
+    for (int i = 0; i < LOOKUPS; i++) {
+        const Query& q = queries[i];
+        acc += 1.0 - kStandardUltimate.survival(q.issue_age + q.duration, 1.0);
+    }
+    double law_ns = (now_ns() - start) / LOOKUPS;
+    sink = acc;
+
+    start = now_ns();
+    acc = 0.0;
+    for (int i = 0; i < LOOKUPS; i++) {
+        const Query& q = queries[i];
+        acc += tables.total(q.table, q.issue_age, q.duration);
+    }
+    double total_ns = (now_ns() - start) / LOOKUPS;
+    sink = acc;
+
+    printf("lookup ns: compact %.1f, 2-D double %.1f, Makeham law %.1f, all decrements %.1f\n",
+           compact_ns, naive_ns, law_ns, total_ns);
+}
+
+int main() {
+    bool pass = true;
+    make_sources();
+
+    for (int t = 0; t < kSources; t++) {
+        builder.begin_table();
+        for (int d = 0; d < sources[t].decrement_count; d++) {
+            builder.add_decrement(sources[t].kinds[d], sources[t].select_years[d], sources[t].columns[d]);
+        }
+    }
+    const size_t size = builder.write(blob, sizeof(blob));
+    if (size == 0 || !tables.attach(blob, size)) {
+        printf("FAIL: cannot build the table set\n");
+        return 1;
+    }
+
+    size_t naive_bytes = 0;
+    printf("%-20s %10s %7s %8s %12s\n", "table", "decrements", "select", "columns", "2-D double");
+    for (int t = 0; t < kSources; t++) {
+        int columns = 0, longest = 0;
+        for (int d = 0; d < sources[t].decrement_count; d++) {
+            columns += sources[t].select_years[d] + 1;
+            if (sources[t].select_years[d] > longest) longest = sources[t].select_years[d];
+        }
+        naive_bytes += (size_t)columns * AGES * sizeof(double);
+        printf("%-20s %10d %7d %8d %12zu\n", sources[t].name, sources[t].decrement_count, longest,
+               columns, (size_t)columns * AGES * sizeof(double));
+    }
+    printf("ages %d-%d: %d columns referenced, %d stored; flash %zu bytes (2-D double %zu, %.1fx), "
+           "RAM %zu bytes (view)\n", MIN_AGE, kMaxAge, builder.columns_referenced(), builder.columns_stored(),
+           size, naive_bytes, (double)naive_bytes / size, sizeof(TableSet));
+
+    bench_lookups();
+
+    pass = check_values(tables, "in-memory") && pass;
+    pass = check_mapped(size) && pass;
+    pass = check_corrupt(size) && pass;
+
+    // Renta anticipada a 20 años para una entrada a los 40 con cada tabla
+    fill_discount<Annual>(RATE, 20, disc);
+    double value[kSources];
+    printf("20-year annuity-due at 40, i = %.0f%%:", RATE * 100);
+    for (int t = 0; t < kSources; t++) {
+        tables.fill_in_force(t, 40, 20, surv);
+        Basis b = { surv, disc, 20, 40, std::log(1.0 + RATE), &kStandardUltimate, 0 };
+        value[t] = annuity<Annual, Due>(b);
+        printf(" %s %.4f%s", sources[t].name, value[t], t + 1 < kSources ? "," : "\n");
+    }
+    // La select es más ligera que la última; cada decremento añadido acorta
+    if (!(value[0] > value[1] && value[1] > value[3] && value[3] > value[2])) {
+        printf("FAIL: in-force annuities are not ordered by decrements\n");
+        pass = false;
+    }
+    return pass ? 0 : 1;
+}
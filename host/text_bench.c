@@ -0,0 +1,424 @@
+// Respuestas del Pi y ajuste de líneas (text_layout.c) y campos numéricos
+// de la respuesta (solution_fields.c) en el host.
+//
+// Sin argumentos: casos límite, comparación con el ajuste anterior (copias
+// con strncpy a un buffer de 40 bytes, como hacía actuarial_ai.c) sobre
+// entradas aleatorias, rendimiento de ambos sobre respuestas típicas y
+// coste de analizar y formatear sus campos.
+// Con `-f N [semilla]` sólo prueba N entradas aleatorias; `make text-fuzz`
+// lo compila así con ASan/UBSan. Con TEXT_LIBFUZZER el mismo chequeo es el
+// punto de entrada de libFuzzer (primer byte: ancho; resto: texto).
+// Sale con código 1 al primer fallo.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "text_layout.h"
+#include "solution_fields.h"
+
+#define BENCH_WIDTH       38      // Caracteres por línea del resultado
+#define LEGACY_WIDTH_MAX  39      // El buffer de 40 bytes del ajuste anterior
+#define FUZZ_TEXT_MAX     1100    // Algo más que la respuesta de 1 KB
+#define BENCH_ROUNDS      20000
+
+static bool failed;
+
+static void fail(const char* what, const char* text, size_t len, size_t width) {
+    printf("FAIL: %s (width %zu, %zu bytes): \"%.*s\"\n", what, width, len, (int)(len < 80 ? len : 80), text);
+    failed = true;
+}
+
+// Ajuste de actuarial_ai.c antes de text_layout.c: copia la respuesta y
+// cada línea. Sólo sirve de referencia para textos sin '\n'.
+static size_t legacy_wrap(const char* result, size_t width, char lines[][LEGACY_WIDTH_MAX + 1], size_t max_lines) {
+    static char temp[FUZZ_TEXT_MAX + 1];
+    strncpy(temp, result, sizeof(temp) - 1);
+    temp[sizeof(temp) - 1] = '\0';
+
+    char* line = temp;
+    size_t count = 0;
+    while (strlen(line) > 0 && count < max_lines) {
+        char* display_line = lines[count++];
+        if (strlen(line) <= width) {
+            strcpy(display_line, line);
+            line += strlen(line);
+        } else {
+            size_t cut_pos = width;
+            while (cut_pos > 0 && line[cut_pos] != ' ') {
+                cut_pos--;
+            }
+            if (cut_pos == 0) cut_pos = width;
+
+            strncpy(display_line, line, cut_pos);
+            display_line[cut_pos] = '\0';
+            line += cut_pos;
+            if (*line == ' ') line++;
+        }
+    }
+    return count;
+}
+
+// Invariantes del ajuste sobre cualquier entrada. Con `legacy`, además,
+// las mismas líneas que el ajuste anterior.
+static void check_wrap(const char* text, size_t len, size_t width, bool legacy) {
+    StrView rest = sv_make(text, len);
+    size_t consumed = 0;
+    size_t count = 0;
+    static char legacy_lines[FUZZ_TEXT_MAX + 1][LEGACY_WIDTH_MAX + 1];
+    size_t legacy_count = legacy ? legacy_wrap(text, width, legacy_lines, FUZZ_TEXT_MAX + 1) : 0;
+
+    while (!sv_empty(rest)) {
+        size_t before = rest.len;
+        StrView line = text_wrap_next(&rest, width);
+
+        if (rest.len >= before) return fail("wrap made no progress", text, len, width);
+        if (line.len > width) return fail("line wider than the screen", text, len, width);
+        if (line.ptr != text + consumed) return fail("line does not start where the last one ended", text, len, width);
+        if (memchr(line.ptr, '\n', line.len)) return fail("line contains a newline", text, len, width);
+
+        // Entre una línea y la siguiente sólo se salta un espacio o un '\n'
+        size_t skipped = before - rest.len - line.len;
+        char sep = skipped ? text[consumed + line.len] : 0;
+        if (skipped > 1 || (skipped && sep != ' ' && sep != '\n')) {
+            return fail("wrap dropped text", text, len, width);
+        }
+        if (legacy) {
+            char copy[TEXT_LINE_MAX + 1];
+            text_copy_line(line, copy, sizeof(copy));
+            if (count >= legacy_count || strcmp(copy, legacy_lines[count]) != 0) {
+                return fail("different lines than the previous wrap", text, len, width);
+            }
+        }
+        consumed = len - rest.len;
+        count++;
+    }
+    if (legacy && count != legacy_count) fail("different line count than the previous wrap", text, len, width);
+}
+
+static void check_strip(const char* text, size_t len) {
+    StrView view = sv_make(text, len);
+    bool prefixed = len >= 9 && memcmp(text, "SOLUTION:", 9) == 0;
+    if (text_strip_solution(&view) != prefixed) return fail("prefix detection", text, len, 0);
+    if (view.ptr != text + (prefixed ? 9 : 0) || view.len != len - (prefixed ? 9 : 0)) {
+        fail("prefix stripping", text, len, 0);
+    }
+}
+
+// Campos dentro de la respuesta, comparación coherente y formato recortado
+// a cualquier buffer
+static void check_fields(const char* text, size_t len) {
+    SolutionFields fields;
+    StrView response = sv_make(text, len);
+    size_t count = solution_parse(response, &fields);
+    if (count != fields.count || count > SOLUTION_MAX_FIELDS) return fail("field count", text, len, 0);
+    if (fields.dropped && count != SOLUTION_MAX_FIELDS) return fail("fields dropped with room left", text, len, 0);
+
+    for (size_t i = 0; i < count; i++) {
+        const SolutionField* f = &fields.fields[i];
+        if ((size_t)f->label.offset + f->label.len > len || (size_t)f->suffix.offset + f->suffix.len > len) {
+            return fail("field outside the response", text, len, 0);
+        }
+        if (f->decimals > SOLUTION_MAX_DIGITS + 1) return fail("field decimals", text, len, 0);
+        if (solution_compare(f, f) != 0) return fail("field differs from itself", text, len, 0);
+        if (i > 0 && solution_compare(f, f - 1) != -solution_compare(f - 1, f)) {
+            return fail("field comparison not antisymmetric", text, len, 0);
+        }
+        char full[SOLUTION_FORMAT_MAX];
+        size_t full_len = solution_format(f, response, full, sizeof(full));
+        size_t cap = 1 + full_len / 2;
+        char* out = malloc(cap);
+        if (out && solution_format(f, response, out, cap) != cap - 1) fail("field format truncation", text, len, 0);
+        free(out);
+    }
+}
+
+// Entrada del fuzzer: primer byte, ancho; el resto, la respuesta
+static void check_input(const uint8_t* data, size_t size) {
+    if (size == 0) return;
+    size_t width = 1 + data[0] % TEXT_LINE_MAX;
+    const char* text = (const char*)data + 1;
+    size_t len = size - 1;
+
+    check_strip(text, len);
+    check_wrap(text, len, width, false);
+    check_fields(text, len);
+
+    // Copias a buffers justos y más cortos que la línea: ASan detecta
+    // cualquier escritura de más
+    StrView rest = sv_make(text, len);
+    StrView line = text_wrap_next(&rest, width);
+    size_t caps[2] = { line.len + 1, line.len / 2 + 1 };
+    for (int i = 0; i < 2; i++) {
+        char* out = malloc(caps[i]);
+        if (out && text_copy_line(line, out, caps[i]) != caps[i] - 1) fail("line copy", text, len, width);
+        free(out);
+    }
+}
+
+#ifdef TEXT_LIBFUZZER
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    check_input(data, size);
+    if (failed) abort();
+    return 0;
+}
+#else
+
+// Textos aleatorios con muchos espacios, '\n' y palabras largas
+static uint32_t rng_state;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static size_t random_text(char* out, size_t cap, bool newlines) {
+    static const char alphabet[] = "  aaaaeeiioonst$.,:0123456789SOLUTION";
+    size_t len = rng() % 4 == 0 ? rng() % 64 : rng() % cap;
+    size_t word = 1 + rng() % 60;
+    for (size_t i = 0; i < len; i++) {
+        char c = alphabet[rng() % (sizeof(alphabet) - 1)];
+        if (c == ' ' && rng() % word) c = 'w';     // Palabras de longitud variable
+        if (newlines && rng() % 40 == 0) c = '\n';
+        out[i] = c;
+    }
+    if (len >= 9 && rng() % 2) memcpy(out, "SOLUTION:", 9);
+    out[len] = '\0';
+    return len;
+}
+
+static void fuzz(uint32_t iterations, uint32_t seed) {
+    static char text[FUZZ_TEXT_MAX + 2];
+    rng_state = seed ? seed : 1;
+
+    for (uint32_t i = 0; i < iterations && !failed; i++) {
+        bool newlines = i % 2;
+        size_t len = random_text(text + 1, FUZZ_TEXT_MAX, newlines);
+        text[0] = (char)(rng() % 256);
+        check_input((const uint8_t*)text, len + 1);
+
+        // Sin '\n' y con anchos que cabían en el buffer anterior: mismas líneas
+        if (!newlines) check_wrap(text + 1, len, 1 + rng() % LEGACY_WIDTH_MAX, true);
+    }
+}
+
+typedef struct {
+    const char* text;
+    size_t width;
+    const char* lines;      // Líneas separadas por '|'
+} WrapCase;
+
+static const WrapCase cases[] = {
+    { "",                                   10, "" },
+    { "short",                              10, "short" },
+    { "exactly ten",                        11, "exactly ten" },
+    { "one two three",                       7, "one two|three" },
+    { "abcdefghij",                          4, "abcd|efgh|ij" },
+    { "word  double",                        5, "word |doubl|e" },
+    { "edge case",                           4, "edge|case" },
+    { " lead",                               3, " le|ad" },
+    { "line\nbreak here",                   20, "line|break here" },
+    { "a\n\nb",                             10, "a||b" },
+    { "Connection test successful!\nRaspberry Pi responding correctly.", 35,
+      "Connection test successful!|Raspberry Pi responding correctly." },
+};
+
+typedef struct {
+    const char* text;
+    const char* fields;     // "etiqueta=valor" separados por '|', "+N" si sobran
+} FieldCase;
+
+static const FieldCase field_cases[] = {
+    { "",                                                       "" },
+    { "Risk: Low. Table CSO2017",                               "" },
+    { "Premium: $45.67/month, Present Value: $8,234.56, Risk: Low",
+      "Premium=$45.67/month|Present Value=$8,234.56" },
+    { "Life Insurance Premium: Age 35, Sum assured $100,000, Term 20 years, Interest 4.00%, Table 2017 CSO. "
+      "Monthly premium $42.17.",
+      "Age=35|Sum assured=$100,000.00|Term=20 years|Interest=4.00%|Table=2017 CSO|Monthly premium=$42.17" },
+    { "Reserve: -$1,234.5; q(x) 0.001234\nRate .5%",             "Reserve=-$1,234.50|q(x)=0.001234|Rate=0.5%" },
+    { "Up $2.345, down $2.344, v 1234567",                      "Up=$2.35|down=$2.34|v=1234567" },
+    { "Value 1,23 ok",                                          "Value=1|=23 ok" },
+    { "Overflow 12345678901234567890, Next 1",                  "Next=1" },
+    { "n 1, 2, 3, 4, 5, 6, 7, 8, 9, 10",                        "n=1|=2|=3|=4|=5|=6|=7|=8|+2" },
+};
+
+static void check_field_cases(void) {
+    for (size_t i = 0; i < sizeof(field_cases) / sizeof(field_cases[0]); i++) {
+        const FieldCase* c = &field_cases[i];
+        StrView response = sv_from_cstr(c->text);
+        SolutionFields fields;
+        solution_parse(response, &fields);
+
+        char joined[256];
+        size_t used = 0;
+        for (int f = 0; f < fields.count && used < sizeof(joined); f++) {
+            char value[SOLUTION_FORMAT_MAX];
+            StrView label = solution_span(response, fields.fields[f].label);
+            solution_format(&fields.fields[f], response, value, sizeof(value));
+            used += (size_t)snprintf(joined + used, sizeof(joined) - used, "%s%.*s=%s", f ? "|" : "",
+                                     (int)label.len, label.ptr, value);
+        }
+        if (fields.dropped && used < sizeof(joined)) {
+            used += (size_t)snprintf(joined + used, sizeof(joined) - used, "|+%u", fields.dropped);
+        }
+        if (used == 0) joined[0] = '\0';
+        if (strcmp(joined, c->fields) != 0) {
+            printf("FAIL: fields of \"%s\" gave \"%s\", expected \"%s\"\n", c->text, joined, c->fields);
+            failed = true;
+        }
+    }
+
+    // Mismo valor con otros decimales; orden con signo y porcentajes
+    StrView response = sv_from_cstr("a $45.67, b 45.670, c 5%, d 5.25%, e -0.5, f -1");
+    SolutionFields fields;
+    solution_parse(response, &fields);
+    const SolutionField* f = fields.fields;
+    if (fields.count != 6 || solution_compare(&f[0], &f[1]) != 0 || solution_compare(&f[2], &f[3]) >= 0 ||
+        solution_compare(&f[4], &f[5]) <= 0 || solution_compare(&f[5], &f[2]) >= 0 ||
+        solution_find(&fields, response, "D") != &f[3] || solution_find(&fields, response, "x") != NULL ||
+        solution_value(&f[3]) != 5.25) {
+        printf("FAIL: field comparison or lookup\n");
+        failed = true;
+    }
+}
+
+static void check_cases(void) {
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const WrapCase* c = &cases[i];
+        char joined[128];
+        size_t used = 0;
+        StrView rest = sv_from_cstr(c->text);
+        while (!sv_empty(rest)) {
+            StrView line = text_wrap_next(&rest, c->width);
+            used += (size_t)snprintf(joined + used, sizeof(joined) - used, "%s%.*s", used ? "|" : "",
+                                     (int)line.len, line.ptr);
+            if (used >= sizeof(joined)) break;
+        }
+        if (used == 0) joined[0] = '\0';
+        if (strcmp(joined, c->lines) != 0) {
+            printf("FAIL: \"%s\" at width %zu gave \"%s\", expected \"%s\"\n", c->text, c->width, joined, c->lines);
+            failed = true;
+        }
+    }
+
+    const char* prefixed[] = { "SOLUTION:ok", "SOLUTION:", "SOLUTION", "solution:x", "" };
+    for (size_t i = 0; i < sizeof(prefixed) / sizeof(prefixed[0]); i++) {
+        check_strip(prefixed[i], strlen(prefixed[i]));
+    }
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Respuestas como las del Pi: una corta, la del benchmark de la app y una
+// de 1 KB (el máximo que cabe en la arena)
+static void benchmark(void) {
+    static char big[1024];
+    static const char* const samples[] = {
+        "SOLUTION:Premium: $45.67/month, Present Value: $8,234.56, Risk: Low",
+        "SOLUTION:Term Life: Age 35, Sum assured 100000, Term 20, Rate 3.00%. Monthly premium $42.17.",
+        big,
+    };
+    static const char* const names[] = { "short", "app", "1k" };
+    size_t pos = (size_t)snprintf(big, sizeof(big), "SOLUTION:");
+    while (pos < sizeof(big) - 1) {
+        big[pos] = (pos % 9 == 0) ? ' ' : (char)('a' + pos % 26);
+        pos++;
+    }
+    big[pos] = '\0';
+
+    static char legacy_lines[64][LEGACY_WIDTH_MAX + 1];
+    printf("%-8s %10s %12s %12s %9s\n", "sample", "bytes", "legacy MB/s", "views MB/s", "speedup");
+    for (size_t s = 0; s < sizeof(samples) / sizeof(samples[0]); s++) {
+        const char* sample = samples[s];
+        size_t len = strlen(sample);
+        volatile size_t sink = 0;
+
+        // Antes: memmove del prefijo y copia de cada línea
+        static char buffer[1024];
+        double start = now_s();
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            memcpy(buffer, sample, len + 1);
+            if (strncmp(buffer, "SOLUTION:", 9) == 0) memmove(buffer, buffer + 9, strlen(buffer) - 8);
+            sink += legacy_wrap(buffer, BENCH_WIDTH, legacy_lines, 64);
+        }
+        double legacy_s = now_s() - start;
+
+        // Ahora: vistas sobre la respuesta recibida
+        start = now_s();
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            StrView rest = sv_make(sample, len);
+            text_strip_solution(&rest);
+            while (!sv_empty(rest)) {
+                sink += text_wrap_next(&rest, BENCH_WIDTH).len;
+            }
+        }
+        double views_s = now_s() - start;
+        (void)sink;
+
+        double mb = (double)len * BENCH_ROUNDS / 1e6;
+        printf("%-8s %10zu %12.1f %12.1f %8.1fx\n", names[s], len, mb / legacy_s, mb / views_s,
+               views_s > 0 ? legacy_s / views_s : 0.0);
+    }
+
+    // Campos: analizar la respuesta frente a copiar los ya analizados (lo
+    // que hace un acierto de la caché) y formatearlos para la pantalla
+    printf("%-8s %10s %7s %10s %9s %10s %10s\n", "sample", "bytes", "fields", "parse_ns", "MB/s", "copy_ns",
+           "format_ns");
+    for (size_t s = 0; s < sizeof(samples) / sizeof(samples[0]); s++) {
+        StrView response = sv_from_cstr(samples[s]);
+        text_strip_solution(&response);
+        static SolutionFields fields, copy;
+        volatile size_t sink = 0;
+
+        double start = now_s();
+        for (int r = 0; r < BENCH_ROUNDS; r++) sink += solution_parse(response, &fields);
+        double parse_s = now_s() - start;
+
+        start = now_s();
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            memcpy(&copy, &fields, sizeof(copy));
+            sink += copy.count;
+        }
+        double copy_s = now_s() - start;
+
+        start = now_s();
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            char value[SOLUTION_FORMAT_MAX];
+            for (int f = 0; f < fields.count; f++) sink += solution_format(&fields.fields[f], response, value, sizeof(value));
+        }
+        double format_s = now_s() - start;
+        (void)sink;
+
+        printf("%-8s %10zu %7u %10.1f %9.1f %10.1f %10.1f\n", names[s], response.len, fields.count,
+               parse_s * 1e9 / BENCH_ROUNDS, (double)response.len * BENCH_ROUNDS / 1e6 / parse_s,
+               copy_s * 1e9 / BENCH_ROUNDS, format_s * 1e9 / BENCH_ROUNDS);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "-f") == 0) {
+        uint32_t iterations = (uint32_t)strtoul(argv[2], NULL, 10);
+        uint32_t seed = argc >= 4 ? (uint32_t)strtoul(argv[3], NULL, 10) : 12345;
+        fuzz(iterations, seed);
+        printf("fuzz: %lu inputs, seed %lu: %s\n", (unsigned long)iterations, (unsigned long)seed,
+               failed ? "FAIL" : "ok");
+        return failed ? 1 : 0;
+    }
+
+    check_cases();
+    check_field_cases();
+    fuzz(20000, 12345);
+    printf("layout: %zu edge cases, %zu field cases and 20000 random inputs %s\n", sizeof(cases) / sizeof(cases[0]),
+           sizeof(field_cases) / sizeof(field_cases[0]), failed ? "FAILED" : "ok");
+    benchmark();
+    return failed ? 1 : 0;
+}
+#endif
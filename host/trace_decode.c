@@ -0,0 +1,265 @@
+// Decodificador de la traza binaria de la app (actuarial_ai_upsilon/trace.h).
+//
+//   trace_decode [-s] fichero.trace
+//
+// Sin opciones imprime la línea de tiempo completa y el resumen; con -s
+// sólo el resumen: latencia petición→respuesta, duración de cada etapa del
+// perfilador, tiempo en cada estado y recuento de errores y timeouts.
+// Sale con código 1 si el fichero no es una traza válida.
+//
+// El fichero se escribe en el orden de bytes del Cortex-M7 (little-endian),
+// el mismo que el del host.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+// Mismo orden que AppState en actuarial_ai_complete.c
+static const char* state_names[] = {
+    "init", "menu", "processing", "result", "error", "test", "diag", "edit", "history", "schedule"
+};
+#define STATE_COUNT ((int)(sizeof(state_names) / sizeof(state_names[0])))
+
+// Mismo orden que ProfStage en profiler.h
+static const char* stage_names[] = {
+    "encode", "send", "wait", "receive", "parse",
+    "menu", "edit", "result", "error", "diag", "history", "schedule", "present"
+};
+#define STAGE_COUNT ((int)(sizeof(stage_names) / sizeof(stage_names[0])))
+
+static const char* link_names[] = { "unknown", "up", "degraded", "down" };
+static const char* uart_error_names[] = { "overrun", "framing", "noise", "parity", "tx-timeout", "recovery" };
+static const char* timeout_names[] = { "response", "link-down" };
+
+#define NAME(table, i) ((i) < sizeof(table) / sizeof(table[0]) ? table[i] : "?")
+
+typedef struct {
+    uint32_t count;
+    uint64_t total;
+    uint32_t min;
+    uint32_t max;
+} Span;
+
+static void span_add(Span* s, uint32_t value) {
+    if (s->count == 0 || value < s->min) s->min = value;
+    if (value > s->max) s->max = value;
+    s->total += value;
+    s->count++;
+}
+
+static void print_span(const char* name, const char* unit, const Span* s) {
+    if (!s->count) {
+        printf("  %-12s %5s\n", name, "-");
+        return;
+    }
+    printf("  %-12s %5lu  min %8lu  avg %10.1f  max %8lu %s\n", name, (unsigned long)s->count,
+           (unsigned long)s->min, (double)s->total / s->count, (unsigned long)s->max, unit);
+}
+
+static void print_char(uint8_t c) {
+    if (c >= 0x20 && c < 0x7F) printf("'%c'", c);
+    else printf("0x%02x", c);
+}
+
+static void print_event(const TraceEvent* e) {
+    printf("%10lu  ", (unsigned long)e->time_ms);
+    switch (e->type) {
+        case TRACE_BOOT:
+            printf("boot        ring %lu events\n", (unsigned long)e->value);
+            break;
+        case TRACE_STATE:
+            printf("state       %s -> %s\n", NAME(state_names, e->a), NAME(state_names, e->b));
+            break;
+        case TRACE_REQUEST:
+            printf("request     product %u%s\n", e->a, e->b ? " (cached)" : "");
+            break;
+        case TRACE_UART_TX:
+        case TRACE_UART_RX:
+            printf("%s     %u bytes, first ", e->type == TRACE_UART_TX ? "uart-tx" : "uart-rx", e->b);
+            print_char(e->a);
+            if (e->value) printf(" (queue #%lu)", (unsigned long)e->value);
+            printf("\n");
+            break;
+        case TRACE_UART_ERROR:
+            printf("uart-error  %s +%u (total %lu)\n", NAME(uart_error_names, e->a), e->b,
+                   (unsigned long)e->value);
+            break;
+        case TRACE_TIMEOUT:
+            printf("timeout     %s after %lu ms\n", NAME(timeout_names, e->a), (unsigned long)e->value);
+            break;
+        case TRACE_RESPONSE:
+            printf("response    %s, %u bytes", e->a ? "solution" : "other", e->b);
+            if (e->value) printf(" (queue #%lu)", (unsigned long)e->value);
+            printf("\n");
+            break;
+        case TRACE_LINK:
+            printf("link        %s -> %s (rtt %lu ms)\n", NAME(link_names, e->a), NAME(link_names, e->b),
+                   (unsigned long)e->value);
+            break;
+        case TRACE_STAGE:
+            printf("stage       %-8s %lu us\n", NAME(stage_names, e->a), (unsigned long)e->value);
+            break;
+        case TRACE_FLUSH:
+            printf("flush       %lu events overwritten so far\n", (unsigned long)e->value);
+            break;
+    }
+}
+
+static void summarize(const TraceFileHeader* header, const TraceEvent* events) {
+    Span latency = { 0 };
+    Span stages[STAGE_COUNT];
+    uint64_t state_ms[STATE_COUNT];
+    uint32_t uart_errors[TRACE_ERR_RECOVERY + 1];
+    uint32_t timeouts[TRACE_TIMEOUT_LINK + 1];
+    uint32_t requests = 0, cached = 0, responses = 0, link_changes = 0;
+    memset(stages, 0, sizeof(stages));
+    memset(state_ms, 0, sizeof(state_ms));
+    memset(uart_errors, 0, sizeof(uart_errors));
+    memset(timeouts, 0, sizeof(timeouts));
+
+    // El estado antes del primer cambio es desconocido si el anillo dio la
+    // vuelta; sin vuelta la traza empieza en el arranque (STATE_INIT)
+    int state = header->dropped ? -1 : 0;
+    uint32_t state_since = header->count ? events[0].time_ms : 0;
+    bool pending = false;
+    uint32_t request_ms = 0;
+
+    for (uint32_t i = 0; i < header->count; i++) {
+        const TraceEvent* e = &events[i];
+        switch (e->type) {
+            case TRACE_STATE:
+                if (state >= 0) state_ms[state] += e->time_ms - state_since;
+                state = e->b < STATE_COUNT ? e->b : -1;
+                state_since = e->time_ms;
+                break;
+            case TRACE_REQUEST:
+                requests++;
+                if (e->b) {
+                    cached++;
+                } else {
+                    pending = true;
+                    request_ms = e->time_ms;
+                }
+                break;
+            case TRACE_RESPONSE:
+                responses++;
+                // Fallthrough deliberado: ambos cierran la petición
+            case TRACE_TIMEOUT:
+                if (e->type == TRACE_TIMEOUT && e->a <= TRACE_TIMEOUT_LINK) timeouts[e->a]++;
+                if (pending) span_add(&latency, e->time_ms - request_ms);
+                pending = false;
+                break;
+            case TRACE_UART_ERROR:
+                if (e->a <= TRACE_ERR_RECOVERY) uart_errors[e->a] += e->b;
+                break;
+            case TRACE_LINK:
+                link_changes++;
+                break;
+            case TRACE_STAGE:
+                if (e->a < STAGE_COUNT) span_add(&stages[e->a], e->value);
+                break;
+            default:
+                break;
+        }
+    }
+    if (state >= 0) state_ms[state] += header->flushed_ms - state_since;
+
+    uint32_t first = header->count ? events[0].time_ms : 0;
+    printf("trace: %u events over %lu ms, %lu overwritten before the flush\n", header->count,
+           (unsigned long)(header->flushed_ms - first), (unsigned long)header->dropped);
+    printf("requests: %lu (%lu from the cache), %lu responses%s\n", (unsigned long)requests,
+           (unsigned long)cached, (unsigned long)responses, pending ? ", last one unanswered" : "");
+    print_span("latency", "ms", &latency);
+
+    printf("stages (us):\n");
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        if (stages[i].count) print_span(stage_names[i], "us", &stages[i]);
+    }
+
+    printf("time per state (ms):\n");
+    for (int i = 0; i < STATE_COUNT; i++) {
+        if (state_ms[i]) printf("  %-12s %8llu\n", state_names[i], (unsigned long long)state_ms[i]);
+    }
+
+    printf("errors:");
+    for (int i = 0; i <= TRACE_ERR_RECOVERY; i++) printf(" %s %lu", uart_error_names[i], (unsigned long)uart_errors[i]);
+    printf("\ntimeouts:");
+    for (int i = 0; i <= TRACE_TIMEOUT_LINK; i++) printf(" %s %lu", timeout_names[i], (unsigned long)timeouts[i]);
+    printf("\nlink changes: %lu\n", (unsigned long)link_changes);
+}
+
+static char* read_file(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    char* data = NULL;
+    size_t used = 0, cap = 0;
+    for (;;) {
+        if (used == cap) {
+            cap = cap ? cap * 2 : 4096;
+            char* grown = realloc(data, cap);
+            if (!grown) break;
+            data = grown;
+        }
+        size_t n = fread(data + used, 1, cap - used, f);
+        if (n == 0) break;
+        used += n;
+    }
+    fclose(f);
+    *size = used;
+    return data;
+}
+
+int main(int argc, char** argv) {
+    bool summary_only = argc == 3 && strcmp(argv[1], "-s") == 0;
+    if (argc != 2 && !summary_only) {
+        fprintf(stderr, "usage: %s [-s] file.trace\n", argv[0]);
+        return 2;
+    }
+    const char* path = argv[argc - 1];
+
+    size_t size;
+    char* data = read_file(path, &size);
+    if (!data) {
+        printf("FAIL: cannot read %s\n", path);
+        return 1;
+    }
+
+    TraceFileHeader header;
+    if (size < sizeof(header)) {
+        printf("FAIL: %s: %zu bytes, shorter than the header\n", path, size);
+        free(data);
+        return 1;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != TRACE_MAGIC || header.version != TRACE_VERSION) {
+        printf("FAIL: %s: not a trace (magic %08lx, version %u)\n", path, (unsigned long)header.magic,
+               header.version);
+        free(data);
+        return 1;
+    }
+    if (header.count > TRACE_CAPACITY || size != sizeof(header) + header.count * sizeof(TraceEvent)) {
+        printf("FAIL: %s: %u events do not match %zu bytes\n", path, header.count, size);
+        free(data);
+        return 1;
+    }
+
+    TraceEvent* events = malloc(header.count * sizeof(TraceEvent) + 1);
+    memcpy(events, data + sizeof(header), header.count * sizeof(TraceEvent));
+    free(data);
+    for (uint32_t i = 0; i < header.count; i++) {
+        if (events[i].type >= TRACE_EVENT_COUNT || (i && events[i].time_ms < events[i - 1].time_ms)) {
+            printf("FAIL: %s: event %lu is corrupt\n", path, (unsigned long)i);
+            free(events);
+            return 1;
+        }
+    }
+
+    if (!summary_only) {
+        for (uint32_t i = 0; i < header.count; i++) print_event(&events[i]);
+        printf("\n");
+    }
+    summarize(&header, events);
+    free(events);
+    return 0;
+}
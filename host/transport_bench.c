@@ -0,0 +1,123 @@
+// Goodput del transporte fiable frente a un enlace con errores de byte.
+// Simula el intercambio típico de la app: petición de ~100 bytes de la
+// calculadora y respuesta de 1 KB del Pi, a 115200 baudios.
+
+#include <stdio.h>
+#include <string.h>
+#include "lossy_link.h"
+#include "uart_transport.h"
+
+#define BAUDRATE        115200
+#define EXCHANGES       64
+#define REQUEST_SIZE    96
+#define RESPONSE_SIZE   1024
+#define EXCHANGE_LIMIT_MS 30000
+
+typedef struct {
+    double error_rate;
+    int completed;
+    int failed;
+    double seconds;
+    double goodput;
+    TransportStats calc;
+    TransportStats pi;
+    uint64_t corrupted;
+} BenchResult;
+
+static void run(double error_rate, BenchResult* r) {
+    static LossyLink link;
+    static uint8_t request[REQUEST_SIZE], response[RESPONSE_SIZE];
+    static uint8_t calc_rx[RESPONSE_SIZE], pi_rx[REQUEST_SIZE];
+    Transport calc, pi;
+
+    for (int i = 0; i < REQUEST_SIZE; i++) request[i] = (uint8_t)('A' + i % 26);
+    for (int i = 0; i < RESPONSE_SIZE; i++) response[i] = (uint8_t)(i * 7);  // Incluye 0x7E/0x7D
+
+    lossy_link_init(&link, BAUDRATE, error_rate, 12345);
+    transport_init(&calc, &link.a.transport);
+    transport_init(&pi, &link.b.transport);
+
+    memset(r, 0, sizeof(*r));
+    r->error_rate = error_rate;
+
+    for (int n = 0; n < EXCHANGES; n++) {
+        uint32_t start = lossy_link_millis(&link);
+        bool responded = false;
+
+        transport_set_rx_buffer(&calc, calc_rx, sizeof(calc_rx));
+        transport_set_rx_buffer(&pi, pi_rx, sizeof(pi_rx));
+        transport_send(&calc, request, sizeof(request));
+
+        while (!transport_rx_complete(&calc)) {
+            if (lossy_link_millis(&link) - start > EXCHANGE_LIMIT_MS ||
+                transport_failed(&calc) || transport_failed(&pi)) break;
+
+            lossy_link_step(&link);
+            transport_poll(&calc);
+            transport_poll(&pi);
+
+            if (!responded && transport_rx_complete(&pi)) {
+                responded = true;
+                transport_send(&pi, response, sizeof(response));
+            }
+        }
+
+        if (transport_rx_complete(&calc) && transport_rx_length(&calc) == RESPONSE_SIZE &&
+            memcmp(calc_rx, response, RESPONSE_SIZE) == 0 &&
+            memcmp(pi_rx, request, REQUEST_SIZE) == 0) {
+            r->completed++;
+        } else {
+            r->failed++;
+            // Sesión nueva para el siguiente intercambio
+            transport_init(&calc, &link.a.transport);
+            transport_init(&pi, &link.b.transport);
+        }
+
+        // Dejar que lleguen los últimos ACK antes de la siguiente petición
+        for (int i = 0; i < 200; i++) {
+            lossy_link_step(&link);
+            transport_poll(&calc);
+            transport_poll(&pi);
+        }
+    }
+
+    r->seconds = link.now_us / 1e6;
+    r->goodput = r->completed * (double)(REQUEST_SIZE + RESPONSE_SIZE) / r->seconds;
+    r->calc = calc.stats;
+    r->pi = pi.stats;
+    r->corrupted = link.bytes_corrupted;
+}
+
+// Probabilidad de que una línea PROBLEM/SOLUTION de texto llegue intacta
+static double plain_line_success(double error_rate) {
+    double ok = 1.0;
+    for (int i = 0; i < REQUEST_SIZE + RESPONSE_SIZE + 20; i++) ok *= 1.0 - error_rate;
+    return ok;
+}
+
+int main(void) {
+    static const double rates[] = { 0.0, 0.001, 0.0025, 0.005, 0.01 };
+    const double line_rate = BAUDRATE / 10.0;
+    bool all_completed = true;
+
+    printf("transport: window=%d payload=%d rto=%dms, %d exchanges of %d+%d bytes\n",
+           TRANSPORT_WINDOW, TRANSPORT_MAX_PAYLOAD, TRANSPORT_RTO_MS,
+           EXCHANGES, REQUEST_SIZE, RESPONSE_SIZE);
+    printf("%-8s %5s %5s %9s %10s %7s %7s %6s %6s %9s\n",
+           "err", "ok", "fail", "time[s]", "goodput", "eff", "retx", "nack", "crc", "plain-ok");
+
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        BenchResult r;
+        run(rates[i], &r);
+        all_completed &= r.failed == 0;
+        printf("%-8.4f %5d %5d %9.2f %8.0fB/s %6.1f%% %7lu %6lu %6lu %8.1f%%\n",
+               r.error_rate, r.completed, r.failed, r.seconds, r.goodput,
+               100.0 * r.goodput / line_rate,
+               (unsigned long)(r.calc.retransmissions + r.pi.retransmissions),
+               (unsigned long)(r.calc.nacks_sent + r.pi.nacks_sent),
+               (unsigned long)(r.calc.crc_errors + r.pi.crc_errors),
+               100.0 * plain_line_success(r.error_rate));
+    }
+
+    return all_completed ? 0 : 1;
+}
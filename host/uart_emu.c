@@ -0,0 +1,273 @@
+// Emulación de registros UART1 (STM32F730) para el host
+
+#include <string.h>
+#include "uart_emu.h"
+
+#define UART1_BASE  0x40011000u
+#define REG_CR1     (UART1_BASE + 0x00)
+#define REG_ISR     (UART1_BASE + 0x1C)
+#define REG_ICR     (UART1_BASE + 0x20)
+#define REG_RDR     (UART1_BASE + 0x24)
+#define REG_TDR     (UART1_BASE + 0x28)
+#define REG_CR3     (UART1_BASE + 0x08)
+
+#define DMA2_BASE   0x40026400u
+#define REG_HISR    (DMA2_BASE + 0x04)
+#define REG_HIFCR   (DMA2_BASE + 0x0C)
+#define REG_S5CR    (DMA2_BASE + 0x10 + 0x18 * 5)
+#define REG_S5NDTR  (REG_S5CR + 0x04)
+
+#define CR1_UE      (1u << 0)
+#define CR1_RE      (1u << 2)
+#define CR3_DMAR    (1u << 6)
+#define CR3_DDRE    (1u << 13)
+#define HISR_HTIF5  (1u << 10)
+#define HISR_TCIF5  (1u << 11)
+#define DMA_EN      (1u << 0)
+#define ISR_RXNE    (1u << 5)
+#define ISR_TC      (1u << 6)
+#define ISR_TXE     (1u << 7)
+#define ISR_ERRORS  (UART_EMU_PE | UART_EMU_FE | UART_EMU_NF | UART_EMU_ORE)
+#define ISR_DATA_ERRORS (UART_EMU_PE | UART_EMU_FE | UART_EMU_NF)
+
+#define RX_CAPACITY 8192
+#define TX_CAPACITY 8192
+#define REG_SLOTS   32
+
+typedef struct {
+    uint32_t addr;
+    uint32_t value;
+} RegSlot;
+
+static RegSlot regs[REG_SLOTS];
+static int reg_count;
+
+static uint8_t rx_queue[RX_CAPACITY];
+static size_t rx_head, rx_tail;
+static uint8_t tx_capture[TX_CAPACITY];
+static size_t tx_len;
+
+static uint32_t isr_errors;       // Flags activos en ISR
+static uint32_t pending_error;    // Error que acompañará al próximo byte
+static bool rdr_full;
+static uint8_t rdr;
+static uint32_t tx_stall;
+static uint32_t disable_count;
+static UartEmuTxHook tx_hook;
+static void* tx_hook_ctx;
+static uint8_t* dma_buffer;
+static uint32_t dma_size;
+
+static uint32_t* reg_slot(uint32_t addr) {
+    for (int i = 0; i < reg_count; i++) {
+        if (regs[i].addr == addr) return &regs[i].value;
+    }
+    if (reg_count == REG_SLOTS) return NULL;
+    regs[reg_count].addr = addr;
+    regs[reg_count].value = 0;
+    return &regs[reg_count++].value;
+}
+
+static bool receiver_enabled(void) {
+    uint32_t* cr1 = reg_slot(REG_CR1);
+    return cr1 && (*cr1 & (CR1_UE | CR1_RE)) == (CR1_UE | CR1_RE);
+}
+
+// Saca el siguiente byte del cable aplicando el error pendiente; en `error`
+// los flags que trae el propio byte (FE/PE/NF)
+static bool take_rx_byte(uint8_t* byte, uint32_t* error) {
+    if (rx_head == rx_tail || !receiver_enabled()) return false;
+    // Con ORE sin limpiar el receptor no acepta nada más
+    if (isr_errors & UART_EMU_ORE) return false;
+
+    *byte = rx_queue[rx_head];
+    rx_head = (rx_head + 1) % RX_CAPACITY;
+    *error = pending_error & ISR_DATA_ERRORS;
+
+    if (pending_error) {
+        isr_errors |= pending_error;
+        if ((pending_error & UART_EMU_ORE) && rx_head != rx_tail) {
+            // El byte que llegó con RDR lleno se pierde
+            rx_head = (rx_head + 1) % RX_CAPACITY;
+        }
+        pending_error = 0;
+    }
+    return true;
+}
+
+static bool dma_enabled(void) {
+    uint32_t* cr3 = reg_slot(REG_CR3);
+    uint32_t* s5cr = reg_slot(REG_S5CR);
+    return dma_buffer && cr3 && s5cr && (*cr3 & CR3_DMAR) && (*s5cr & DMA_EN);
+}
+
+static bool ddre_enabled(void) {
+    uint32_t* cr3 = reg_slot(REG_CR3);
+    return cr3 && (*cr3 & CR3_DDRE);
+}
+
+static void dma_store(uint32_t* ndtr, uint8_t byte) {
+    if (*ndtr == 0 || *ndtr > dma_size) *ndtr = dma_size;
+    dma_buffer[dma_size - *ndtr] = byte;
+    uint32_t* hisr = reg_slot(REG_HISR);
+    if (--*ndtr == dma_size / 2 && hisr) *hisr |= HISR_HTIF5;
+    if (*ndtr == 0) {
+        *ndtr = dma_size;
+        if (hisr) *hisr |= HISR_TCIF5;
+    }
+}
+
+// El DMA circular vacía el receptor en cuanto hay datos. Con DDRE, un byte
+// con FE/PE/NF se queda en RDR y el DMA espera a que se limpie el flag.
+static void service_dma(void) {
+    if (!dma_enabled()) return;
+
+    uint32_t* ndtr = reg_slot(REG_S5NDTR);
+    if (!ndtr) return;
+    if (ddre_enabled() && (isr_errors & ISR_DATA_ERRORS)) return;
+    if (rdr_full) {
+        dma_store(ndtr, rdr);
+        rdr_full = false;
+    }
+
+    uint8_t byte;
+    uint32_t error;
+    while (take_rx_byte(&byte, &error)) {
+        if (error && ddre_enabled()) {
+            rdr = byte;
+            rdr_full = true;
+            return;
+        }
+        dma_store(ndtr, byte);
+    }
+}
+
+// Mueve el siguiente byte de la cola a RDR cuando no hay DMA
+static void load_rdr(void) {
+    uint32_t error;
+    if (rdr_full || dma_enabled()) return;
+    if (take_rx_byte(&rdr, &error)) rdr_full = true;
+}
+
+void uart_emu_reset(void) {
+    memset(regs, 0, sizeof(regs));
+    reg_count = 0;
+    rx_head = rx_tail = 0;
+    tx_len = 0;
+    isr_errors = 0;
+    pending_error = 0;
+    rdr_full = false;
+    tx_stall = 0;
+    disable_count = 0;
+    tx_hook = NULL;
+    tx_hook_ctx = NULL;
+    dma_buffer = NULL;
+    dma_size = 0;
+}
+
+void uart_emu_attach_dma(uint8_t* buffer, uint32_t size) {
+    dma_buffer = buffer;
+    dma_size = size;
+}
+
+void uart_emu_push_rx(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        size_t next = (rx_tail + 1) % RX_CAPACITY;
+        if (next == rx_head) return;  // Cola llena: se descarta el resto
+        rx_queue[rx_tail] = data[i];
+        rx_tail = next;
+    }
+}
+
+void uart_emu_push_rx_string(const char* str) {
+    uart_emu_push_rx((const uint8_t*)str, strlen(str));
+}
+
+size_t uart_emu_rx_pending(void) {
+    return (rx_tail + RX_CAPACITY - rx_head) % RX_CAPACITY + (rdr_full ? 1 : 0);
+}
+
+void uart_emu_inject_error(uint32_t flags) {
+    pending_error |= flags & ISR_ERRORS;
+}
+
+void uart_emu_stall_tx(uint32_t count) {
+    tx_stall = count;
+}
+
+size_t uart_emu_take_tx(uint8_t* out, size_t max) {
+    size_t n = tx_len < max ? tx_len : max;
+    memcpy(out, tx_capture, n);
+    memmove(tx_capture, tx_capture + n, tx_len - n);
+    tx_len -= n;
+    return n;
+}
+
+void uart_emu_set_tx_hook(UartEmuTxHook hook, void* ctx) {
+    tx_hook = hook;
+    tx_hook_ctx = ctx;
+}
+
+uint32_t uart_emu_disable_count(void) {
+    return disable_count;
+}
+
+uint32_t uart_emu_read(uint32_t addr) {
+    switch (addr) {
+        case REG_ISR: {
+            service_dma();
+            load_rdr();
+            uint32_t isr = isr_errors;
+            if (rdr_full) isr |= ISR_RXNE;
+            if (tx_stall > 0) {
+                tx_stall--;
+            } else {
+                isr |= ISR_TXE | ISR_TC;
+            }
+            return isr;
+        }
+        case REG_RDR:
+            load_rdr();
+            rdr_full = false;
+            return rdr;
+        case REG_S5NDTR:
+            service_dma();
+            /* fallthrough */
+        default: {
+            uint32_t* slot = reg_slot(addr);
+            return slot ? *slot : 0;
+        }
+    }
+}
+
+void uart_emu_write(uint32_t addr, uint32_t value) {
+    switch (addr) {
+        case REG_ICR:
+            isr_errors &= ~(value & ISR_ERRORS);
+            break;
+        case REG_HIFCR: {
+            uint32_t* hisr = reg_slot(REG_HISR);
+            if (hisr) *hisr &= ~value;
+            break;
+        }
+        case REG_TDR:
+            if (tx_len < TX_CAPACITY) tx_capture[tx_len++] = (uint8_t)value;
+            if (tx_hook) tx_hook((uint8_t)value, tx_hook_ctx);
+            break;
+        case REG_CR1: {
+            uint32_t* cr1 = reg_slot(REG_CR1);
+            if (!cr1) break;
+            if ((*cr1 & CR1_UE) && !(value & CR1_UE)) {
+                disable_count++;
+                rdr_full = false;
+            }
+            *cr1 = value;
+            break;
+        }
+        default: {
+            uint32_t* slot = reg_slot(addr);
+            if (slot) *slot = value;
+            break;
+        }
+    }
+}
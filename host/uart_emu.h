@@ -0,0 +1,47 @@
+// Bloque de registros UART1/RCC/GPIOA emulado para compilar uart_hardware.c
+// en el host (-DUART_HW_EMULATED). Permite alimentar bytes de recepción,
+// capturar lo transmitido e inyectar cada tipo de error del periférico.
+
+#ifndef UART_EMU_H
+#define UART_EMU_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Flags de ISR que se pueden inyectar (mismas posiciones que en el STM32F7)
+#define UART_EMU_PE   (1u << 0)
+#define UART_EMU_FE   (1u << 1)
+#define UART_EMU_NF   (1u << 2)
+#define UART_EMU_ORE  (1u << 3)
+
+// Llamado con cada byte escrito en TDR (p. ej. para simular al Pi)
+typedef void (*UartEmuTxHook)(uint8_t byte, void* ctx);
+
+void uart_emu_reset(void);
+void uart_emu_push_rx(const uint8_t* data, size_t len);
+void uart_emu_push_rx_string(const char* str);
+size_t uart_emu_rx_pending(void);
+
+// El error se asocia al siguiente byte que llegue a RDR. En un overrun el
+// byte siguiente se pierde y no se recibe nada más hasta limpiar ORE.
+void uart_emu_inject_error(uint32_t flags);
+
+// Hace que los próximos `count` sondeos de TXE/TC fallen
+void uart_emu_stall_tx(uint32_t count);
+
+size_t uart_emu_take_tx(uint8_t* out, size_t max);
+void uart_emu_set_tx_hook(UartEmuTxHook hook, void* ctx);
+
+// Memoria destino del DMA de recepción (DMA2 Stream 5). En el host los
+// punteros no caben en S5M0AR, así que el driver la registra aparte.
+void uart_emu_attach_dma(uint8_t* buffer, uint32_t size);
+
+// Número de veces que se deshabilitó UE (reinicios del periférico)
+uint32_t uart_emu_disable_count(void);
+
+// Accesos a registros usados por uart_hardware.c
+uint32_t uart_emu_read(uint32_t addr);
+void uart_emu_write(uint32_t addr, uint32_t value);
+
+#endif
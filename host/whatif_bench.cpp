@@ -0,0 +1,123 @@
+// Benchmark del recálculo incremental (engine/model.h): coste de cambiar
+// un solo supuesto frente a rehacer la valoración completa.
+//
+// Cada escenario alterna un supuesto entre dos valores y pide los
+// resultados (prima y vector de reservas) en cada vuelta. Se cuentan las
+// etapas que se rehicieron por vuelta. Sale con código 1 si un resultado
+// incremental no coincide con la valoración completa de los mismos
+// supuestos o con las plantillas de valuation.h.
+
+#include <cmath>
+#include <cstdio>
+#include "engine/model.h"
+#include "bench_util.h"
+
+using namespace actuarial;
+
+typedef ValuationModel<Monthly, Due> Model;
+
+static Model model;
+static Model reference;
+
+struct Assumptions {
+    int age;
+    int years;
+    double rate;
+    double sum_assured;
+};
+
+static void apply(Model& m, const Assumptions& a) {
+    m.set_age(a.age);
+    m.set_years(a.years);
+    m.set_rate(a.rate);
+    m.set_sum_assured(a.sum_assured);
+}
+
+// El resultado incremental debe ser el de una valoración desde cero
+static bool matches_full(const ModelResults& r, const Assumptions& a) {
+    apply(reference, a);
+    reference.invalidate();
+    const ModelResults& full = reference.results();
+    if (!same(r.premium, full.premium) || r.years != full.years) return false;
+    for (int t = 0; t <= r.years; t++) {
+        if (!same(r.reserve[t], full.reserve[t])) return false;
+    }
+    return true;
+}
+
+static double full_ns;
+
+static bool scenario(const char* name, const Assumptions& a, const Assumptions& b) {
+    apply(model, a);
+    model.invalidate();
+    model.results();
+
+    ModelStageCounts before = model.stage_counts();
+    double start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        apply(model, (i & 1) ? a : b);
+        sink = model.results().premium;
+    }
+    double ns = (now_ns() - start) / ITERATIONS;
+    const ModelStageCounts& after = model.stage_counts();
+
+    printf("%-14s %10.0f %8.2fx %6.2f %6.2f %6.2f %6.2f\n", name, ns, full_ns / ns,
+           (double)(after.survival - before.survival) / ITERATIONS,
+           (double)(after.discount - before.discount) / ITERATIONS,
+           (double)(after.commutation - before.commutation) / ITERATIONS,
+           (double)(after.results - before.results) / ITERATIONS);
+
+    // Las dos direcciones del cambio
+    apply(model, b);
+    bool ok = matches_full(model.results(), b);
+    apply(model, a);
+    ok = matches_full(model.results(), a) && ok;
+    if (!ok) printf("FAIL: %s incremental result differs from a full valuation\n", name);
+    return ok;
+}
+
+int main() {
+    const Assumptions base = { 35, 20, 0.05, 100000.0 };
+    bool pass = true;
+
+    // Valoración completa: todas las etapas en cada vuelta
+    apply(model, base);
+    double start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        model.invalidate();
+        sink = model.results().premium;
+    }
+    full_ns = (now_ns() - start) / ITERATIONS;
+
+    const ModelResults& r = model.results();
+    printf("monthly premiums, age %d, %d-year term, i = %.0f%%, sum assured %.0f: premium %.2f/year\n",
+           base.age, base.years, base.rate * 100, base.sum_assured, r.premium);
+
+    // Contraste con las plantillas de valuation.h sobre los mismos vectores
+    Basis b = model.basis();
+    double premium = term_premium<Monthly, Due>(b) * base.sum_assured;
+    double reserve = term_reserve<Monthly, Due>(b, premium / base.sum_assured, 10) * base.sum_assured;
+    if (!same(r.premium, premium) || !same(r.reserve[10], reserve)) {
+        printf("FAIL: model and valuation templates disagree (%.6f/%.6f, %.6f/%.6f)\n",
+               r.premium, premium, r.reserve[10], reserve);
+        pass = false;
+    }
+
+    printf("%-14s %10s %9s %6s %6s %6s %6s\n", "what-if", "ns", "vs full", "surv", "disc", "comm", "result");
+    printf("%-14s %10.0f %8.2fx %6.2f %6.2f %6.2f %6.2f\n", "full", full_ns, 1.0, 1.0, 1.0, 1.0, 1.0);
+
+    Assumptions rate = base;
+    rate.rate = 0.04;
+    Assumptions age = base;
+    age.age = 36;
+    Assumptions term = base;
+    term.years = 25;
+    Assumptions sum = base;
+    sum.sum_assured = 150000.0;
+
+    pass = scenario("interest 4%", base, rate) && pass;
+    pass = scenario("age 36", base, age) && pass;
+    pass = scenario("term 25", base, term) && pass;
+    pass = scenario("sum 150000", base, sum) && pass;
+    return pass ? 0 : 1;
+}